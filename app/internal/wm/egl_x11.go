@@ -4,18 +4,39 @@
 
 package wm
 
+/*
+#include <X11/Xlib.h>
+*/
+import "C"
 import (
+	"errors"
 	"unsafe"
 
+	"gioui.org/gpu"
 	"gioui.org/internal/egl"
 )
 
 type x11Context struct {
 	win *x11Window
 	*egl.Context
+	// share is the share group of the context, or nil.
+	share *Share
+}
+
+// x11Share is the EGL context shared by the X11 windows of a share group.
+// It has its own connection to the X server, because every window closes
+// its connection when destroyed. Window IDs are valid for every
+// connection.
+type x11Share struct {
+	egl  egl.Share
+	disp *C.Display
+	refs int
 }
 
 func (w *x11Window) NewContext() (Context, error) {
+	if s := w.share; s != nil {
+		return w.newSharedContext(s)
+	}
 	disp := egl.NativeDisplayType(unsafe.Pointer(w.display()))
 	ctx, err := egl.NewContext(disp)
 	if err != nil {
@@ -24,11 +45,47 @@ func (w *x11Window) NewContext() (Context, error) {
 	return &x11Context{win: w, Context: ctx}, nil
 }
 
+func (w *x11Window) newSharedContext(s *Share) (Context, error) {
+	s.mu.Lock()
+	defer s.mu.Unlock()
+	xs, ok := s.ctx.(*x11Share)
+	if !ok {
+		dpy := C.XOpenDisplay(nil)
+		if dpy == nil {
+			return nil, errors.New("x11: cannot connect to the X server")
+		}
+		xs = &x11Share{disp: dpy}
+	}
+	ctx, err := egl.NewSharedContext(egl.NativeDisplayType(unsafe.Pointer(xs.disp)), &xs.egl)
+	if err != nil {
+		if xs.refs == 0 {
+			C.XCloseDisplay(xs.disp)
+		}
+		return nil, err
+	}
+	xs.refs++
+	s.ctx = xs
+	// Make sure the window exists for the connection of the share.
+	C.XSync(w.x, C.False)
+	return &x11Context{win: w, Context: ctx, share: s}, nil
+}
+
 func (c *x11Context) Release() {
 	if c.Context != nil {
 		c.Context.Release()
 		c.Context = nil
 	}
+	if s := c.share; s != nil {
+		c.share = nil
+		s.mu.Lock()
+		xs := s.ctx.(*x11Share)
+		xs.refs--
+		if xs.refs == 0 {
+			C.XCloseDisplay(xs.disp)
+			s.ctx = nil
+		}
+		s.mu.Unlock()
+	}
 }
 
 func (c *x11Context) Refresh() error {
@@ -49,6 +106,18 @@ func (c *x11Context) MakeCurrent() error {
 	return nil
 }
 
-func (c *x11Context) Lock() {}
+// SharedGPU returns the GPU resources of the share group of c, or nil.
+func (c *x11Context) SharedGPU() *gpu.Shared {
+	if c.share == nil {
+		return nil
+	}
+	return &c.share.GPU
+}
 
-func (c *x11Context) Unlock() {}
+func (c *x11Context) Lock() {
+	c.Context.Lock()
+}
+
+func (c *x11Context) Unlock() {
+	c.Context.Unlock()
+}
@@ -178,6 +178,11 @@ type window struct {
 	stage             system.Stage
 	dead              bool
 	lastFrameCallback *C.struct_wl_callback
+	pacer             framePacer
+	// drawAt is the time of a frame delayed by the pacer, and
+	// frameDelay its delay.
+	drawAt     time.Time
+	frameDelay time.Duration
 
 	animating bool
 	needAck   bool
@@ -1121,6 +1126,12 @@ func gio_onFrameDone(data unsafe.Pointer, callback *C.struct_wl_callback, t C.ui
 	w := callbackLoad(data).(*window)
 	if w.lastFrameCallback == callback {
 		w.lastFrameCallback = nil
+		// Start the frame just in time for the next refresh.
+		if d := w.pacer.refresh(uint32(t)); d > 0 {
+			w.drawAt = time.Now().Add(d)
+			w.frameDelay = d
+			return
+		}
 		w.draw(false)
 	}
 }
@@ -1128,7 +1139,15 @@ func gio_onFrameDone(data unsafe.Pointer, callback *C.struct_wl_callback, t C.ui
 func (w *window) loop() error {
 	var p poller
 	for {
-		if err := w.disp.dispatch(&p); err != nil {
+		timeout := -1
+		if !w.drawAt.IsZero() {
+			// Round up to avoid waking up early.
+			timeout = int((time.Until(w.drawAt) + time.Millisecond - 1) / time.Millisecond)
+			if timeout < 0 {
+				timeout = 0
+			}
+		}
+		if err := w.disp.dispatch(&p, timeout); err != nil {
 			return err
 		}
 		select {
@@ -1140,13 +1159,22 @@ func (w *window) loop() error {
 			w.w.Event(system.DestroyEvent{})
 			break
 		}
+		if !w.drawAt.IsZero() {
+			if time.Now().Before(w.drawAt) {
+				// Wait for the frame delayed by the pacer.
+				continue
+			}
+			w.drawAt = time.Time{}
+		}
 		// pass false to skip unnecessary drawing.
 		w.draw(false)
 	}
 	return nil
 }
 
-func (d *wlDisplay) dispatch(p *poller) error {
+// dispatch polls for events and notifications for at most timeout
+// milliseconds, or indefinitely if timeout is negative.
+func (d *wlDisplay) dispatch(p *poller, timeout int) error {
 	dispfd := C.wl_display_get_fd(d.disp)
 	// Poll for events and notifications.
 	pollfds := append(p.pollfds[:0],
@@ -1162,7 +1190,7 @@ func (d *wlDisplay) dispatch(p *poller) error {
 		// POLLOUT to know when we can write again.
 		dispFd.Events |= syscall.POLLOUT
 	}
-	if _, err := syscall.Poll(pollfds, -1); err != nil && err != syscall.EINTR {
+	if _, err := syscall.Poll(pollfds, timeout); err != nil && err != syscall.EINTR {
 		return fmt.Errorf("wayland: poll failed: %v", err)
 	}
 	// Clear notifications.
@@ -1200,6 +1228,10 @@ func (w *window) SetAnimating(anim bool) {
 	w.animating = anim
 }
 
+func (w *window) SetFrameTime(d time.Duration) {
+	w.pacer.frameTime(d)
+}
+
 // Wakeup wakes up the event loop through the notification pipe.
 func (d *wlDisplay) wakeup() {
 	oneByte := make([]byte, 1)
@@ -1431,8 +1463,11 @@ func (w *window) draw(sync bool) {
 			},
 			Metric: cfg,
 		},
-		Sync: sync,
+		Sync:     sync,
+		Interval: w.pacer.interval,
+		Delay:    w.frameDelay,
 	})
+	w.frameDelay = 0
 }
 
 func (w *window) setStage(s system.Stage) {
@@ -98,6 +98,8 @@ type x11Window struct {
 	mode   WindowMode
 
 	wakeups chan struct{}
+	// share is the share group of the window, or nil.
+	share *Share
 }
 
 func (w *x11Window) SetAnimating(anim bool) {
@@ -648,6 +650,7 @@ func newX11Window(gioWin Callbacks, opts *Options) error {
 		xkb:          xkb,
 		xkbEventBase: xkbEventBase,
 		wakeups:      make(chan struct{}, 1),
+		share:        opts.Share,
 	}
 	w.notify.read = pipe[0]
 	w.notify.write = pipe[1]
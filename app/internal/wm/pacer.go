@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package wm
+
+import (
+	"time"
+)
+
+// FramePacer is implemented by drivers that schedule frames from the
+// time it takes to produce them.
+type FramePacer interface {
+	// SetFrameTime reports the time from a FrameEvent until its
+	// frame was ready for presentation.
+	SetFrameTime(d time.Duration)
+}
+
+// framePacer delays frames to start just late enough to be presented at
+// the next display refresh. Starting later than the display signals that
+// it is ready for a new frame reduces the latency from input to display.
+type framePacer struct {
+	// last is the timestamp in milliseconds of the most recent refresh.
+	last    uint32
+	hasLast bool
+	// interval is the estimated refresh interval.
+	interval time.Duration
+	// cost is the estimated time to produce a frame.
+	cost time.Duration
+}
+
+const (
+	// pacingMargin is the time left between the estimated frame
+	// completion and the display deadline.
+	pacingMargin = 3 * time.Millisecond
+	// maxRefreshInterval is the longest time between refreshes
+	// considered continuous animation.
+	maxRefreshInterval = 100 * time.Millisecond
+)
+
+// refresh records a display refresh at the timestamp t in milliseconds,
+// and returns the delay until the next frame should start. The delay is
+// zero until both the refresh interval and the frame time are known.
+func (p *framePacer) refresh(t uint32) time.Duration {
+	// Timestamps wrap around.
+	dt := time.Duration(t-p.last) * time.Millisecond
+	hasLast := p.hasLast
+	p.last, p.hasLast = t, true
+	if hasLast && dt > 0 && dt <= maxRefreshInterval {
+		if p.interval != 0 && dt > p.interval*3/2 {
+			// Frames were skipped. Use the average interval.
+			dt /= (dt + p.interval/2) / p.interval
+		}
+		if p.interval == 0 {
+			p.interval = dt
+		} else {
+			p.interval = (p.interval*7 + dt) / 8
+		}
+	}
+	if p.interval == 0 || p.cost == 0 {
+		return 0
+	}
+	d := p.interval - p.cost - pacingMargin
+	if d < 0 {
+		d = 0
+	}
+	return d
+}
+
+// frameTime records the time to produce a frame. The estimate follows
+// increases immediately and decreases slowly, to avoid missing the
+// deadline after a single fast frame.
+func (p *framePacer) frameTime(d time.Duration) {
+	if d > p.cost {
+		p.cost = d
+	} else {
+		p.cost = (p.cost*15 + d) / 16
+	}
+}
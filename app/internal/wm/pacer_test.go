@@ -0,0 +1,76 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package wm
+
+import (
+	"testing"
+	"time"
+)
+
+// runPacer drives p with refreshes every interval, each followed by a
+// frame that takes the next cost to produce. It returns the delay before
+// the last frame.
+func runPacer(p *framePacer, t uint32, interval time.Duration, costs ...time.Duration) (uint32, time.Duration) {
+	var delay time.Duration
+	for _, c := range costs {
+		delay = p.refresh(t)
+		p.frameTime(c)
+		t += uint32(interval / time.Millisecond)
+	}
+	return t, delay
+}
+
+func TestFramePacerDelay(t *testing.T) {
+	const interval = 16 * time.Millisecond
+	var p framePacer
+	if d := p.refresh(0); d != 0 {
+		t.Errorf("delay before any measurement: got %v, expected 0", d)
+	}
+	costs := make([]time.Duration, 20)
+	for i := range costs {
+		costs[i] = 5 * time.Millisecond
+	}
+	ts, d := runPacer(&p, 16, interval, costs...)
+	if exp := interval - 5*time.Millisecond - pacingMargin; d != exp {
+		t.Errorf("steady delay: got %v, expected %v", d, exp)
+	}
+	// A slow frame cuts the delay of the next frame immediately.
+	p.frameTime(12 * time.Millisecond)
+	if d, exp := p.refresh(ts), interval-12*time.Millisecond-pacingMargin; d != exp {
+		t.Errorf("delay after a slow frame: got %v, expected %v", d, exp)
+	}
+	// A single fast frame barely extends the delay.
+	p.frameTime(time.Millisecond)
+	if d := p.refresh(ts + 16); d > interval-11*time.Millisecond-pacingMargin {
+		t.Errorf("delay after a fast frame: got %v, expected at most %v", d, interval-11*time.Millisecond-pacingMargin)
+	}
+	// Frames slower than the interval are not delayed.
+	p.frameTime(20 * time.Millisecond)
+	if d := p.refresh(ts + 32); d != 0 {
+		t.Errorf("delay of slow frames: got %v, expected 0", d)
+	}
+}
+
+func TestFramePacerInterval(t *testing.T) {
+	var p framePacer
+	ts, _ := runPacer(&p, 1000, 10*time.Millisecond, 2*time.Millisecond, 2*time.Millisecond, 2*time.Millisecond)
+	if p.interval != 10*time.Millisecond {
+		t.Fatalf("interval: got %v, expected 10ms", p.interval)
+	}
+	// A skipped refresh counts as two intervals.
+	p.refresh(ts + 10)
+	if p.interval != 10*time.Millisecond {
+		t.Errorf("interval after a skipped refresh: got %v, expected 10ms", p.interval)
+	}
+	// A pause in the animation keeps the interval.
+	p.refresh(ts + 10 + 500)
+	if p.interval != 10*time.Millisecond {
+		t.Errorf("interval after a pause: got %v, expected 10ms", p.interval)
+	}
+	// Timestamps wrap around.
+	var q framePacer
+	runPacer(&q, ^uint32(0)-15, 16*time.Millisecond, time.Millisecond, time.Millisecond, time.Millisecond)
+	if q.interval != 16*time.Millisecond {
+		t.Errorf("interval across wrap-around: got %v, expected 16ms", q.interval)
+	}
+}
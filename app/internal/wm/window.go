@@ -7,6 +7,8 @@ package wm
 import (
 	"errors"
 	"image/color"
+	"sync"
+	"time"
 
 	"gioui.org/io/key"
 
@@ -32,6 +34,20 @@ type Options struct {
 	NavigationColor *color.NRGBA
 	Orientation     *Orientation
 	CustomRenderer  bool
+	// Share is the share group of the window, or nil.
+	Share *Share
+}
+
+// Share is the state shared by the windows of a share group.
+type Share struct {
+	// GPU holds the GPU resources of the windows. It must only be used
+	// while the context of a window of the group is locked.
+	GPU gpu.Shared
+
+	mu sync.Mutex
+	// ctx is the graphics context shared by the windows, if the
+	// platform supports sharing.
+	ctx interface{}
 }
 
 type WakeupEvent struct{}
@@ -55,6 +71,12 @@ type FrameEvent struct {
 	system.FrameEvent
 
 	Sync bool
+	// Interval is the estimated refresh interval of the display,
+	// or zero if unknown.
+	Interval time.Duration
+	// Delay is the time the frame was delayed to start closer to
+	// the display deadline.
+	Delay time.Duration
 }
 
 type Callbacks interface {
@@ -6,14 +6,17 @@ import (
 	"image"
 	"image/color"
 	"runtime"
+	"time"
 
 	"gioui.org/app/internal/wm"
 	"gioui.org/gpu"
+	"gioui.org/io/profile"
 	"gioui.org/op"
 )
 
 type renderLoop struct {
 	summary string
+	profile profile.Frame
 	drawing bool
 	err     error
 
@@ -30,10 +33,32 @@ type renderLoop struct {
 type frame struct {
 	viewport image.Point
 	ops      *op.Ops
+	// start is the start of the frame.
+	start time.Time
 }
 
+// damagePresenter is implemented by contexts that can present
+// frames with a hint of the changed region.
+type damagePresenter interface {
+	PresentDamage(r image.Rectangle) error
+}
+
+// sharedContext is implemented by contexts that share GPU resources
+// with the contexts of other windows. Such contexts are current only
+// while locked.
+type sharedContext interface {
+	// SharedGPU returns the shared resources, or nil if the context
+	// doesn't share.
+	SharedGPU() *gpu.Shared
+}
+
+// verifyInterval is the interval between checks of frames that the GPU
+// has yet to confirm, while no new frames arrive.
+const verifyInterval = 4 * time.Millisecond
+
 type frameResult struct {
 	profile string
+	frame   profile.Frame
 	err     error
 }
 
@@ -65,22 +90,74 @@ func (l *renderLoop) renderLoop(ctx wm.Context) error {
 		runtime.LockOSThread()
 		// Don't UnlockOSThread to avoid reuse by the Go runtime.
 
-		if err := ctx.MakeCurrent(); err != nil {
-			initErr <- err
-			return
+		var shared *gpu.Shared
+		if c, ok := ctx.(sharedContext); ok {
+			shared = c.SharedGPU()
+		}
+		// lock locks the context around the uses of the GPU outside
+		// frames, if it is current only while locked.
+		lock := func(f func() error) error {
+			if shared != nil {
+				ctx.Lock()
+				defer ctx.Unlock()
+			}
+			return f()
 		}
-		g, err := gpu.New(ctx.API())
+		var g gpu.GPU
+		err := lock(func() error {
+			if err := ctx.MakeCurrent(); err != nil {
+				return err
+			}
+			api := withProgramCache(ctx.API())
+			var err error
+			if shared != nil {
+				g, err = gpu.NewShared(api, shared)
+			} else {
+				g, err = gpu.New(api)
+			}
+			return err
+		})
 		if err != nil {
 			initErr <- err
 			return
 		}
-		defer g.Release()
+		defer lock(func() error {
+			g.Release()
+			return nil
+		})
 		initErr <- nil
+		present := func() error {
+			if d, ok := ctx.(damagePresenter); ok {
+				return d.PresentDamage(g.Damage())
+			}
+			return ctx.Present()
+		}
+		verifyTimer := time.NewTimer(verifyInterval)
+		verifyTimer.Stop()
+		// verifyErr is reported with the next frame.
+		var verifyErr error
 	loop:
 		for {
+			var verify <-chan time.Time
+			if g.Pending() {
+				verifyTimer.Reset(verifyInterval)
+				verify = verifyTimer.C
+			}
 			select {
 			case <-l.refresh:
-				l.refreshErr <- ctx.MakeCurrent()
+				l.refreshErr <- lock(ctx.MakeCurrent)
+			case <-verify:
+				// Present the most recent frame again if it turned out
+				// incomplete. A new frame would replace it anyway.
+				ctx.Lock()
+				redrawn, err := g.Verify(false)
+				if err == nil && redrawn {
+					err = present()
+				}
+				ctx.Unlock()
+				if verifyErr == nil {
+					verifyErr = err
+				}
 			case frame := <-l.frames:
 				ctx.Lock()
 				if runtime.GOOS == "js" {
@@ -95,15 +172,29 @@ func (l *renderLoop) renderLoop(ctx wm.Context) error {
 				l.ack <- struct{}{}
 				var res frameResult
 				res.err = g.Frame()
+				submitted := time.Now()
 				if res.err == nil {
-					res.err = ctx.Present()
+					res.err = present()
+				}
+				presented := time.Now()
+				if verifyErr != nil {
+					res.err, verifyErr = verifyErr, nil
 				}
 				res.profile = g.Profile()
+				res.frame = g.FrameProfile()
+				res.frame.Submit = submitted.Sub(frame.start)
+				res.frame.Present = presented.Sub(submitted)
 				ctx.Unlock()
 				l.results <- res
 			case <-l.stop:
 				break loop
 			}
+			if verify != nil && !verifyTimer.Stop() {
+				select {
+				case <-verifyTimer.C:
+				default:
+				}
+			}
 		}
 	}()
 	return <-initErr
@@ -124,6 +215,10 @@ func (l *renderLoop) Flush() error {
 		if st.profile != "" {
 			l.summary = st.profile
 		}
+		// The renderer reuses the stages for later frames.
+		stages := append(l.profile.Stages[:0], st.frame.Stages...)
+		l.profile = st.frame
+		l.profile.Stages = stages
 		l.drawing = false
 	}
 	return l.err
@@ -133,6 +228,12 @@ func (l *renderLoop) Summary() string {
 	return l.summary
 }
 
+// FrameProfile returns the profile of the most recently completed frame.
+// The Stages slice is reused by later frames.
+func (l *renderLoop) FrameProfile() profile.Frame {
+	return l.profile
+}
+
 func (l *renderLoop) Refresh() {
 	if l.err != nil {
 		return
@@ -143,15 +244,15 @@ func (l *renderLoop) Refresh() {
 	l.setErr(<-l.refreshErr)
 }
 
-// Draw initiates a draw of a frame. It returns a channel
-// than signals when the frame is no longer being accessed.
-func (l *renderLoop) Draw(viewport image.Point, frameOps *op.Ops) <-chan struct{} {
+// Draw initiates a draw of a frame started at start. It returns a
+// channel than signals when the frame is no longer being accessed.
+func (l *renderLoop) Draw(start time.Time, viewport image.Point, frameOps *op.Ops) <-chan struct{} {
 	if l.err != nil {
 		l.ack <- struct{}{}
 		return l.ack
 	}
 	l.Flush()
-	l.frames <- frame{viewport, frameOps}
+	l.frames <- frame{viewport, frameOps, start}
 	l.drawing = true
 	return l.ack
 }
@@ -0,0 +1,63 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package app
+
+import (
+	"io/ioutil"
+	"os"
+	"path/filepath"
+
+	"gioui.org/gpu"
+)
+
+// programCache is a gpu.ProgramCache that stores compiled programs
+// in files. Errors are ignored, because the programs can always be
+// compiled again.
+type programCache struct {
+	dir string
+}
+
+// withProgramCache adds a program cache in the data directory to api,
+// if api supports it.
+func withProgramCache(api gpu.API) gpu.API {
+	gl, ok := api.(gpu.OpenGL)
+	if !ok {
+		return api
+	}
+	dir, err := DataDir()
+	if err != nil {
+		return api
+	}
+	gl.ProgramCache = &programCache{dir: filepath.Join(dir, "gio", "programs")}
+	return gl
+}
+
+func (c *programCache) Get(key string) []byte {
+	data, err := ioutil.ReadFile(filepath.Join(c.dir, key))
+	if err != nil {
+		return nil
+	}
+	return data
+}
+
+func (c *programCache) Put(key string, data []byte) {
+	if err := os.MkdirAll(c.dir, 0700); err != nil {
+		return
+	}
+	// Write to a temporary file and rename it, to avoid
+	// partially written programs.
+	f, err := ioutil.TempFile(c.dir, key+".tmp")
+	if err != nil {
+		return
+	}
+	_, err = f.Write(data)
+	if cerr := f.Close(); err == nil {
+		err = cerr
+	}
+	if err == nil {
+		err = os.Rename(f.Name(), filepath.Join(c.dir, key))
+	}
+	if err != nil {
+		os.Remove(f.Name())
+	}
+}
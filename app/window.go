@@ -51,6 +51,9 @@ type Window struct {
 	hasNextFrame bool
 	nextFrame    time.Time
 	delayedDraw  *time.Timer
+	// interval and delay are the frame pacing reported by the
+	// driver for the current frame.
+	interval, delay time.Duration
 
 	queue  queue
 	cursor pointer.CursorName
@@ -173,7 +176,7 @@ func (w *Window) validateAndProcess(driver wm.Driver, frameStart time.Time, size
 func (w *Window) processFrame(frameStart time.Time, size image.Point, frame *op.Ops) {
 	var sync <-chan struct{}
 	if w.loop != nil {
-		sync = w.loop.Draw(size, frame)
+		sync = w.loop.Draw(frameStart, size, frame)
 	} else {
 		s := make(chan struct{}, 1)
 		s <- struct{}{}
@@ -200,7 +203,11 @@ func (w *Window) processFrame(frameStart time.Time, size image.Point, frame *op.
 		frameDur = frameDur.Truncate(100 * time.Microsecond)
 		q := 100 * time.Microsecond
 		timings := fmt.Sprintf("tot:%7s %s", frameDur.Round(q), w.loop.Summary())
-		w.queue.q.Queue(profile.Event{Timings: timings})
+		f := w.loop.FrameProfile()
+		f.Stages = append([]profile.Stage(nil), f.Stages...)
+		f.Total = frameDur
+		f.Interval, f.Delay = w.interval, w.delay
+		w.queue.q.Queue(profile.Event{Timings: timings, Frame: f})
 	}
 	if t, ok := w.queue.q.WakeupTime(); ok {
 		w.setNextFrame(t)
@@ -502,6 +509,7 @@ func (w *Window) run(opts *wm.Options) {
 				}
 				frameStart := time.Now()
 				w.hasNextFrame = false
+				w.interval, w.delay = e2.Interval, e2.Delay
 				e2.Frame = w.update
 				e2.Queue = &w.queue
 				w.out <- e2.FrameEvent
@@ -521,6 +529,7 @@ func (w *Window) run(opts *wm.Options) {
 					w.destroy(err)
 					return
 				}
+				w.updatePacing(driver)
 				w.updateCursor()
 			case *system.CommandEvent:
 				w.out <- e
@@ -549,6 +558,18 @@ func (w *Window) run(opts *wm.Options) {
 	}
 }
 
+// updatePacing reports the time to produce the most recently completed
+// frame to drivers that schedule frames.
+func (w *Window) updatePacing(d wm.Driver) {
+	p, ok := d.(wm.FramePacer)
+	if !ok || w.loop == nil {
+		return
+	}
+	if t := w.loop.FrameProfile().Submit; t > 0 {
+		p.SetFrameTime(t)
+	}
+}
+
 func (w *Window) updateCursor() {
 	if c := w.queue.q.Cursor(); c != w.cursor {
 		w.cursor = c
@@ -671,4 +692,22 @@ func CustomRenderer(custom bool) Option {
 	}
 }
 
+// ShareGroup is a group of windows that share GPU resources such as
+// programs, image textures and cached paths, for lower memory use and
+// faster startup of the windows after the first. The windows render one
+// at a time. The zero value is ready to use.
+//
+// Sharing is supported by X11 windows. Windows on other platforms don't
+// share.
+type ShareGroup struct {
+	share wm.Share
+}
+
+// Share adds the window to the share group g.
+func Share(g *ShareGroup) Option {
+	return func(opts *wm.Options) {
+		opts.Share = &g.share
+	}
+}
+
 func (driverEvent) ImplementsEvent() {}
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package opentype
+
+import (
+	"sync"
+
+	"golang.org/x/image/font/sfnt"
+	"golang.org/x/image/math/fixed"
+
+	"gioui.org/f32"
+)
+
+// glyphCache is a LRU cache of glyph outlines. Its methods are safe
+// to use concurrently.
+type glyphCache struct {
+	mu         sync.Mutex
+	m          map[glyphKey]*glyphElem
+	head, tail *glyphElem
+}
+
+type glyphElem struct {
+	next, prev *glyphElem
+	key        glyphKey
+	outline    glyphOutline
+}
+
+// glyphKey identifies a glyph outline. Outlines are loaded unhinted
+// and positioned with sub-pixel precision by the caller, so the
+// outline is independent of its sub-pixel offset.
+type glyphKey struct {
+	font  *sfnt.Font
+	index sfnt.GlyphIndex
+	ppem  fixed.Int26_6
+}
+
+// glyphOutline is a glyph outline converted to segments relative
+// to the end of the previous segment.
+type glyphOutline struct {
+	segs []glyphSegment
+	// end is the end of the last segment, relative to the glyph
+	// origin.
+	end f32.Point
+}
+
+type glyphSegment struct {
+	op   sfnt.SegmentOp
+	args [3]f32.Point
+}
+
+// maxGlyphs is the maximum number of outlines in a glyphCache.
+const maxGlyphs = 4000
+
+// outline returns the outline of the glyph for r in f, loading it if
+// it is not in the cache.
+func (c *glyphCache) outline(buf *sfnt.Buffer, f *opentype, ppem fixed.Int26_6, r rune) (glyphOutline, bool) {
+	g, err := f.Font.GlyphIndex(buf, r)
+	if err != nil {
+		return glyphOutline{}, false
+	}
+	k := glyphKey{font: f.Font, index: g, ppem: ppem}
+	if o, ok := c.Get(k); ok {
+		return o, true
+	}
+	segs, err := f.Font.LoadGlyph(buf, g, ppem, nil)
+	if err != nil {
+		return glyphOutline{}, false
+	}
+	o := newGlyphOutline(segs)
+	c.Put(k, o)
+	return o, true
+}
+
+func newGlyphOutline(segs []sfnt.Segment) glyphOutline {
+	o := glyphOutline{
+		segs: make([]glyphSegment, len(segs)),
+	}
+	var lastArg f32.Point
+	// Convert sfnt.Segments to relative segments.
+	for i, fseg := range segs {
+		nargs := 1
+		switch fseg.Op {
+		case sfnt.SegmentOpQuadTo:
+			nargs = 2
+		case sfnt.SegmentOpCubeTo:
+			nargs = 3
+		}
+		seg := glyphSegment{op: fseg.Op}
+		for j := 0; j < nargs; j++ {
+			a := f32.Point{
+				X: float32(fseg.Args[j].X) / 64,
+				Y: float32(fseg.Args[j].Y) / 64,
+			}
+			seg.args[j] = a.Sub(lastArg)
+			if j == nargs-1 {
+				lastArg = a
+			}
+		}
+		o.segs[i] = seg
+	}
+	o.end = lastArg
+	return o
+}
+
+func (c *glyphCache) Get(k glyphKey) (glyphOutline, bool) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if e, ok := c.m[k]; ok {
+		c.remove(e)
+		c.insert(e)
+		return e.outline, true
+	}
+	return glyphOutline{}, false
+}
+
+func (c *glyphCache) Put(k glyphKey, o glyphOutline) {
+	c.mu.Lock()
+	defer c.mu.Unlock()
+	if c.m == nil {
+		c.m = make(map[glyphKey]*glyphElem)
+		c.head = new(glyphElem)
+		c.tail = new(glyphElem)
+		c.head.prev = c.tail
+		c.tail.next = c.head
+	}
+	if e, ok := c.m[k]; ok {
+		// Another goroutine loaded the glyph first.
+		c.remove(e)
+		c.insert(e)
+		return
+	}
+	e := &glyphElem{key: k, outline: o}
+	c.m[k] = e
+	c.insert(e)
+	if len(c.m) > maxGlyphs {
+		oldest := c.tail.next
+		c.remove(oldest)
+		delete(c.m, oldest.key)
+	}
+}
+
+func (c *glyphCache) remove(e *glyphElem) {
+	e.next.prev = e.prev
+	e.prev.next = e.next
+}
+
+func (c *glyphCache) insert(e *glyphElem) {
+	e.next = c.head
+	e.prev = c.head.prev
+	e.prev.next = e
+	e.next.prev = e
+}
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package opentype
+
+import (
+	"testing"
+
+	"golang.org/x/image/font/sfnt"
+)
+
+func TestGlyphLRU(t *testing.T) {
+	c := new(glyphCache)
+	key := func(i int) glyphKey {
+		return glyphKey{index: sfnt.GlyphIndex(i)}
+	}
+	for i := 0; i < maxGlyphs; i++ {
+		c.Put(key(i), glyphOutline{})
+	}
+	for i := 0; i < maxGlyphs; i++ {
+		if _, ok := c.Get(key(i)); !ok {
+			t.Fatalf("key %d was evicted", i)
+		}
+	}
+	c.Put(key(maxGlyphs), glyphOutline{})
+	for i := 1; i < maxGlyphs+1; i++ {
+		if _, ok := c.Get(key(i)); !ok {
+			t.Fatalf("key %d was evicted", i)
+		}
+	}
+	if _, ok := c.Get(key(0)); ok {
+		t.Fatalf("key %d was not evicted", 0)
+	}
+}
@@ -23,7 +23,8 @@ import (
 // Font implements text.Face. Its methods are safe to use
 // concurrently.
 type Font struct {
-	font *sfnt.Font
+	font  *sfnt.Font
+	cache *glyphCache
 }
 
 // Collection is a collection of one or more fonts. When used as a text.Face,
@@ -31,6 +32,7 @@ type Font struct {
 // that supports it.
 type Collection struct {
 	fonts []*opentype
+	cache *glyphCache
 }
 
 type opentype struct {
@@ -52,7 +54,7 @@ func Parse(src []byte) (*Font, error) {
 	if err != nil {
 		return nil, err
 	}
-	return &Font{font: fnt}, nil
+	return &Font{font: fnt, cache: new(glyphCache)}, nil
 }
 
 // ParseCollection parses an SFNT font collection, such as TTC or OTC data,
@@ -93,7 +95,7 @@ func newCollectionFrom(coll *sfnt.Collection) (*Collection, error) {
 			Hinting: font.HintingFull,
 		}
 	}
-	return &Collection{fonts: fonts}, nil
+	return &Collection{fonts: fonts, cache: new(glyphCache)}, nil
 }
 
 // NumFonts returns the number of fonts in the collection.
@@ -106,7 +108,7 @@ func (c *Collection) Font(i int) (*Font, error) {
 	if i < 0 || len(c.fonts) <= i {
 		return nil, sfnt.ErrNotFound
 	}
-	return &Font{font: c.fonts[i].Font}, nil
+	return &Font{font: c.fonts[i].Font, cache: c.cache}, nil
 }
 
 func (f *Font) Layout(ppem fixed.Int26_6, maxWidth int, txt io.Reader) ([]text.Line, error) {
@@ -121,7 +123,7 @@ func (f *Font) Layout(ppem fixed.Int26_6, maxWidth int, txt io.Reader) ([]text.L
 
 func (f *Font) Shape(ppem fixed.Int26_6, str text.Layout) op.CallOp {
 	var buf sfnt.Buffer
-	return textPath(&buf, ppem, []*opentype{{Font: f.font, Hinting: font.HintingFull}}, str)
+	return textPath(&buf, f.cache, ppem, []*opentype{{Font: f.font, Hinting: font.HintingFull}}, str)
 }
 
 func (f *Font) Metrics(ppem fixed.Int26_6) font.Metrics {
@@ -141,7 +143,7 @@ func (c *Collection) Layout(ppem fixed.Int26_6, maxWidth int, txt io.Reader) ([]
 
 func (c *Collection) Shape(ppem fixed.Int26_6, str text.Layout) op.CallOp {
 	var buf sfnt.Buffer
-	return textPath(&buf, ppem, c.fonts, str)
+	return textPath(&buf, c.cache, ppem, c.fonts, str)
 }
 
 func fontForGlyph(buf *sfnt.Buffer, fonts []*opentype, r rune) *opentype {
@@ -261,7 +263,7 @@ func toLayout(glyphs []glyph) text.Layout {
 	return text.Layout{Text: buf.String(), Advances: advs}
 }
 
-func textPath(buf *sfnt.Buffer, ppem fixed.Int26_6, fonts []*opentype, str text.Layout) op.CallOp {
+func textPath(buf *sfnt.Buffer, cache *glyphCache, ppem fixed.Int26_6, fonts []*opentype, str text.Layout) op.CallOp {
 	var lastPos f32.Point
 	var builder clip.Path
 	ops := new(op.Ops)
@@ -275,7 +277,7 @@ func textPath(buf *sfnt.Buffer, ppem fixed.Int26_6, fonts []*opentype, str text.
 			if f == nil {
 				continue
 			}
-			segs, ok := f.LoadGlyph(buf, ppem, r)
+			outline, ok := cache.outline(buf, f, ppem, r)
 			if !ok {
 				continue
 			}
@@ -285,41 +287,21 @@ func textPath(buf *sfnt.Buffer, ppem fixed.Int26_6, fonts []*opentype, str text.
 			}
 			builder.Move(pos.Sub(lastPos))
 			lastPos = pos
-			var lastArg f32.Point
-			// Convert sfnt.Segments to relative segments.
-			for _, fseg := range segs {
-				nargs := 1
-				switch fseg.Op {
-				case sfnt.SegmentOpQuadTo:
-					nargs = 2
-				case sfnt.SegmentOpCubeTo:
-					nargs = 3
-				}
-				var args [3]f32.Point
-				for i := 0; i < nargs; i++ {
-					a := f32.Point{
-						X: float32(fseg.Args[i].X) / 64,
-						Y: float32(fseg.Args[i].Y) / 64,
-					}
-					args[i] = a.Sub(lastArg)
-					if i == nargs-1 {
-						lastArg = a
-					}
-				}
-				switch fseg.Op {
+			for _, seg := range outline.segs {
+				switch seg.op {
 				case sfnt.SegmentOpMoveTo:
-					builder.Move(args[0])
+					builder.Move(seg.args[0])
 				case sfnt.SegmentOpLineTo:
-					builder.Line(args[0])
+					builder.Line(seg.args[0])
 				case sfnt.SegmentOpQuadTo:
-					builder.Quad(args[0], args[1])
+					builder.Quad(seg.args[0], seg.args[1])
 				case sfnt.SegmentOpCubeTo:
-					builder.Cube(args[0], args[1], args[2])
+					builder.Cube(seg.args[0], seg.args[1], seg.args[2])
 				default:
 					panic("unsupported segment op")
 				}
 			}
-			lastPos = lastPos.Add(lastArg)
+			lastPos = lastPos.Add(outline.end)
 		}
 		x += str.Advances[rune]
 		rune++
@@ -398,15 +380,3 @@ func (f *opentype) Bounds(buf *sfnt.Buffer, ppem fixed.Int26_6) fixed.Rectangle2
 	r, _ := f.Font.Bounds(buf, ppem, f.Hinting)
 	return r
 }
-
-func (f *opentype) LoadGlyph(buf *sfnt.Buffer, ppem fixed.Int26_6, r rune) ([]sfnt.Segment, bool) {
-	g, err := f.Font.GlyphIndex(buf, r)
-	if err != nil {
-		return nil, false
-	}
-	segs, err := f.Font.LoadGlyph(buf, g, ppem, nil)
-	if err != nil {
-		return nil, false
-	}
-	return segs, true
-}
@@ -280,6 +280,10 @@ func (s *Scroll) Scroll(cfg unit.Metric, q event.Queue, t time.Time, axis Axis)
 			if !s.dragging || s.pid != e.PointerID {
 				continue
 			}
+			// Use the coalesced samples for an accurate fling velocity.
+			for _, h := range e.History {
+				s.estimator.Sample(h.Time, s.val(h.Position))
+			}
 			val := s.val(e.Position)
 			s.estimator.Sample(e.Time, val)
 			v := int(math.Round(float64(val)))
@@ -13,3 +13,6 @@ type OpenGL = driver.OpenGL
 
 // Direct3D11 denotes the Direct3D API.
 type Direct3D11 = driver.Direct3D11
+
+// ProgramCache stores compiled GPU programs.
+type ProgramCache = driver.ProgramCache
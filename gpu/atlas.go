@@ -0,0 +1,196 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package gpu
+
+import (
+	"errors"
+	"image"
+	"sort"
+
+	"gioui.org/gpu/internal/driver"
+)
+
+// imagePageDim is the largest page of the image atlas. Smaller pages
+// keep atlas coordinates precise; images that don't fit add pages.
+const imagePageDim = 2048
+
+// imageAtlas packs ImageOp images into texture pages. Images stay in place
+// until evicted, least recently used first, to make room for new images.
+type imageAtlas struct {
+	packer packer
+	// positions maps imageOpData.handles to their placements.
+	positions map[interface{}]*atlasImage
+	// frame counts calls to place, for tracking image use.
+	frame int
+	// stale is scratch space for eviction candidates.
+	stale []*atlasImage
+	// updates are the placed images with dirty regions to upload.
+	updates []*atlasImage
+	// uploads are the images placed by the most recent frame, to upload
+	// in full.
+	uploads []*atlasImage
+	// versions are the versions of the mutable images of the frame, for
+	// the images placed by the frame.
+	versions map[interface{}]int
+	// textures holds a texture for every page of the packer.
+	textures []driver.Texture
+}
+
+// atlasImage is an image placed in the image atlas.
+type atlasImage struct {
+	handle interface{}
+	// page is the atlas page of the image.
+	page int
+	// rect is the space occupied by the image, including padding.
+	rect image.Rectangle
+	// lastUse is the atlas frame the image was last drawn in.
+	lastUse int
+	src     *image.RGBA
+	// dirty is the region of src not yet uploaded.
+	dirty image.Rectangle
+	// version is the version of a mutable src reflected by the atlas
+	// and dirty.
+	version int
+}
+
+const (
+	// atlasPadding is the number of pixels added to the right and below
+	// images, to avoid atlas filtering artifacts.
+	atlasPadding = 1
+	// atlasGrowth is the increment of the atlas dimension.
+	atlasGrowth = 256
+)
+
+// place places the images of ops in the atlas and sets their positions.
+// Images already in the atlas keep their place. A new image evicts the
+// least recently used images not drawn by ops until it fits. If that is
+// not enough, the images of ops are repacked if the atlas is mostly free.
+// Otherwise the atlas grows until its pages reach pageDim, at most maxDim,
+// and gains pages after that. Images larger than pageDim grow every page
+// up to maxDim.
+//
+// The images to upload afterwards are in uploads and updates. place
+// reports whether the page dimension changed, which invalidates every
+// page.
+func (a *imageAtlas) place(ops []textureOp, pageDim, maxDim int) (bool, error) {
+	a.frame++
+	resized := false
+	reclaimed := false
+restart:
+	for {
+		a.updates = a.updates[:0]
+		a.uploads = a.uploads[:0]
+		// Mark every image in use before evicting any.
+		for _, op := range ops {
+			img, exists := a.positions[op.img.handle]
+			if !exists {
+				continue
+			}
+			if img.lastUse != a.frame && !img.dirty.Empty() {
+				a.updates = append(a.updates, img)
+			}
+			img.lastUse = a.frame
+		}
+		evicted := false
+		for i, op := range ops {
+			if img, exists := a.positions[op.img.handle]; exists {
+				ops[i].page, ops[i].pos = img.page, img.rect.Min
+				continue
+			}
+			size := op.img.src.Bounds().Size().Add(image.Pt(atlasPadding, atlasPadding))
+			if size.X > maxDim || size.Y > maxDim {
+				return false, errors.New("compute: image too large for the image atlas")
+			}
+			place, fits := a.packer.tryAdd(size)
+			for !fits {
+				// Drop the least recently used images until there is room.
+				if !evicted {
+					evicted = true
+					a.collectStale()
+				}
+				if len(a.stale) == 0 {
+					break
+				}
+				img := a.stale[0]
+				a.stale = a.stale[1:]
+				delete(a.positions, img.handle)
+				a.packer.free(img.page, img.rect)
+				place, fits = a.packer.tryAdd(size)
+			}
+			if !fits {
+				dim := a.packer.maxDim
+				used, total := a.packer.usage()
+				switch {
+				case !reclaimed && used+size.X*size.Y <= total/2:
+					// The free space is too fragmented. Repack the
+					// images in use.
+					reclaimed = true
+				case dim < pageDim || size.X > dim || size.Y > dim:
+					limit := pageDim
+					if size.X > limit || size.Y > limit {
+						limit = maxDim
+					}
+					a.packer.maxDim += atlasGrowth
+					if a.packer.maxDim > limit {
+						a.packer.maxDim = limit
+					}
+					resized = true
+				default:
+					a.packer.newPage()
+					place, fits = a.packer.tryAdd(size)
+				}
+				if !fits {
+					for h := range a.positions {
+						delete(a.positions, h)
+					}
+					a.stale = a.stale[:0]
+					a.packer.clear()
+					a.packer.newPage()
+					continue restart
+				}
+			}
+			if a.positions == nil {
+				a.positions = make(map[interface{}]*atlasImage)
+			}
+			img := &atlasImage{
+				handle:  op.img.handle,
+				page:    place.Idx,
+				rect:    image.Rectangle{Min: place.Pos, Max: place.Pos.Add(size)},
+				lastUse: a.frame,
+				src:     op.img.src,
+				version: a.versions[op.img.handle],
+			}
+			a.positions[op.img.handle] = img
+			a.uploads = append(a.uploads, img)
+			ops[i].page, ops[i].pos = img.page, img.rect.Min
+		}
+		break
+	}
+	a.stale = a.stale[:0]
+	for h := range a.versions {
+		delete(a.versions, h)
+	}
+	return resized, nil
+}
+
+// release the textures of the atlas.
+func (a *imageAtlas) release() {
+	for _, t := range a.textures {
+		t.Release()
+	}
+	*a = imageAtlas{}
+}
+
+// collectStale fills stale with the images not used in the current
+// frame, least recently used first.
+func (a *imageAtlas) collectStale() {
+	a.stale = a.stale[:0]
+	for _, img := range a.positions {
+		if img.lastUse != a.frame {
+			a.stale = append(a.stale, img)
+		}
+	}
+	sort.Slice(a.stale, func(i, j int) bool {
+		return a.stale[i].lastUse < a.stale[j].lastUse
+	})
+}
@@ -0,0 +1,138 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package gpu
+
+import (
+	"image"
+	"testing"
+)
+
+// atlasOps returns texture ops for images of the given size, padding
+// excluded.
+func atlasOps(n int, size image.Point) []textureOp {
+	ops := make([]textureOp, n)
+	for i := range ops {
+		ops[i].img = imageOpData{
+			src:    image.NewRGBA(image.Rectangle{Max: size}),
+			handle: new(int),
+		}
+	}
+	return ops
+}
+
+func placeImages(t *testing.T, a *imageAtlas, ops []textureOp, pageDim, maxDim int) bool {
+	t.Helper()
+	resized, err := a.place(ops, pageDim, maxDim)
+	if err != nil {
+		t.Fatal(err)
+	}
+	checkAtlas(t, a, ops)
+	return resized
+}
+
+// checkAtlas verifies that the images of ops are placed where the atlas
+// records them, without overlaps.
+func checkAtlas(t *testing.T, a *imageAtlas, ops []textureOp) {
+	t.Helper()
+	for _, op := range ops {
+		img, ok := a.positions[op.img.handle]
+		if !ok {
+			t.Fatalf("image %p not placed", op.img.handle)
+		}
+		if op.page != img.page || op.pos != img.rect.Min {
+			t.Errorf("image %p at %d %v, recorded at %d %v", op.img.handle, op.page, op.pos, img.page, img.rect.Min)
+		}
+		if img.lastUse != a.frame {
+			t.Errorf("image %p not marked as used", op.img.handle)
+		}
+		if !img.rect.In(image.Rectangle{Max: image.Pt(a.packer.maxDim, a.packer.maxDim)}) {
+			t.Errorf("image %p at %v outside the page", op.img.handle, img.rect)
+		}
+	}
+	for _, img := range a.positions {
+		for _, other := range a.positions {
+			if img != other && img.page == other.page && img.rect.Overlaps(other.rect) {
+				t.Fatalf("images overlap at %v and %v", img.rect, other.rect)
+			}
+		}
+	}
+}
+
+func TestImageAtlasEvictsStaleOnly(t *testing.T) {
+	// Four images fill a page.
+	ops := atlasOps(4, image.Pt(31, 31))
+	a := new(imageAtlas)
+	placeImages(t, a, ops, 64, 64)
+	before := make(map[interface{}]image.Point)
+	for _, op := range ops {
+		before[op.img.handle] = op.pos
+	}
+	// A new image drawn before three of the old ones must evict the
+	// fourth, which is the only image not drawn.
+	frame := append(atlasOps(1, image.Pt(31, 31)), ops[:3]...)
+	placeImages(t, a, frame, 64, 64)
+	for _, op := range frame[1:] {
+		if p := before[op.img.handle]; op.pos != p {
+			t.Errorf("image moved from %v to %v", p, op.pos)
+		}
+	}
+	if _, ok := a.positions[ops[3].img.handle]; ok {
+		t.Error("stale image not evicted")
+	}
+	if len(a.uploads) != 1 || a.uploads[0].handle != frame[0].img.handle {
+		t.Errorf("%d images uploaded, expected only the new image", len(a.uploads))
+	}
+	if frame[0].pos != before[ops[3].img.handle] {
+		t.Errorf("new image at %v, expected the place of the evicted image", frame[0].pos)
+	}
+}
+
+func TestImageAtlasPages(t *testing.T) {
+	a := new(imageAtlas)
+	// More images than fit a page add pages once the pages reach
+	// their maximum dimension.
+	ops := atlasOps(9, image.Pt(31, 31))
+	placeImages(t, a, ops, 64, 256)
+	if d := a.packer.maxDim; d != 64 {
+		t.Errorf("page dimension is %d, expected 64", d)
+	}
+	if n := len(a.packer.pages); n != 3 {
+		t.Errorf("%d pages, expected 3", n)
+	}
+	// Images in use keep their pages and places.
+	ops = append(ops, atlasOps(1, image.Pt(31, 31))...)
+	placeImages(t, a, ops, 64, 256)
+	if len(a.uploads) != 1 {
+		t.Errorf("%d images uploaded, expected 1", len(a.uploads))
+	}
+	// An image larger than a page grows the pages.
+	large := atlasOps(1, image.Pt(100, 100))
+	if !placeImages(t, a, large, 64, 256) {
+		t.Error("atlas not resized for a large image")
+	}
+	if d := a.packer.maxDim; d < 101 {
+		t.Errorf("page dimension is %d, expected at least 101", d)
+	}
+	if _, err := a.place(atlasOps(1, image.Pt(300, 300)), 64, 256); err == nil {
+		t.Error("image larger than the maximum dimension placed")
+	}
+}
+
+func TestImageAtlasRepack(t *testing.T) {
+	a := new(imageAtlas)
+	small := atlasOps(16, image.Pt(15, 15))
+	placeImages(t, a, small, 64, 64)
+	// Every fourth small image remains in use; the free space is
+	// enough but fragmented.
+	var frame []textureOp
+	for i := 0; i < len(small); i += 4 {
+		frame = append(frame, small[i])
+	}
+	frame = append(frame, atlasOps(1, image.Pt(31, 31))...)
+	if placeImages(t, a, frame, 64, 64) {
+		t.Error("atlas resized, expected a repack")
+	}
+	if n := len(a.packer.pages); n != 1 {
+		t.Errorf("%d pages after repacking, expected 1", n)
+	}
+}
@@ -0,0 +1,130 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package gpu
+
+import (
+	"unsafe"
+
+	"gioui.org/f32"
+	"gioui.org/gpu/internal/driver"
+	"gioui.org/internal/byteslice"
+	"gioui.org/internal/f32color"
+)
+
+// batcher draws runs of color material quads in single draw calls.
+// Instead of uploading uniforms for every quad, the transformed
+// position, depth, color and cover coordinates are stored in a
+// vertex buffer.
+type batcher struct {
+	ctx       driver.Device
+	prog      driver.Program
+	coverProg driver.Program
+	layout    driver.InputLayout
+	// zbuf holds the vertices of the opaque pass, buf the vertices
+	// of the blended pass. Separate buffers avoid overwriting a
+	// buffer still in use by the GPU.
+	zbuf, buf sizedBuffer
+	verts     []batchVertex
+	runs      []batchRun
+}
+
+// batchVertex matches the inputs of batch.vert.
+type batchVertex struct {
+	posX, posY, posZ       float32
+	colR, colG, colB, colA float32
+	coverU, coverV         float32
+}
+
+// batchRun describes a run of consecutive ops drawn in one draw call.
+type batchRun struct {
+	// op is the index of the first op, n the number of ops.
+	op, n int
+	// cover is the cover texture, or nil for unclipped quads.
+	cover driver.Texture
+	// vert is the index of the first vertex.
+	vert int
+}
+
+// minBatch is the minimum number of quads worth a batched draw.
+const minBatch = 2
+
+func newBatcher(ctx driver.Device) *batcher {
+	prog, err := ctx.NewProgram(shader_batch_vert, shader_batch_frag)
+	if err != nil {
+		// The shaders are not available for every backend.
+		return nil
+	}
+	coverProg, err := ctx.NewProgram(shader_batch_vert, shader_batch_cover_frag)
+	if err != nil {
+		prog.Release()
+		return nil
+	}
+	layout, err := ctx.NewInputLayout(shader_batch_vert, []driver.InputDesc{
+		{Type: driver.DataTypeFloat, Size: 3, Offset: int(unsafe.Offsetof((*batchVertex)(nil).posX))},
+		{Type: driver.DataTypeFloat, Size: 4, Offset: int(unsafe.Offsetof((*batchVertex)(nil).colR))},
+		{Type: driver.DataTypeFloat, Size: 2, Offset: int(unsafe.Offsetof((*batchVertex)(nil).coverU))},
+	})
+	if err != nil {
+		prog.Release()
+		coverProg.Release()
+		return nil
+	}
+	return &batcher{
+		ctx:       ctx,
+		prog:      prog,
+		coverProg: coverProg,
+		layout:    layout,
+	}
+}
+
+func (b *batcher) release() {
+	b.prog.Release()
+	b.coverProg.Release()
+	b.layout.Release()
+	b.zbuf.release()
+	b.buf.release()
+}
+
+func (b *batcher) reset() {
+	b.verts = b.verts[:0]
+	b.runs = b.runs[:0]
+}
+
+// addQuad adds the two triangles of the quad transformed by scale and
+// off. The cover coordinates are transformed by coverScale and coverOff.
+func (b *batcher) addQuad(z float32, col f32color.RGBA, scale, off, coverScale, coverOff f32.Point) {
+	v := func(x, y, u, w float32) batchVertex {
+		return batchVertex{
+			posX: x*scale.X + off.X, posY: y*scale.Y + off.Y, posZ: z,
+			colR: col.R, colG: col.G, colB: col.B, colA: col.A,
+			coverU: u*coverScale.X + coverOff.X, coverV: w*coverScale.Y + coverOff.Y,
+		}
+	}
+	tl, tr := v(-1, +1, 0, 0), v(+1, +1, 1, 0)
+	bl, br := v(-1, -1, 0, 1), v(+1, -1, 1, 1)
+	b.verts = append(b.verts, tl, tr, bl, bl, tr, br)
+}
+
+// upload copies the vertices to buf.
+func (b *batcher) upload(buf *sizedBuffer) {
+	if len(b.verts) == 0 {
+		return
+	}
+	data := byteslice.Slice(b.verts)
+	if err := buf.ensureCapacity(b.ctx, driver.BufferBindingVertices, pow2Ceil(len(data))); err != nil {
+		panic(err)
+	}
+	buf.buffer.Upload(data)
+}
+
+// draw draws the vertices of run from buf.
+func (b *batcher) draw(buf *sizedBuffer, run batchRun) {
+	if run.cover != nil {
+		b.ctx.BindProgram(b.coverProg)
+	} else {
+		b.ctx.BindProgram(b.prog)
+	}
+	b.ctx.BindVertexBuffer(buf.buffer, int(unsafe.Sizeof(batchVertex{})), 0)
+	b.ctx.BindInputLayout(b.layout)
+	b.ctx.DrawArrays(driver.DrawModeTriangles, run.vert, run.n*6)
+}
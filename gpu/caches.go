@@ -9,9 +9,18 @@ import (
 	"gioui.org/internal/ops"
 )
 
+// resourceCache holds resources between frames. Resources not used by
+// recent frames are released.
 type resourceCache struct {
-	res    map[interface{}]resource
-	newRes map[interface{}]resource
+	res map[interface{}]cachedResource
+	// gen counts the frames of the cache.
+	gen int
+}
+
+type cachedResource struct {
+	res resource
+	// lastUse is the frame that last used the resource.
+	lastUse int
 }
 
 // opCache is like a resourceCache but using concrete types and a
@@ -23,6 +32,8 @@ type opCache struct {
 	// list of indexes in cache that are free and can be used
 	freelist []int
 	cache    []opCacheValue
+	// gen counts the frames of the cache.
+	gen int
 }
 
 type opCacheValue struct {
@@ -32,51 +43,49 @@ type opCacheValue struct {
 
 	bounds f32.Rectangle
 	// the fields below are handled by opCache
-	key  ops.Key
-	keep bool
+	key ops.Key
+	// lastUse is the frame that last used the value.
+	lastUse int
 }
 
 func newResourceCache() *resourceCache {
 	return &resourceCache{
-		res:    make(map[interface{}]resource),
-		newRes: make(map[interface{}]resource),
+		res: make(map[interface{}]cachedResource),
 	}
 }
 
 func (r *resourceCache) get(key interface{}) (resource, bool) {
 	v, exists := r.res[key]
-	if exists {
-		r.newRes[key] = v
+	if exists && v.lastUse != r.gen {
+		v.lastUse = r.gen
+		r.res[key] = v
 	}
-	return v, exists
+	return v.res, exists
 }
 
 func (r *resourceCache) put(key interface{}, val resource) {
-	if _, exists := r.newRes[key]; exists {
+	if _, exists := r.res[key]; exists {
 		panic(fmt.Errorf("key exists, %p", key))
 	}
-	r.res[key] = val
-	r.newRes[key] = val
+	r.res[key] = cachedResource{res: val, lastUse: r.gen}
 }
 
-func (r *resourceCache) frame() {
+// frame ends a frame and releases the resources not used by the most
+// recent keep frames.
+func (r *resourceCache) frame(keep int) {
 	for k, v := range r.res {
-		if _, exists := r.newRes[k]; !exists {
+		if v.lastUse <= r.gen-keep {
 			delete(r.res, k)
-			v.release()
+			v.res.release()
 		}
 	}
-	for k, v := range r.newRes {
-		delete(r.newRes, k)
-		r.res[k] = v
-	}
+	r.gen++
 }
 
 func (r *resourceCache) release() {
-	for _, v := range r.newRes {
-		v.release()
+	for _, v := range r.res {
+		v.res.release()
 	}
-	r.newRes = nil
 	r.res = nil
 }
 
@@ -93,13 +102,13 @@ func (r *opCache) get(key ops.Key) (o opCacheValue, exist bool) {
 	if v == 0 {
 		return
 	}
-	r.cache[v-1].keep = true
+	r.cache[v-1].lastUse = r.gen
 	return r.cache[v-1], true
 }
 
 func (r *opCache) put(key ops.Key, val opCacheValue) {
 	v := r.index[key]
-	val.keep = true
+	val.lastUse = r.gen
 	val.key = key
 	if v == 0 {
 		// not in cache
@@ -117,27 +126,36 @@ func (r *opCache) put(key ops.Key, val opCacheValue) {
 	}
 }
 
-func (r *opCache) frame() {
+// frame ends a frame and frees the values not used by the most recent
+// keep frames.
+func (r *opCache) frame(keep int) {
 	r.freelist = r.freelist[:0]
-	for i, v := range r.cache {
-		r.cache[i].keep = false
-		if v.keep {
+	for i := range r.cache {
+		v := &r.cache[i]
+		if v.lastUse > r.gen-keep {
 			continue
 		}
 		if v.data.data != nil {
 			v.data.release()
-			r.cache[i].data.data = nil
+			v.data.data = nil
+		}
+		// The slot may be free already, and its key used by another
+		// slot.
+		if r.index[v.key] == i+1 {
+			delete(r.index, v.key)
 		}
-		delete(r.index, v.key)
 		r.freelist = append(r.freelist, i)
 	}
+	r.gen++
 }
 
 func (r *opCache) release() {
 	for i := range r.cache {
-		r.cache[i].keep = false
+		if d := &r.cache[i].data; d.data != nil {
+			d.release()
+			d.data = nil
+		}
 	}
-	r.frame()
 	r.index = nil
 	r.freelist = nil
 	r.cache = nil
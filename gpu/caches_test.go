@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package gpu
+
+import (
+	"testing"
+)
+
+type testResource struct {
+	released bool
+}
+
+func (r *testResource) release() {
+	r.released = true
+}
+
+func TestResourceCacheKeep(t *testing.T) {
+	c := newResourceCache()
+	used, idle := new(testResource), new(testResource)
+	c.put(used, used)
+	c.put(idle, idle)
+	// With two users, a resource survives a frame of the other user.
+	c.frame(2)
+	c.get(used)
+	c.frame(2)
+	if used.released || idle.released {
+		t.Fatal("resource used by the previous frame released")
+	}
+	// A resource not used by any recent frame is released, even if the
+	// other users are idle.
+	c.get(used)
+	c.frame(2)
+	if !idle.released {
+		t.Error("unused resource not released")
+	}
+	if used.released {
+		t.Error("used resource released")
+	}
+	if _, ok := c.get(idle); ok {
+		t.Error("released resource still cached")
+	}
+}
@@ -8,7 +8,8 @@ import (
 type quadSplitter struct {
 	bounds  f32.Rectangle
 	contour uint32
-	d       *drawOps
+	// verts is the vertex buffer to append to.
+	verts *[]byte
 }
 
 func encodeQuadTo(data []byte, meta uint32, from, ctrl, to f32.Point) {
@@ -43,7 +44,8 @@ func encodeVertex(data []byte, meta uint32, cornerx, cornery int16, from, ctrl,
 }
 
 func (qs *quadSplitter) encodeQuadTo(from, ctrl, to f32.Point) {
-	data := qs.d.writeVertCache(vertStride * 4)
+	*qs.verts = append(*qs.verts, make([]byte, vertStride*4)...)
+	data := (*qs.verts)[len(*qs.verts)-vertStride*4:]
 	encodeQuadTo(data, qs.contour, from, ctrl, to)
 }
 
@@ -6,6 +6,7 @@ import (
 	"encoding/binary"
 	"errors"
 	"fmt"
+	"hash/maphash"
 	"image"
 	"image/color"
 	"math/bits"
@@ -18,6 +19,7 @@ import (
 	"gioui.org/internal/f32color"
 	"gioui.org/internal/ops"
 	"gioui.org/internal/scene"
+	"gioui.org/io/profile"
 	"gioui.org/layout"
 	"gioui.org/op"
 )
@@ -28,8 +30,13 @@ type compute struct {
 
 	drawOps       drawOps
 	texOps        []textureOp
+	gradOps       []gradientOp
 	cache         *resourceCache
 	maxTextureDim int
+	// imagePageDim is the dimension of image atlas pages.
+	imagePageDim int
+	// shared is the Shared of the renderer, or nil.
+	shared *Shared
 
 	programs struct {
 		elements   driver.Program
@@ -43,8 +50,14 @@ type compute struct {
 	buffers struct {
 		config driver.Buffer
 		scene  sizedBuffer
-		state  sizedBuffer
-		memory sizedBuffer
+		// layout is the content of scene.
+		layout sceneLayout
+		// segments are the ranges of scene commands that layout stores
+		// in blocks: the commands before the operations, and the commands
+		// of every operation.
+		segments []sceneSegment
+		state    sizedBuffer
+		memory   sizedBuffer
 	}
 	output struct {
 		size image.Point
@@ -52,20 +65,29 @@ type compute struct {
 		// but contains data in sRGB. See blitOutput for more detail.
 		image    driver.Texture
 		blitProg driver.Program
+		// fbo is the framebuffer for image. It is only created when the
+		// output is rendered in regions.
+		fbo driver.Framebuffer
+		// region is the render target for outputs too large to be processed
+		// by the binning and coarse stages in one pass.
+		region struct {
+			size  image.Point
+			image driver.Texture
+			fbo   driver.Framebuffer
+		}
 	}
-	// images contains ImageOp images packed into a texture atlas.
-	images struct {
-		packer packer
-		// positions maps imageOpData.handles to positions inside tex.
-		positions map[interface{}]image.Point
-		tex       driver.Texture
-	}
-	// materials contains the pre-processed materials (transformed images for
-	// now, gradients etc. later) packed in a texture atlas. The atlas is used
-	// as source in kernel4.
+	// images contains ImageOp images packed into a texture atlas, shared
+	// with the other renderers of shared.
+	images *imageAtlas
+	// materials contains the pre-processed materials (transformed images)
+	// packed in a texture atlas. The atlas is used as source in kernel4.
+	// Linear gradients are evaluated by kernel4 directly.
 	materials struct {
-		// offsets maps texture ops to the offsets to put in their FillImage commands.
-		offsets map[textureKey]image.Point
+		// places maps texture ops to their places in the atlas.
+		places map[textureKey]materialPlace
+		// freed are the places of invalidated materials, to clear before
+		// they are reused.
+		freed []image.Rectangle
 
 		prog   driver.Program
 		layout driver.InputLayout
@@ -75,6 +97,8 @@ type compute struct {
 		tex   driver.Texture
 		fbo   driver.Framebuffer
 		quads []materialVertex
+		// pageQuads are the quads of each image atlas page.
+		pageQuads [][]materialVertex
 
 		buffer sizedBuffer
 
@@ -82,7 +106,9 @@ type compute struct {
 		uniBuf   driver.Buffer
 	}
 	timers struct {
-		profile         string
+		profile string
+		// frame is the profile of the most recent frame.
+		frame           profile.Frame
 		t               *timers
 		materials       *timer
 		elements        *timer
@@ -94,6 +120,50 @@ type compute struct {
 		blit            *timer
 	}
 
+	// mem tracks the dynamic allocations of the kernels.
+	mem struct {
+		// highWater is the decaying maximum of the size of the dynamic
+		// allocations.
+		highWater int
+		// retries is the number of pipeline runs of the most recent frame
+		// that failed for lack of memory.
+		retries int
+	}
+
+	// readbacks holds copies of the memory headers of recent frames,
+	// checked once the GPU completes them instead of stalling the frame
+	// that produced them.
+	readbacks struct {
+		pending []readback
+		free    []readback
+		// verified is set when the most recent frame checked synchronously
+		// succeeded. Frames that fit within its output size and allocation
+		// estimate are checked asynchronously.
+		verified bool
+		tileDims image.Point
+		estimate allocEstimate
+		// failed is set when an asynchronously checked frame turned out
+		// incomplete after it was presented.
+		failed bool
+	}
+
+	// estimate is the allocation estimate of the current frame.
+	estimate allocEstimate
+	// padding is the number of padding commands at the end of the scene.
+	padding int
+	// imageChanges are the changes to images since the previous frame.
+	imageChanges []imageChange
+	// imageVersions and prevImageVersions are the versions of the mutable
+	// images of the current and the previous frame.
+	imageVersions, prevImageVersions map[interface{}]int
+	// cleared records whether the most recent frame cleared the
+	// framebuffer, for rendering it again.
+	cleared bool
+
+	// damage tracks the changes between frames, to limit rendering to the
+	// output tiles that changed.
+	damage damageState
+
 	// The following fields hold scratch space to avoid garbage.
 	zeroSlice []byte
 	memHeader *memoryHeader
@@ -112,12 +182,64 @@ type materialVertex struct {
 	u, v       float32
 }
 
+// damageState tracks the changes between frames.
+type damageState struct {
+	hash maphash.Hash
+	// ops and prevOps are the encoded operations of the current and
+	// previous frame.
+	ops, prevOps []opDamage
+	// first and next chain the previous operations with equal hashes,
+	// in order, for matching them to the current operations.
+	first map[uint64]int
+	next  []int
+	// matched marks the previous operations kept by the current
+	// frame.
+	matched []bool
+	// header and prevHeader are the hashes of the commands that precede
+	// the operations.
+	header, prevHeader uint64
+	viewport           image.Point
+	// rect is the changed region of the current frame.
+	rect image.Rectangle
+	// valid is set when the output contains the previous frame.
+	valid bool
+	// presented is the region of the output rendered by the most
+	// recent Frame.
+	presented image.Rectangle
+}
+
+// opDamage describes an encoded operation for damage tracking.
+type opDamage struct {
+	// hash is the hash of the operation's scene commands.
+	hash   uint64
+	bounds image.Rectangle
+	// tex identifies the image of texture operations. Image fill
+	// commands are encoded before their material is placed.
+	tex textureKey
+	// imgTrans maps the image of texture operations to the viewport.
+	imgTrans f32.Affine2D
+}
+
 // textureKey identifies textureOp.
 type textureKey struct {
 	handle    interface{}
 	transform f32.Affine2D
 }
 
+// imageChange is a changed region of an image.
+type imageChange struct {
+	handle interface{}
+	rect   image.Rectangle
+}
+
+// materialPlace is the place of a material in the material atlas.
+type materialPlace struct {
+	// offset is the offset to put in FillImage commands.
+	offset image.Point
+	// rect is the space occupied by the material.
+	rect image.Rectangle
+}
+
 // textureOp represents an imageOp that requires texture space.
 type textureOp struct {
 	// sceneIdx is the index in the scene that contains the fill image command
@@ -126,8 +248,19 @@ type textureOp struct {
 	key      textureKey
 	img      imageOpData
 
-	// pos is the position of the untransformed image in the images texture.
-	pos image.Point
+	// page and pos are the page and position of the untransformed image
+	// in the image atlas.
+	page int
+	pos  image.Point
+}
+
+// gradientOp represents an imageOp filled with a linear gradient.
+type gradientOp struct {
+	// sceneIdx is the index in the scene of the gradient command.
+	sceneIdx int
+	// line is the gradient line in viewport coordinates, in the form
+	// described by scene.LinearGradient.
+	line [3]float32
 }
 
 type encoder struct {
@@ -142,6 +275,35 @@ type encodeState struct {
 	clip  f32.Rectangle
 }
 
+// allocEstimate summarizes the inputs that determine the dynamic
+// allocations of the kernels. A frame whose estimate is within that of a
+// frame that fit in memory is unlikely to run out.
+type allocEstimate struct {
+	npath, npathseg int
+	// nclip is the number of clip paths.
+	nclip int
+	// tiles is the number of tiles covered by the bounds of every path,
+	// which determines the tile and command list allocations.
+	tiles int
+	// segTiles bounds the number of tiles crossed by the path segments,
+	// which determines the tile segment allocations.
+	segTiles int
+}
+
+// within reports whether every count of e is at most that of o.
+func (e allocEstimate) within(o allocEstimate) bool {
+	return e.npath <= o.npath && e.npathseg <= o.npathseg && e.nclip <= o.nclip &&
+		e.tiles <= o.tiles && e.segTiles <= o.segTiles
+}
+
+// readback is a copy of the memory header of a frame in flight.
+type readback struct {
+	buf   driver.Buffer
+	fence driver.Fence
+	// alloc is the size of the static allocations of the frame.
+	alloc uint32
+}
+
 type sizedBuffer struct {
 	size   int
 	buffer driver.Buffer
@@ -181,6 +343,13 @@ const (
 	kernel4OutputUnit = 2
 	kernel4AtlasUnit  = 3
 
+	// binWidthTiles and binHeightTiles match N_TILE_X and N_TILE_Y in setup.h.
+	binWidthTiles  = 16
+	binHeightTiles = 8
+	// maxBins is the number of bins handled by a single dispatch of the
+	// binning and coarse stages. It matches N_TILE in setup.h.
+	maxBins = binWidthTiles * binHeightTiles
+
 	pathSize    = 12
 	binSize     = 8
 	pathsegSize = 52
@@ -190,26 +359,54 @@ const (
 	stateStride = 4 + 2*stateSize
 )
 
+// Memory sizing constants.
+const (
+	// memMinDynamic is the minimum size of the memory for dynamic
+	// allocations.
+	memMinDynamic = 4 * 1024 * 1024
+	// memDecay is the reciprocal of the rate at which the memory high-water
+	// mark decays each frame.
+	memDecay = 128
+	// maxReadbacks is the number of frames whose memory headers may be
+	// in flight before waiting for the oldest.
+	maxReadbacks = 2
+)
+
 // mem.h constants.
 const (
 	memNoError      = 0 // NO_ERROR
 	memMallocFailed = 1 // ERR_MALLOC_FAILED
 )
 
-func newCompute(ctx driver.Device) (*compute, error) {
+func newCompute(ctx driver.Device, shared *Shared) (*compute, error) {
 	maxDim := ctx.Caps().MaxTextureSize
 	// Large atlas textures cause artifacts due to precision loss in
 	// shaders.
 	if cap := 8192; maxDim > cap {
 		maxDim = cap
 	}
+	pageDim := imagePageDim
+	if pageDim > maxDim {
+		pageDim = maxDim
+	}
 	g := &compute{
 		ctx:           ctx,
-		cache:         newResourceCache(),
+		shared:        shared,
 		maxTextureDim: maxDim,
+		imagePageDim:  pageDim,
 		conf:          new(config),
 		memHeader:     new(memoryHeader),
 	}
+	shared.join()
+	if shared != nil {
+		g.cache = shared.cache
+		g.drawOps.pathCache = shared.paths
+		g.images = shared.images
+	} else {
+		g.cache = newResourceCache()
+		g.drawOps.pathCache = newOpCache()
+		g.images = new(imageAtlas)
+	}
 
 	blitProg, err := ctx.NewProgram(shader_copy_vert, shader_copy_frag)
 	if err != nil {
@@ -243,7 +440,6 @@ func newCompute(ctx driver.Device) (*compute, error) {
 	g.materials.uniBuf = buf
 	g.materials.prog.SetVertexUniforms(buf)
 
-	g.drawOps.pathCache = newOpCache()
 	g.drawOps.compute = true
 
 	buf, err = ctx.NewBuffer(driver.BufferBindingShaderStorage, int(unsafe.Sizeof(config{})))
@@ -277,12 +473,31 @@ func newCompute(ctx driver.Device) (*compute, error) {
 }
 
 func (g *compute) Collect(viewport image.Point, ops *op.Ops) {
+	p := &g.timers.frame
+	start := time.Now()
 	g.drawOps.reset(g.cache, viewport)
 	g.drawOps.collect(g.ctx, g.cache, ops, viewport)
 	for _, img := range g.drawOps.allImageOps {
 		expandPathOp(img.path, img.clip)
 	}
+	g.imageChanges = g.imageChanges[:0]
+	g.imageVersions, g.prevImageVersions = g.prevImageVersions, g.imageVersions
+	if g.imageVersions == nil {
+		g.imageVersions = make(map[interface{}]int)
+	}
+	for h := range g.imageVersions {
+		delete(g.imageVersions, h)
+	}
+	for _, m := range g.drawOps.mutableImages {
+		g.updateImage(m.handle)
+	}
+	encStart := time.Now()
 	g.encode(viewport)
+	p.Collect = encStart.Sub(start)
+	p.Encode = time.Since(encStart)
+	p.UploadBytes = 0
+	p.Elements = len(g.enc.scene)
+	p.PathSegments = g.enc.npathseg
 }
 
 func (g *compute) Clear(col color.NRGBA) {
@@ -291,6 +506,15 @@ func (g *compute) Clear(col color.NRGBA) {
 }
 
 func (g *compute) Frame() error {
+	g.cleared = g.drawOps.clear
+	err := g.frame(true)
+	g.drawOps.clear = false
+	return err
+}
+
+// frame renders the encoded scene. Caches are trimmed only if trim is
+// set, because a frame rendered again uses nothing new.
+func (g *compute) frame(trim bool) error {
 	viewport := g.drawOps.viewport
 	tileDims := image.Point{
 		X: (viewport.X + tileWidthPx - 1) / tileWidthPx,
@@ -327,8 +551,11 @@ func (g *compute) Frame() error {
 	}
 	g.ctx.BindFramebuffer(defFBO)
 	g.blitOutput(viewport)
-	g.cache.frame()
-	g.drawOps.pathCache.frame()
+	if trim {
+		keep := g.shared.keep()
+		g.cache.frame(keep)
+		g.drawOps.pathCache.frame(keep)
+	}
 	t := &g.timers
 	if g.drawOps.profile && t.t.ready() {
 		mat := t.materials.Elapsed
@@ -342,16 +569,67 @@ func (g *compute) Frame() error {
 		et, tat, pct, bbt = et.Round(q), tat.Round(q), pct.Round(q), bbt.Round(q)
 		ct, k4t = ct.Round(q), k4t.Round(q)
 		blit = blit.Round(q)
-		t.profile = fmt.Sprintf("ft:%7s mat: %7s et:%7s tat:%7s pct:%7s bbt:%7s ct:%7s k4t:%7s blit:%7s", ft, mat, et, tat, pct, bbt, ct, k4t, blit)
-	}
-	g.drawOps.clear = false
+		t.profile = fmt.Sprintf("ft:%7s mat: %7s et:%7s tat:%7s pct:%7s bbt:%7s ct:%7s k4t:%7s blit:%7s retries:%d", ft, mat, et, tat, pct, bbt, ct, k4t, blit, g.mem.retries)
+		t.frame.Stages = append(t.frame.Stages[:0],
+			profile.Stage{Name: "materials", Duration: t.materials.Elapsed},
+			profile.Stage{Name: "elements", Duration: t.elements.Elapsed},
+			profile.Stage{Name: "tileAlloc", Duration: t.tileAlloc.Elapsed},
+			profile.Stage{Name: "pathCoarse", Duration: t.pathCoarse.Elapsed},
+			profile.Stage{Name: "backdropBinning", Duration: t.backdropBinning.Elapsed},
+			profile.Stage{Name: "coarse", Duration: t.coarse.Elapsed},
+			profile.Stage{Name: "kernel4", Duration: t.kernel4.Elapsed},
+			profile.Stage{Name: "blit", Duration: t.blit.Elapsed},
+		)
+	}
+	p := &t.frame
+	iu, is := g.images.packer.usage()
+	mu, ms := g.materials.packer.usage()
+	p.AtlasUsed, p.AtlasSize = iu+mu, is+ms
+	p.MemorySize = g.buffers.memory.size
+	p.MemoryRetries = g.mem.retries
 	return nil
 }
 
+func (g *compute) Pending() bool {
+	return len(g.readbacks.pending) > 0
+}
+
+func (g *compute) Verify(wait bool) (bool, error) {
+	// The device is usable between BeginFrame and EndFrame only. Nothing is
+	// drawn, so the framebuffer is left as is.
+	g.ctx.BeginFrame(false, image.Point{})
+	err := g.pollReadbacks(wait)
+	g.ctx.EndFrame()
+	if err != nil {
+		return false, err
+	}
+	r := &g.readbacks
+	if !r.failed {
+		return false, nil
+	}
+	r.failed = false
+	// Render the most recent frame again, in full and with its memory use
+	// checked synchronously. Partial frames leave the scene translated to
+	// their last region.
+	g.translateScene(image.Point{})
+	g.drawOps.clear = g.cleared
+	err = g.frame(false)
+	g.drawOps.clear = false
+	return err == nil, err
+}
+
 func (g *compute) Profile() string {
 	return g.timers.profile
 }
 
+func (g *compute) FrameProfile() profile.Frame {
+	return g.timers.frame
+}
+
+func (g *compute) Damage() image.Rectangle {
+	return g.damage.presented
+}
+
 // blitOutput copies the compute render output to the output FBO. We need to
 // copy because compute shaders can only write to textures, not FBOs. Compute
 // shader can only write to RGBA textures, but since we actually render in sRGB
@@ -373,28 +651,145 @@ func (g *compute) blitOutput(viewport image.Point) {
 
 func (g *compute) encode(viewport image.Point) {
 	g.texOps = g.texOps[:0]
+	g.gradOps = g.gradOps[:0]
 	g.enc.reset()
+	g.padding = 0
+	g.estimate = allocEstimate{}
 
-	// Flip Y-axis.
-	flipY := f32.Affine2D{}.Scale(f32.Pt(0, 0), f32.Pt(1, -1)).Offset(f32.Pt(0, float32(viewport.Y)))
-	g.enc.transform(flipY)
+	root := flipY(viewport)
+	g.enc.transform(root)
 	if g.drawOps.clear {
 		g.enc.rect(f32.Rectangle{Max: layout.FPt(viewport)})
 		g.enc.fillColor(f32color.NRGBAToRGBA(g.drawOps.clearColor.SRGB()))
 	}
-	g.encodeOps(flipY, viewport, g.drawOps.allImageOps)
+	g.damage.header = g.hashScene(0)
+	g.buffers.segments = append(g.buffers.segments[:0], sceneSegment{
+		key: g.damage.header,
+		end: len(g.enc.scene),
+	})
+	g.encodeOps(root, viewport, g.drawOps.allImageOps)
+	g.estimate.npath, g.estimate.npathseg = g.enc.npath, g.enc.npathseg
+	g.updateDamage(viewport)
+}
+
+// hashScene returns the hash of the encoded scene commands from start.
+func (g *compute) hashScene(start int) uint64 {
+	h := &g.damage.hash
+	h.Reset()
+	if cmds := g.enc.scene[start:]; len(cmds) > 0 {
+		h.Write(byteslice.Slice(cmds))
+	}
+	return h.Sum64()
+}
+
+// updateDamage computes the region changed since the previous frame from
+// the bounds of the operations that differ. Operations are matched by hash
+// in order, so that inserted and removed operations damage only their own
+// bounds. Changes to images damage the operations that draw them.
+func (g *compute) updateDamage(viewport image.Point) {
+	d := &g.damage
+	full := image.Rectangle{Max: viewport}
+	if viewport != d.viewport || d.header != d.prevHeader {
+		d.rect = full
+	} else {
+		d.rect = d.diffOps().Union(g.imageDamage()).Intersect(full)
+	}
+	d.viewport = viewport
+	d.prevHeader = d.header
+	d.ops, d.prevOps = d.prevOps[:0], d.ops
+}
+
+// diffOps returns the union of the bounds of the operations of either frame
+// without a match in the other frame. The matched operations are in the
+// same order in both frames, so their blending is unchanged.
+func (d *damageState) diffOps() image.Rectangle {
+	if d.first == nil {
+		d.first = make(map[uint64]int)
+	}
+	for k := range d.first {
+		delete(d.first, k)
+	}
+	n := len(d.prevOps)
+	if cap(d.next) < n {
+		d.next = make([]int, n)
+		d.matched = make([]bool, n)
+	}
+	d.next, d.matched = d.next[:n], d.matched[:n]
+	for i := n - 1; i >= 0; i-- {
+		h := d.prevOps[i].hash
+		d.next[i] = -1
+		if j, ok := d.first[h]; ok {
+			d.next[i] = j
+		}
+		d.first[h] = i
+		d.matched[i] = false
+	}
+	var r image.Rectangle
+	// last is the most recent match. Matching only later operations
+	// preserves the order of the unchanged operations.
+	last := -1
+	for _, op := range d.ops {
+		i, ok := d.first[op.hash]
+		for ok && i != -1 && i <= last {
+			i = d.next[i]
+		}
+		if !ok || i == -1 || d.prevOps[i] != op {
+			r = r.Union(op.bounds)
+			continue
+		}
+		d.first[op.hash] = d.next[i]
+		d.matched[i] = true
+		last = i
+	}
+	for i, op := range d.prevOps {
+		if !d.matched[i] {
+			r = r.Union(op.bounds)
+		}
+	}
+	return r
+}
+
+// imageDamage returns the region of the viewport covered by the changed
+// parts of images.
+func (g *compute) imageDamage() image.Rectangle {
+	var r image.Rectangle
+	if len(g.imageChanges) == 0 {
+		return r
+	}
+	for _, op := range g.damage.ops {
+		if op.tex.handle == nil {
+			continue
+		}
+		for _, c := range g.imageChanges {
+			if c.handle != op.tex.handle {
+				continue
+			}
+			b := boundRectF(transformBounds(layout.FRect(c.rect), op.imgTrans))
+			// Include the pixels that filtering blends with the change.
+			b = b.Inset(-1)
+			r = r.Union(b.Intersect(op.bounds))
+		}
+	}
+	return r
+}
+
+// flipY returns the transformation that flips the Y-axis of the viewport.
+func flipY(viewport image.Point) f32.Affine2D {
+	return f32.Affine2D{}.Scale(f32.Pt(0, 0), f32.Pt(1, -1)).Offset(f32.Pt(0, float32(viewport.Y)))
 }
 
 func (g *compute) renderMaterials() error {
 	m := &g.materials
-	m.quads = m.quads[:0]
 	resize := false
 	reclaimed := false
 restart:
 	for {
+		for i := range m.pageQuads {
+			m.pageQuads[i] = m.pageQuads[i][:0]
+		}
 		for _, op := range g.texOps {
-			if off, exists := m.offsets[op.key]; exists {
-				g.enc.setFillImageOffset(op.sceneIdx, off)
+			if place, exists := m.places[op.key]; exists {
+				g.enc.setFillImageOffset(op.sceneIdx, place.offset)
 				continue
 			}
 			quad, bounds := g.materialQuad(op.key.transform, op.img, op.pos)
@@ -404,8 +799,10 @@ restart:
 			size := bounds.Size().Add(image.Pt(1, 1))
 			place, fits := m.packer.tryAdd(size)
 			if !fits {
-				m.offsets = nil
-				m.quads = m.quads[:0]
+				for k := range m.places {
+					delete(m.places, k)
+				}
+				m.freed = m.freed[:0]
 				m.packer.clear()
 				if !reclaimed {
 					// Some images may no longer be in use, try again
@@ -428,16 +825,27 @@ restart:
 				quad[i].posX += offsetf.X
 				quad[i].posY += offsetf.Y
 			}
-			// Draw quad as two triangles.
-			m.quads = append(m.quads, quad[0], quad[1], quad[3], quad[3], quad[1], quad[2])
-			if m.offsets == nil {
-				m.offsets = make(map[textureKey]image.Point)
+			// Draw quad as two triangles, with the quads of the same
+			// image atlas page.
+			for len(m.pageQuads) <= op.page {
+				m.pageQuads = append(m.pageQuads, nil)
+			}
+			m.pageQuads[op.page] = append(m.pageQuads[op.page], quad[0], quad[1], quad[3], quad[3], quad[1], quad[2])
+			if m.places == nil {
+				m.places = make(map[textureKey]materialPlace)
+			}
+			m.places[op.key] = materialPlace{
+				offset: offset,
+				rect:   image.Rectangle{Min: place.Pos, Max: place.Pos.Add(size)},
 			}
-			m.offsets[op.key] = offset
 			g.enc.setFillImageOffset(op.sceneIdx, offset)
 		}
 		break
 	}
+	m.quads = m.quads[:0]
+	for _, q := range m.pageQuads {
+		m.quads = append(m.quads, q...)
+	}
 	if len(m.quads) == 0 {
 		return nil
 	}
@@ -464,15 +872,21 @@ restart:
 		}
 		m.fbo = fbo
 	}
+	// Clear the space of invalidated materials, which new materials may
+	// not cover completely.
+	for _, r := range m.freed {
+		m.tex.Upload(r.Min, r.Size(), g.zeros(r.Dx()*r.Dy()*4))
+	}
+	m.freed = m.freed[:0]
 	// Transform to clip space: [-1, -1] - [1, 1].
 	g.materials.uniforms.scale = [2]float32{2 / float32(texSize), 2 / float32(texSize)}
 	g.materials.uniforms.pos = [2]float32{-1, -1}
 	g.materials.uniBuf.Upload(byteslice.Struct(g.materials.uniforms))
 	vertexData := byteslice.Slice(m.quads)
+	g.timers.frame.UploadBytes += len(vertexData)
 	n := pow2Ceil(len(vertexData))
 	m.buffer.ensureCapacity(g.ctx, driver.BufferBindingVertices, n)
 	m.buffer.buffer.Upload(vertexData)
-	g.ctx.BindTexture(0, g.images.tex)
 	g.ctx.BindFramebuffer(m.fbo)
 	g.ctx.Viewport(0, 0, texSize, texSize)
 	if reclaimed {
@@ -481,88 +895,100 @@ restart:
 	g.ctx.BindProgram(m.prog)
 	g.ctx.BindVertexBuffer(m.buffer.buffer, int(unsafe.Sizeof(m.quads[0])), 0)
 	g.ctx.BindInputLayout(m.layout)
-	g.ctx.DrawArrays(driver.DrawModeTriangles, 0, len(m.quads))
+	off := 0
+	for page, q := range m.pageQuads {
+		if len(q) == 0 {
+			continue
+		}
+		g.ctx.BindTexture(0, g.images.textures[page])
+		g.ctx.DrawArrays(driver.DrawModeTriangles, off, len(q))
+		off += len(q)
+	}
 	return nil
 }
 
 func (g *compute) uploadImages() error {
-	// padding is the number of pixels added to the right and below
-	// images, to avoid atlas filtering artifacts.
-	const padding = 1
-
-	a := &g.images
-	var uploads map[interface{}]*image.RGBA
-	resize := false
-	reclaimed := false
-restart:
-	for {
-		for i, op := range g.texOps {
-			if pos, exists := a.positions[op.img.handle]; exists {
-				g.texOps[i].pos = pos
-				continue
-			}
-			size := op.img.src.Bounds().Size().Add(image.Pt(padding, padding))
-			place, fits := a.packer.tryAdd(size)
-			if !fits {
-				a.positions = nil
-				uploads = nil
-				a.packer.clear()
-				if !reclaimed {
-					// Some images may no longer be in use, try again
-					// after clearing existing maps.
-					reclaimed = true
-				} else {
-					a.packer.maxDim += 256
-					resize = true
-					if a.packer.maxDim > g.maxTextureDim {
-						return errors.New("compute: no space left in image atlas")
-					}
-				}
-				a.packer.newPage()
-				continue restart
-			}
-			if a.positions == nil {
-				a.positions = make(map[interface{}]image.Point)
-			}
-			a.positions[op.img.handle] = place.Pos
-			g.texOps[i].pos = place.Pos
-			if uploads == nil {
-				uploads = make(map[interface{}]*image.RGBA)
-			}
-			uploads[op.img.handle] = op.img.src
+	a := g.images
+	resized, err := a.place(g.texOps, g.imagePageDim, g.maxTextureDim)
+	if err != nil {
+		return err
+	}
+	if resized {
+		for _, t := range a.textures {
+			t.Release()
 		}
-		break
+		a.textures = a.textures[:0]
 	}
-	if len(uploads) == 0 {
-		return nil
+	for n := len(a.packer.pages); len(a.textures) > n; {
+		last := len(a.textures) - 1
+		a.textures[last].Release()
+		a.textures = a.textures[:last]
 	}
-	if resize {
-		if a.tex != nil {
-			a.tex.Release()
-			a.tex = nil
-		}
+	for len(a.textures) < len(a.packer.pages) {
 		sz := a.packer.maxDim
 		handle, err := g.ctx.NewTexture(driver.TextureFormatSRGB, sz, sz, driver.FilterLinear, driver.FilterLinear, driver.BufferBindingTexture)
 		if err != nil {
 			return fmt.Errorf("compute: failed to create image atlas: %v", err)
 		}
-		a.tex = handle
-	}
-	for h, img := range uploads {
-		pos, ok := a.positions[h]
-		if !ok {
-			panic("compute: internal error: image not placed")
-		}
+		a.textures = append(a.textures, handle)
+	}
+	for _, img := range a.updates {
+		sub := img.src.SubImage(img.dirty).(*image.RGBA)
+		driver.UploadImage(a.textures[img.page], img.rect.Min.Add(img.dirty.Min), sub)
+		g.timers.frame.UploadBytes += img.dirty.Dx() * img.dirty.Dy() * 4
+		img.dirty = image.Rectangle{}
+	}
+	for _, placed := range a.uploads {
+		tex := a.textures[placed.page]
+		img := placed.src
+		pos := placed.rect.Min
 		size := img.Bounds().Size()
-		driver.UploadImage(a.tex, pos, img)
-		rightPadding := image.Pt(padding, size.Y)
-		a.tex.Upload(image.Pt(pos.X+size.X, pos.Y), rightPadding, g.zeros(rightPadding.X*rightPadding.Y*4))
-		bottomPadding := image.Pt(size.X, padding)
-		a.tex.Upload(image.Pt(pos.X, pos.Y+size.Y), bottomPadding, g.zeros(bottomPadding.X*bottomPadding.Y*4))
+		driver.UploadImage(tex, pos, img)
+		g.timers.frame.UploadBytes += len(img.Pix)
+		rightPadding := image.Pt(atlasPadding, size.Y)
+		tex.Upload(image.Pt(pos.X+size.X, pos.Y), rightPadding, g.zeros(rightPadding.X*rightPadding.Y*4))
+		bottomPadding := image.Pt(size.X, atlasPadding)
+		tex.Upload(image.Pt(pos.X, pos.Y+size.Y), bottomPadding, g.zeros(bottomPadding.X*bottomPadding.Y*4))
 	}
 	return nil
 }
 
+// updateImage brings the atlas copy of a mutable image up to date. A
+// changed image keeps its place in the atlas. If the image changed since
+// the previous frame, the materials derived from it are rendered again.
+// The renderer tracks the versions it drew apart from the atlas, which may
+// be shared with other renderers.
+func (g *compute) updateImage(m mutableImage) {
+	a := g.images
+	v := m.Version()
+	if a.versions == nil {
+		a.versions = make(map[interface{}]int)
+	}
+	a.versions[m] = v
+	if img, exists := a.positions[m]; exists {
+		img.dirty = img.dirty.Union(m.Changes(img.version))
+		img.version = v
+	}
+	g.imageVersions[m] = v
+	prev, drawn := g.prevImageVersions[m]
+	if drawn && prev == v {
+		return
+	}
+	// The operations that draw an image not drawn by the previous frame
+	// are damaged already.
+	if drawn {
+		g.imageChanges = append(g.imageChanges, imageChange{handle: m, rect: m.Changes(prev)})
+	}
+	mat := &g.materials
+	for k, p := range mat.places {
+		if k.handle == interface{}(m) {
+			delete(mat.places, k)
+			mat.packer.free(0, p.rect)
+			mat.freed = append(mat.freed, p.rect)
+		}
+	}
+}
+
 func pow2Ceil(v int) int {
 	exp := bits.Len(uint(v))
 	if bits.OnesCount(uint(v)) == 1 {
@@ -636,31 +1062,52 @@ func min(p1, p2 f32.Point) f32.Point {
 }
 
 func (g *compute) encodeOps(trans f32.Affine2D, viewport image.Point, ops []imageOp) {
+	viewTiles := tileCount(image.Rectangle{Max: viewport})
 	for _, op := range ops {
+		start := len(g.enc.scene)
+		nseg := g.enc.npathseg
 		bounds := layout.FRect(op.clip)
 		// clip is the union of all drawing affected by the clipping
 		// operation. TODO: tighten.
 		clip := f32.Rect(0, 0, float32(viewport.X), float32(viewport.Y))
 		nclips := g.encodeClipStack(clip, bounds, op.path, false)
+		// Clip paths cover clip, the operation covers its bounds.
+		e := &g.estimate
+		e.nclip += nclips
+		e.tiles += tileCount(op.clip) + nclips*viewTiles
+		// A segment within the bounds crosses at most a row and a column
+		// of tiles.
+		crossings := op.clip.Dx()/tileWidthPx + op.clip.Dy()/tileHeightPx + 2
+		e.segTiles += (g.enc.npathseg - nseg) * crossings
 		m := op.material
+		var tex textureKey
+		var imgTrans f32.Affine2D
 		switch m.material {
 		case materialTexture:
+			imgTrans = m.trans
 			t := trans.Mul(m.trans)
+			tex = textureKey{
+				transform: t,
+				handle:    m.data.handle,
+			}
 			g.texOps = append(g.texOps, textureOp{
 				sceneIdx: len(g.enc.scene),
 				img:      m.data,
-				key: textureKey{
-					transform: t,
-					handle:    m.data.handle,
-				},
+				key:      tex,
 			})
 			// Add fill command, its offset is resolved and filled in renderMaterials.
 			g.enc.fillImage(0)
 		case materialColor:
 			g.enc.fillColor(f32color.NRGBAToRGBA(op.material.color.SRGB()))
 		case materialLinearGradient:
-			// TODO: implement.
-			g.enc.fillColor(f32color.NRGBAToRGBA(op.material.color1.SRGB()))
+			line := gradientLine(m.uvTrans, op.clip)
+			g.gradOps = append(g.gradOps, gradientOp{
+				sceneIdx: len(g.enc.scene),
+				line:     line,
+			})
+			col1 := f32color.NRGBAToRGBA(m.color1.SRGB())
+			col2 := f32color.NRGBAToRGBA(m.color2.SRGB())
+			g.enc.linearGradient(outputGradientLine(line, viewport, image.Point{}), col1, col2)
 		default:
 			panic("not implemented")
 		}
@@ -672,9 +1119,49 @@ func (g *compute) encodeOps(trans f32.Affine2D, viewport image.Point, ops []imag
 		for i := 0; i < nclips; i++ {
 			g.enc.endClip(clip)
 		}
+		hash := g.hashScene(start)
+		g.damage.ops = append(g.damage.ops, opDamage{
+			hash:     hash,
+			bounds:   op.clip,
+			tex:      tex,
+			imgTrans: imgTrans,
+		})
+		g.buffers.segments = append(g.buffers.segments, sceneSegment{
+			key:   hash,
+			start: start,
+			end:   len(g.enc.scene),
+		})
 	}
 }
 
+// tileCount returns the number of tiles that a rectangle may overlap.
+func tileCount(r image.Rectangle) int {
+	w := (r.Dx()+tileWidthPx-1)/tileWidthPx + 1
+	h := (r.Dy()+tileHeightPx-1)/tileHeightPx + 1
+	return w * h
+}
+
+// gradientLine returns the line that maps viewport coordinates to the
+// gradient position of uvTrans, as set up by gradientSpaceTransform for the
+// unit square covering clip.
+func gradientLine(uvTrans f32.Affine2D, clip image.Rectangle) [3]float32 {
+	sx, hx, ox, _, _, _ := uvTrans.Elems()
+	a := sx / float32(clip.Dx())
+	b := hx / float32(clip.Dy())
+	c := ox - a*float32(clip.Min.X) - b*float32(clip.Min.Y)
+	return [3]float32{a, b, c}
+}
+
+// outputGradientLine transforms a gradient line in viewport coordinates to
+// the pixel coordinates of the output region at origin. The output is
+// flipped vertically, see flipY, and the line is evaluated at pixel centers.
+func outputGradientLine(line [3]float32, viewport, origin image.Point) [3]float32 {
+	a, b, c := line[0], line[1], line[2]
+	x0 := float32(origin.X) + .5
+	y0 := float32(viewport.Y-origin.Y) - .5
+	return [3]float32{a, -b, a*x0 + b*y0 + c}
+}
+
 // encodeClips encodes a stack of clip paths and return the stack depth.
 func (g *compute) encodeClipStack(clip, bounds f32.Rectangle, p *pathOp, begin bool) int {
 	nclips := 0
@@ -682,7 +1169,7 @@ func (g *compute) encodeClipStack(clip, bounds f32.Rectangle, p *pathOp, begin b
 		nclips += g.encodeClipStack(clip, bounds, p.parent, true)
 		nclips += 1
 	}
-	isStroke := p.stroke.Width > 0
+	isStroke := p != nil && p.stroke.Width > 0
 	if p != nil && p.path {
 		if isStroke {
 			g.enc.fillMode(scene.FillModeStroke)
@@ -719,39 +1206,166 @@ func encodePath(verts []byte) encoder {
 
 func (g *compute) render(tileDims image.Point) error {
 	const (
-		// wgSize is the largest and most common workgroup size.
-		wgSize = 128
 		// PARTITION_SIZE from elements.comp
 		partitionSize = 32 * 4
 	)
-	widthInBins := (tileDims.X + 15) / 16
-	heightInBins := (tileDims.Y + 7) / 8
-	if widthInBins*heightInBins > wgSize {
-		return fmt.Errorf("gpu: output too large (%dx%d)", tileDims.X*tileWidthPx, tileDims.Y*tileHeightPx)
+
+	g.mem.retries = 0
+	g.mem.highWater -= g.mem.highWater / memDecay
+	if err := g.pollReadbacks(false); err != nil {
+		return err
+	}
+	// This frame replaces any incomplete frame.
+	g.readbacks.failed = false
+
+	// Pad scene with zeroes to avoid reading garbage in elements.comp. A
+	// frame rendered again is padded already.
+	g.enc.scene = g.enc.scene[:len(g.enc.scene)-g.padding]
+	g.padding = partitionSize - len(g.enc.scene)%partitionSize
+	g.enc.scene = append(g.enc.scene, make([]scene.Command, g.padding)...)
+
+	d := &g.damage
+	damage := d.rect
+	if !d.valid {
+		damage = image.Rectangle{Max: g.drawOps.viewport}
+	}
+	// The output is only known to be valid after a successful render.
+	d.valid = false
+	d.presented = image.Rectangle{}
+	w, h := tileDims.X*tileWidthPx, tileDims.Y*tileHeightPx
+	if g.output.size.X != w || g.output.size.Y != h {
+		if err := g.resizeOutput(image.Pt(w, h)); err != nil {
+			return err
+		}
+		damage = image.Rectangle{Max: g.drawOps.viewport}
+	}
+	// Render the tiles that overlap the damage. The output is flipped
+	// vertically, see flipY.
+	vy := g.drawOps.viewport.Y
+	damage = image.Rect(damage.Min.X, vy-damage.Max.Y, damage.Max.X, vy-damage.Min.Y)
+	dirty := image.Rectangle{
+		Min: image.Pt(damage.Min.X/tileWidthPx, damage.Min.Y/tileHeightPx),
+		Max: image.Pt(
+			(damage.Max.X+tileWidthPx-1)/tileWidthPx,
+			(damage.Max.Y+tileHeightPx-1)/tileHeightPx,
+		),
+	}.Intersect(image.Rectangle{Max: tileDims})
+	if dirty.Empty() {
+		d.valid = true
+		return nil
+	}
+	d.presented = image.Rect(
+		dirty.Min.X*tileWidthPx, vy-dirty.Max.Y*tileHeightPx,
+		dirty.Max.X*tileWidthPx, vy-dirty.Min.Y*tileHeightPx,
+	).Intersect(image.Rectangle{Max: g.drawOps.viewport})
+	regionDims := binRegionDims(tileDims)
+	r := &g.readbacks
+	async := g.ctx.Caps().Features.Has(driver.FeatureFences) && r.verified &&
+		g.estimate.within(r.estimate)
+	if dirty == (image.Rectangle{Max: tileDims}) && regionDims == tileDims {
+		if err := g.renderRegion(tileDims, g.output.image, async && tileDims == r.tileDims); err != nil {
+			return err
+		}
+		d.valid = true
+		return nil
+	}
+	// Render the damaged tiles one region at a time, at most as large as what
+	// the binning and coarse stages can handle in a single pass, and copy each
+	// region to its place in the output.
+	single := dirty.Dx() <= regionDims.X && dirty.Dy() <= regionDims.Y
+	regionSize := dirty.Size()
+	if !single {
+		regionSize = regionDims
+	}
+	if err := g.ensureRegionOutput(image.Pt(regionSize.X*tileWidthPx, regionSize.Y*tileHeightPx)); err != nil {
+		return err
+	}
+	for y := dirty.Min.Y; y < dirty.Max.Y; y += regionDims.Y {
+		for x := dirty.Min.X; x < dirty.Max.X; x += regionDims.X {
+			dims := regionDims
+			if rem := dirty.Max.X - x; dims.X > rem {
+				dims.X = rem
+			}
+			if rem := dirty.Max.Y - y; dims.Y > rem {
+				dims.Y = rem
+			}
+			origin := image.Pt(x*tileWidthPx, y*tileHeightPx)
+			g.translateScene(origin)
+			// A single region can't run out of memory where the whole
+			// viewport didn't.
+			regionAsync := async && single && dims.X <= r.tileDims.X && dims.Y <= r.tileDims.Y
+			if err := g.renderRegion(dims, g.output.region.image, regionAsync); err != nil {
+				return err
+			}
+			size := image.Pt(dims.X*tileWidthPx, dims.Y*tileHeightPx)
+			g.ctx.BlitFramebuffer(g.output.fbo, g.output.region.fbo,
+				image.Rectangle{Max: size},
+				image.Rectangle{Min: origin, Max: origin.Add(size)},
+			)
+		}
+	}
+	d.valid = true
+	return nil
+}
+
+// binRegionDims returns the largest region, in tiles, that fits in a single
+// pass of the binning and coarse stages.
+func binRegionDims(tileDims image.Point) image.Point {
+	widthInBins := (tileDims.X + binWidthTiles - 1) / binWidthTiles
+	heightInBins := (tileDims.Y + binHeightTiles - 1) / binHeightTiles
+	if widthInBins*heightInBins <= maxBins {
+		return tileDims
+	}
+	if widthInBins > maxBins {
+		widthInBins = maxBins
+	}
+	heightInBins = maxBins / widthInBins
+	return image.Pt(widthInBins*binWidthTiles, heightInBins*binHeightTiles)
+}
+
+// translateScene offsets the encoded scene such that the output region at
+// origin is rendered at the output origin.
+func (g *compute) translateScene(origin image.Point) {
+	off := layout.FPt(origin)
+	// The first command is the root transform, see encode.
+	g.enc.scene[0] = scene.Transform(flipY(g.drawOps.viewport).Offset(off.Mul(-1)))
+	// Image fills sample the material atlas at the output position
+	// plus the fill offset.
+	for _, op := range g.texOps {
+		g.enc.setFillImageOffset(op.sceneIdx, g.materials.places[op.key].offset.Add(origin))
+	}
+	// Gradient lines are in output coordinates.
+	for _, op := range g.gradOps {
+		scene.SetGradientLine(&g.enc.scene[op.sceneIdx], outputGradientLine(op.line, g.drawOps.viewport, origin))
 	}
+}
 
-	// Pad scene with zeroes to avoid reading garbage in elements.comp.
-	scenePadding := partitionSize - len(g.enc.scene)%partitionSize
-	g.enc.scene = append(g.enc.scene, make([]scene.Command, scenePadding)...)
+// renderRegion runs the compute pipeline on the tileDims tiles at the scene
+// origin and stores the result in output.
+//
+// If async is set, the memory header is not waited for but queued for
+// pollReadbacks. A frame that runs out of memory is then not re-rendered,
+// but the following frames are rendered with more memory.
+func (g *compute) renderRegion(tileDims image.Point, output driver.Texture, async bool) error {
+	const (
+		// wgSize is the largest and most common workgroup size.
+		wgSize = 128
+	)
+	widthInBins := (tileDims.X + binWidthTiles - 1) / binWidthTiles
+	heightInBins := (tileDims.Y + binHeightTiles - 1) / binHeightTiles
 
 	realloced := false
-	scene := byteslice.Slice(g.enc.scene)
-	if s := len(scene); s > g.buffers.scene.size {
+	g.buffers.layout.layout(g.enc.scene, g.buffers.segments)
+	if s := g.buffers.layout.size() * 4; s > g.buffers.scene.size {
 		realloced = true
 		paddedCap := s * 11 / 10
 		if err := g.buffers.scene.ensureCapacity(g.ctx, driver.BufferBindingShaderStorage, paddedCap); err != nil {
 			return err
 		}
 	}
-	g.buffers.scene.buffer.Upload(scene)
+	g.uploadScene(realloced)
 
-	w, h := tileDims.X*tileWidthPx, tileDims.Y*tileHeightPx
-	if g.output.size.X != w || g.output.size.Y != h {
-		if err := g.resizeOutput(image.Pt(w, h)); err != nil {
-			return err
-		}
-	}
-	g.ctx.BindImageTexture(kernel4OutputUnit, g.output.image, driver.AccessWrite, driver.TextureFormatRGBA8)
+	g.ctx.BindImageTexture(kernel4OutputUnit, output, driver.AccessWrite, driver.TextureFormatRGBA8)
 	if t := g.materials.tex; t != nil {
 		g.ctx.BindImageTexture(kernel4AtlasUnit, t, driver.AccessRead, driver.TextureFormatRGBA8)
 	}
@@ -794,13 +1408,19 @@ func (g *compute) render(tileDims image.Point) error {
 
 	g.buffers.config.Upload(byteslice.Struct(g.conf))
 
+	// Size the memory buffer for the static allocations plus the dynamic
+	// allocations of recent frames, and grow it before it overflows.
 	minSize := int(unsafe.Sizeof(memoryHeader{})) + int(alloc)
-	if minSize > g.buffers.memory.size {
+	dynSize := g.mem.highWater * 3 / 2
+	if dynSize < memMinDynamic {
+		dynSize = memMinDynamic
+	}
+	size := g.buffers.memory.size
+	growSize := minSize + g.mem.highWater*5/4
+	if minSize > size || growSize > size || size > 2*(minSize+dynSize) {
 		realloced = true
-		// Add space for dynamic GPU allocations.
-		const sizeBump = 4 * 1024 * 1024
-		minSize += sizeBump
-		if err := g.buffers.memory.ensureCapacity(g.ctx, driver.BufferBindingShaderStorage, minSize); err != nil {
+		g.buffers.memory.release()
+		if err := g.buffers.memory.ensureCapacity(g.ctx, driver.BufferBindingShaderStorage, minSize+dynSize); err != nil {
 			return err
 		}
 	}
@@ -810,6 +1430,7 @@ func (g *compute) render(tileDims image.Point) error {
 		}
 		g.buffers.memory.buffer.Upload(byteslice.Struct(g.memHeader))
 		g.buffers.state.buffer.Upload(g.zeros(clearSize))
+		g.timers.frame.UploadBytes += int(unsafe.Sizeof(*g.memHeader)) + clearSize
 
 		if realloced {
 			realloced = false
@@ -851,19 +1472,32 @@ func (g *compute) render(tileDims image.Point) error {
 		g.ctx.MemoryBarrier()
 		t.kernel4.end()
 
+		if async {
+			return g.queueReadback(alloc)
+		}
 		if err := g.buffers.memory.buffer.Download(byteslice.Struct(g.memHeader)); err != nil {
 			if err == driver.ErrContentLost {
 				continue
 			}
 			return err
 		}
+		g.updateHighWater(alloc)
 		switch errCode := g.memHeader.mem_error; errCode {
 		case memNoError:
+			r := &g.readbacks
+			r.verified = true
+			r.tileDims = tileDims
+			r.estimate = g.estimate
 			return nil
 		case memMallocFailed:
-			// Resize memory and try again.
+			// Resize memory and try again. Kernels stop allocating after
+			// a failure so used is a lower bound of the required size.
+			g.mem.retries++
 			realloced = true
 			sz := g.buffers.memory.size * 15 / 10
+			if s := minSize + g.mem.highWater*3/2; s > sz {
+				sz = s
+			}
 			if err := g.buffers.memory.ensureCapacity(g.ctx, driver.BufferBindingShaderStorage, sz); err != nil {
 				return err
 			}
@@ -874,6 +1508,111 @@ func (g *compute) render(tileDims image.Point) error {
 	}
 }
 
+// updateHighWater updates the memory high-water mark from the downloaded
+// memory header of a frame with alloc bytes of static allocations.
+func (g *compute) updateHighWater(alloc uint32) {
+	// mem_offset is the sum of the static allocations and every dynamic
+	// allocation attempted by the kernels.
+	used := int(g.memHeader.mem_offset - alloc)
+	if used > g.mem.highWater {
+		g.mem.highWater = used
+	}
+}
+
+// queueReadback copies the memory header of the current frame for checking
+// by pollReadbacks once the GPU completes the frame.
+func (g *compute) queueReadback(alloc uint32) error {
+	r := &g.readbacks
+	var rb readback
+	if n := len(r.free); n > 0 {
+		rb = r.free[n-1]
+		r.free = r.free[:n-1]
+	} else {
+		buf, err := g.ctx.NewBuffer(driver.BufferBindingShaderStorage, int(unsafe.Sizeof(memoryHeader{})))
+		if err != nil {
+			return err
+		}
+		rb.buf = buf
+	}
+	g.ctx.CopyBuffer(rb.buf, g.buffers.memory.buffer, 0, 0, int(unsafe.Sizeof(memoryHeader{})))
+	rb.fence = g.ctx.NewFence()
+	rb.alloc = alloc
+	r.pending = append(r.pending, rb)
+	return nil
+}
+
+// pollReadbacks checks the memory headers of the frames completed by the
+// GPU, in order, or of every frame in flight if wait is set. If
+// maxReadbacks frames are in flight, it waits for the oldest. A frame that
+// ran out of memory raises the memory high-water mark, makes the next frame
+// wait for its own memory header and is flagged for Verify.
+func (g *compute) pollReadbacks(wait bool) error {
+	r := &g.readbacks
+	for len(r.pending) > 0 {
+		rb := r.pending[0]
+		if !wait && len(r.pending) < maxReadbacks && !rb.fence.Signaled() {
+			break
+		}
+		copy(r.pending, r.pending[1:])
+		r.pending = r.pending[:len(r.pending)-1]
+		rb.fence.Release()
+		rb.fence = nil
+		r.free = append(r.free, rb)
+		if err := rb.buf.Download(byteslice.Struct(g.memHeader)); err != nil {
+			if err == driver.ErrContentLost {
+				r.verified = false
+				continue
+			}
+			return err
+		}
+		g.updateHighWater(rb.alloc)
+		switch errCode := g.memHeader.mem_error; errCode {
+		case memNoError:
+		case memMallocFailed:
+			g.mem.retries++
+			r.verified = false
+			// The frame is incomplete; render the next frame in full.
+			g.damage.valid = false
+			r.failed = true
+		default:
+			return fmt.Errorf("compute: shader program failed with error %d", errCode)
+		}
+	}
+	return nil
+}
+
+func (g *compute) releaseReadbacks() {
+	r := &g.readbacks
+	for _, rb := range r.pending {
+		rb.fence.Release()
+		rb.buf.Release()
+	}
+	for _, rb := range r.free {
+		rb.buf.Release()
+	}
+	r.pending = nil
+	r.free = nil
+	r.verified = false
+	r.failed = false
+}
+
+// uploadScene uploads the words of the scene layout changed by its most
+// recent update to the scene buffer, or every word if full is set.
+func (g *compute) uploadScene(full bool) {
+	l := &g.buffers.layout
+	data := byteslice.Uint32(l.words[:l.size()])
+	if full {
+		g.buffers.scene.buffer.UploadRange(0, data)
+		g.timers.frame.UploadBytes += len(data)
+		return
+	}
+	for _, r := range l.dirty {
+		off, end := r.start*4, r.end*4
+		g.buffers.scene.buffer.UploadRange(off, data[off:end])
+		g.timers.frame.UploadBytes += end - off
+	}
+}
+
 // zeros returns a byte slice with size bytes of zeros.
 func (g *compute) zeros(size int) []byte {
 	if cap(g.zeroSlice) < size {
@@ -883,14 +1622,11 @@ func (g *compute) zeros(size int) []byte {
 }
 
 func (g *compute) resizeOutput(size image.Point) error {
-	if g.output.image != nil {
-		g.output.image.Release()
-		g.output.image = nil
-	}
+	g.releaseOutput()
 	img, err := g.ctx.NewTexture(driver.TextureFormatRGBA8, size.X, size.Y,
 		driver.FilterNearest,
 		driver.FilterNearest,
-		driver.BufferBindingShaderStorage|driver.BufferBindingTexture)
+		driver.BufferBindingShaderStorage|driver.BufferBindingTexture|driver.BufferBindingFramebuffer)
 	if err != nil {
 		return err
 	}
@@ -899,13 +1635,71 @@ func (g *compute) resizeOutput(size image.Point) error {
 	return nil
 }
 
-func (g *compute) Release() {
-	if g.drawOps.pathCache != nil {
-		g.drawOps.pathCache.release()
+// ensureRegionOutput prepares the region render target and the framebuffer
+// for the output image.
+func (g *compute) ensureRegionOutput(size image.Point) error {
+	if g.output.fbo == nil {
+		fbo, err := g.ctx.NewFramebuffer(g.output.image, 0)
+		if err != nil {
+			return err
+		}
+		g.output.fbo = fbo
+	}
+	r := &g.output.region
+	if r.size.X >= size.X && r.size.Y >= size.Y {
+		return nil
+	}
+	if r.size.X > size.X {
+		size.X = r.size.X
 	}
-	if g.cache != nil {
-		g.cache.release()
+	if r.size.Y > size.Y {
+		size.Y = r.size.Y
 	}
+	g.releaseRegionOutput()
+	img, err := g.ctx.NewTexture(driver.TextureFormatRGBA8, size.X, size.Y,
+		driver.FilterNearest,
+		driver.FilterNearest,
+		driver.BufferBindingShaderStorage|driver.BufferBindingFramebuffer)
+	if err != nil {
+		return err
+	}
+	fbo, err := g.ctx.NewFramebuffer(img, 0)
+	if err != nil {
+		img.Release()
+		return err
+	}
+	r.image = img
+	r.fbo = fbo
+	r.size = size
+	return nil
+}
+
+func (g *compute) releaseOutput() {
+	if g.output.fbo != nil {
+		g.output.fbo.Release()
+		g.output.fbo = nil
+	}
+	if g.output.image != nil {
+		g.output.image.Release()
+		g.output.image = nil
+	}
+	g.output.size = image.Point{}
+}
+
+func (g *compute) releaseRegionOutput() {
+	r := &g.output.region
+	if r.fbo != nil {
+		r.fbo.Release()
+	}
+	if r.image != nil {
+		r.image.Release()
+	}
+	r.fbo = nil
+	r.image = nil
+	r.size = image.Point{}
+}
+
+func (g *compute) Release() {
 	progs := []driver.Program{
 		g.programs.elements,
 		g.programs.tileAlloc,
@@ -924,17 +1718,15 @@ func (g *compute) Release() {
 		}
 	}
 	g.buffers.scene.release()
+	g.buffers.layout = sceneLayout{}
 	g.buffers.state.release()
 	g.buffers.memory.release()
+	g.releaseReadbacks()
 	if b := g.buffers.config; b != nil {
 		b.Release()
 	}
-	if g.output.image != nil {
-		g.output.image.Release()
-	}
-	if g.images.tex != nil {
-		g.images.tex.Release()
-	}
+	g.releaseOutput()
+	g.releaseRegionOutput()
 	if g.materials.layout != nil {
 		g.materials.layout.Release()
 	}
@@ -954,6 +1746,22 @@ func (g *compute) Release() {
 	if g.timers.t != nil {
 		g.timers.t.release()
 	}
+	if g.shared.leave() {
+		if g.shared != nil {
+			// Release the shared device last.
+			g.shared.release()
+		} else {
+			if g.drawOps.pathCache != nil {
+				g.drawOps.pathCache.release()
+			}
+			if g.cache != nil {
+				g.cache.release()
+			}
+			if g.images != nil {
+				g.images.release()
+			}
+		}
+	}
 
 	*g = compute{}
 }
@@ -965,7 +1773,7 @@ func (g *compute) bindBuffers() {
 	bindStorageBuffers(g.programs.backdrop, g.buffers.memory.buffer, g.buffers.config)
 	bindStorageBuffers(g.programs.binning, g.buffers.memory.buffer, g.buffers.config)
 	bindStorageBuffers(g.programs.coarse, g.buffers.memory.buffer, g.buffers.config)
-	bindStorageBuffers(g.programs.kernel4, g.buffers.memory.buffer, g.buffers.config)
+	bindStorageBuffers(g.programs.kernel4, g.buffers.memory.buffer, g.buffers.config, g.buffers.scene.buffer)
 }
 
 func (b *sizedBuffer) release() {
@@ -1066,6 +1874,11 @@ func (e *encoder) fillImage(index int) {
 	e.npath++
 }
 
+func (e *encoder) linearGradient(line [3]float32, col1, col2 color.RGBA) {
+	e.scene = append(e.scene, scene.LinearGradient(len(e.scene), line, col1, col2))
+	e.npath++
+}
+
 func (e *encoder) line(start, end f32.Point) {
 	e.scene = append(e.scene, scene.Line(start, end))
 	e.npathseg++
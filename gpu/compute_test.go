@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package gpu
+
+import (
+	"image"
+	"testing"
+
+	"gioui.org/f32"
+)
+
+// testDamageOps returns n operations with distinct hashes, in a row of
+// 10x10 squares.
+func testDamageOps(n int) []opDamage {
+	ops := make([]opDamage, n)
+	for i := range ops {
+		ops[i] = opDamage{
+			hash:   uint64(i),
+			bounds: image.Rect(i*10, 0, i*10+10, 10),
+		}
+	}
+	return ops
+}
+
+// frameDamage runs the damage tracking of a frame of ops.
+func frameDamage(g *compute, viewport image.Point, ops []opDamage, changes ...imageChange) image.Rectangle {
+	g.damage.ops = append(g.damage.ops[:0], ops...)
+	g.imageChanges = append(g.imageChanges[:0], changes...)
+	g.updateDamage(viewport)
+	return g.damage.rect
+}
+
+func TestDamageOps(t *testing.T) {
+	viewport := image.Pt(10000, 100)
+	g := new(compute)
+	ops := testDamageOps(100)
+	if r := frameDamage(g, viewport, ops); r != (image.Rectangle{Max: viewport}) {
+		t.Errorf("first frame damaged %v, expected the viewport", r)
+	}
+	if r := frameDamage(g, viewport, ops); !r.Empty() {
+		t.Errorf("unchanged frame damaged %v", r)
+	}
+	// Moving an operation damages its old and new bounds.
+	moved := append([]opDamage(nil), ops...)
+	moved[50] = opDamage{hash: 1000, bounds: image.Rect(500, 50, 510, 60)}
+	if r, exp := frameDamage(g, viewport, moved), image.Rect(500, 0, 510, 60); r != exp {
+		t.Errorf("moved operation damaged %v, expected %v", r, exp)
+	}
+	// Inserting an operation damages only its bounds.
+	ins := opDamage{hash: 2000, bounds: image.Rect(5, 20, 15, 30)}
+	inserted := append(append(append([]opDamage(nil), moved[:10]...), ins), moved[10:]...)
+	if r := frameDamage(g, viewport, inserted); r != ins.bounds {
+		t.Errorf("inserted operation damaged %v, expected %v", r, ins.bounds)
+	}
+	// And so does removing it.
+	if r := frameDamage(g, viewport, moved); r != ins.bounds {
+		t.Errorf("removed operation damaged %v, expected %v", r, ins.bounds)
+	}
+	// Swapping operations changes their blending.
+	swapped := append([]opDamage(nil), moved...)
+	swapped[20], swapped[30] = swapped[30], swapped[20]
+	r := frameDamage(g, viewport, swapped)
+	if !swapped[20].bounds.In(r) && !swapped[30].bounds.In(r) {
+		t.Errorf("swapped operations damaged %v, expected %v or %v", r, swapped[20].bounds, swapped[30].bounds)
+	}
+}
+
+func TestDamageImageChange(t *testing.T) {
+	viewport := image.Pt(400, 400)
+	g := new(compute)
+	handle := new(int)
+	img := opDamage{
+		hash:     1,
+		bounds:   image.Rect(100, 100, 200, 200),
+		tex:      textureKey{handle: handle},
+		imgTrans: f32.Affine2D{}.Scale(f32.Point{}, f32.Pt(2, 2)).Offset(f32.Pt(100, 100)),
+	}
+	ops := append(testDamageOps(3), img)
+	frameDamage(g, viewport, ops)
+	// A change to the image damages its region of the operation, including
+	// the filtered border.
+	change := imageChange{handle: handle, rect: image.Rect(0, 0, 4, 4)}
+	if r, exp := frameDamage(g, viewport, ops, change), image.Rect(100, 100, 109, 109); r != exp {
+		t.Errorf("image change damaged %v, expected %v", r, exp)
+	}
+	// Changes to other images don't damage the operation.
+	other := imageChange{handle: new(int), rect: image.Rect(0, 0, 4, 4)}
+	if r := frameDamage(g, viewport, ops, other); !r.Empty() {
+		t.Errorf("unrelated image change damaged %v", r)
+	}
+}
+
+func TestBinRegionDims(t *testing.T) {
+	tile := image.Pt(tileWidthPx, tileHeightPx)
+	split := 0
+	for _, viewport := range []image.Point{
+		{800, 600}, {1920, 1080}, {3840, 2160}, {7680, 4320}, {16384, 100}, {100, 16384}, {70000, 32},
+	} {
+		tileDims := image.Pt(
+			(viewport.X+tile.X-1)/tile.X,
+			(viewport.Y+tile.Y-1)/tile.Y,
+		)
+		dims := binRegionDims(tileDims)
+		if dims.X <= 0 || dims.Y <= 0 {
+			t.Errorf("%v: empty region %v", viewport, dims)
+			continue
+		}
+		// A region must fit a single pass of the binning and coarse
+		// stages.
+		bins := (dims.X + binWidthTiles - 1) / binWidthTiles * ((dims.Y + binHeightTiles - 1) / binHeightTiles)
+		if bins > maxBins {
+			t.Errorf("%v: region %v has %d bins, more than %d", viewport, dims, bins, maxBins)
+		}
+		if dims.X < tileDims.X && dims.X%binWidthTiles != 0 || dims.Y < tileDims.Y && dims.Y%binHeightTiles != 0 {
+			t.Errorf("%v: region %v not aligned to bins", viewport, dims)
+		}
+		// Viewports that fit are rendered in one region.
+		fits := ((tileDims.X+binWidthTiles-1)/binWidthTiles)*((tileDims.Y+binHeightTiles-1)/binHeightTiles) <= maxBins
+		if fits && dims != tileDims {
+			t.Errorf("%v: region %v, expected the whole viewport %v", viewport, dims, tileDims)
+		}
+		if !fits {
+			split++
+			if dims == tileDims {
+				t.Errorf("%v: viewport not split", viewport)
+			}
+		}
+	}
+	if split == 0 {
+		t.Error("no viewport large enough to split")
+	}
+}
@@ -16,6 +16,8 @@ import (
 	"math"
 	"os"
 	"reflect"
+	"runtime"
+	"sync"
 	"time"
 	"unsafe"
 
@@ -27,6 +29,7 @@ import (
 	"gioui.org/internal/ops"
 	"gioui.org/internal/scene"
 	"gioui.org/internal/stroke"
+	"gioui.org/io/profile"
 	"gioui.org/layout"
 	"gioui.org/op"
 	"gioui.org/op/clip"
@@ -49,12 +52,32 @@ type GPU interface {
 	// information is requested when Collect sees a ProfileOp, and the result
 	// is available through Profile at some later time.
 	Profile() string
+	// FrameProfile is like Profile but returns the profile of the most
+	// recent frame in structured form. The Stages slice is reused by
+	// later frames.
+	FrameProfile() profile.Frame
+	// Damage returns the region of the viewport changed by the most
+	// recent Frame. The region is empty if nothing changed. Renderers
+	// that don't track changes return the whole viewport.
+	Damage() image.Rectangle
+	// Pending reports whether recent frames were rendered without waiting
+	// for the GPU to confirm that they completed, see Verify.
+	Pending() bool
+	// Verify checks the pending frames that the GPU has completed, or every
+	// pending frame if wait is set. If a frame turned out incomplete, Verify
+	// renders the most recent frame again and reports true; the frame must
+	// then be presented again. The operations of the frame need not be
+	// valid.
+	Verify(wait bool) (bool, error)
 }
 
 type gpu struct {
 	cache *resourceCache
+	// shared is the Shared of the GPU, or nil.
+	shared *Shared
 
 	profile                                           string
+	frameProfile                                      profile.Frame
 	timers                                            *timers
 	frameStart                                        time.Time
 	zopsTimer, stencilTimer, coverTimer, cleanupTimer *timer
@@ -67,8 +90,12 @@ type renderer struct {
 	ctx           driver.Device
 	blitter       *blitter
 	pather        *pather
+	batcher       *batcher
 	packer        packer
 	intersections packer
+	// uploadBytes counts the texture bytes uploaded in the current
+	// frame.
+	uploadBytes int
 }
 
 type drawOps struct {
@@ -90,15 +117,44 @@ type drawOps struct {
 	zimageOps   []imageOp
 	pathOps     []*pathOp
 	pathOpCache []pathOp
-	qs          quadSplitter
+	// paintOps are the paint operations of the frame, in drawing
+	// order.
+	paintOps []paintOp
+	// pathJobs are the clip paths missing from pathCache, and
+	// pathJobRefs the clip paths waiting for them.
+	pathJobs    []pathJob
+	pathJobIdx  map[ops.Key]int
+	pathJobRefs []pathJobRef
+	workers     []collectWorker
 	pathCache   *opCache
 	// hack for the compute renderer to access
 	// converted path data.
 	compute bool
+	// uploadBytes counts the path bytes uploaded in the current
+	// frame.
+	uploadBytes int
+	// mutableImages are the images of the frame whose contents may
+	// have changed since the previous frame.
+	mutableImages []mutableImageRef
+}
+
+// mutableImage is implemented by the handles of images whose contents
+// change between frames, such as those of paint.MutableImage.
+type mutableImage interface {
+	// Version returns the current version of the image.
+	Version() int
+	// Changes returns the region of the image changed after version
+	// since.
+	Changes(since int) image.Rectangle
+}
+
+// mutableImageRef refers to a mutable image drawn in a frame.
+type mutableImageRef struct {
+	handle mutableImage
+	src    *image.RGBA
 }
 
 type drawState struct {
-	clip  f32.Rectangle
 	t     f32.Affine2D
 	cpath *pathOp
 	rect  bool
@@ -116,6 +172,55 @@ type drawState struct {
 	color2 color.NRGBA
 }
 
+// paintOp is a paint operation and the drawing state at the point
+// it was collected.
+type paintOp struct {
+	state drawState
+	key   ops.Key
+
+	// clipBounds is the clip of the paint, see drawOps.clipBounds.
+	clipBounds f32.Rectangle
+
+	// The remaining fields are filled in by resolvePaint.
+	culled bool
+	// clipData is the path of the paint rectangle, if it is
+	// sheared or rotated.
+	clipData []byte
+	bnd      f32.Rectangle
+	off      f32.Point
+	clip     image.Rectangle
+	material material
+}
+
+// pathJob is a clip path whose vertices and bounds are built by
+// resolvePaths.
+type pathJob struct {
+	key     ops.Key
+	aux     []byte
+	trans   f32.Affine2D
+	outline bool
+	stroke  clip.StrokeStyle
+
+	verts  []byte
+	bounds f32.Rectangle
+}
+
+type pathJobRef struct {
+	op  *pathOp
+	job int
+	// local is set if the job bounds are in local space
+	// and must be transformed by trans.
+	local bool
+	trans f32.Affine2D
+}
+
+// collectWorker holds the scratch space of a goroutine building
+// vertices for drawOps.
+type collectWorker struct {
+	vertCache []byte
+	qs        quadSplitter
+}
+
 type pathOp struct {
 	off f32.Point
 	// clip is the union of all
@@ -127,6 +232,11 @@ type pathOp struct {
 	pathVerts []byte
 	parent    *pathOp
 	place     placement
+	// clipBounds is the intersection of the viewport and the
+	// bounds of the path and its parents. It is valid if clipDone
+	// is set.
+	clipBounds f32.Rectangle
+	clipDone   bool
 
 	// For compute
 	trans  f32.Affine2D
@@ -279,6 +389,11 @@ type resource interface {
 type texture struct {
 	src *image.RGBA
 	tex driver.Texture
+	// dirty is the region of src not yet uploaded to tex.
+	dirty image.Rectangle
+	// version is the version of a mutable src reflected by tex and
+	// dirty.
+	version int
 }
 
 type blitter struct {
@@ -360,31 +475,53 @@ const (
 	materialTexture
 )
 
+// minPaintsPerWorker is the minimum number of paint operations
+// worth resolving on a separate goroutine.
+const minPaintsPerWorker = 512
+
+// minPathsPerWorker is like minPaintsPerWorker for clip paths
+// missing from the path cache.
+const minPathsPerWorker = 8
+
 func New(api API) (GPU, error) {
 	d, err := driver.NewDevice(api)
 	if err != nil {
 		return nil, err
 	}
+	return newFor(d, nil)
+}
+
+// newFor creates a GPU for d, sharing the resources of shared unless
+// it is nil.
+func newFor(d driver.Device, shared *Shared) (GPU, error) {
 	d.BeginFrame(false, image.Point{})
 	defer d.EndFrame()
 	forceCompute := os.Getenv("GIORENDERER") == "forcecompute"
 	feats := d.Caps().Features
 	switch {
 	case !forceCompute && feats.Has(driver.FeatureFloatRenderTargets):
-		return newGPU(d)
+		return newGPU(d, shared)
 	case feats.Has(driver.FeatureCompute):
-		return newCompute(d)
+		return newCompute(d, shared)
 	default:
 		return nil, errors.New("gpu: no support for float render targets nor compute")
 	}
 }
 
-func newGPU(ctx driver.Device) (*gpu, error) {
+func newGPU(ctx driver.Device, shared *Shared) (*gpu, error) {
 	g := &gpu{
-		cache: newResourceCache(),
+		shared: shared,
+	}
+	shared.join()
+	if shared != nil {
+		g.cache = shared.cache
+		g.drawOps.pathCache = shared.paths
+	} else {
+		g.cache = newResourceCache()
+		g.drawOps.pathCache = newOpCache()
 	}
-	g.drawOps.pathCache = newOpCache()
 	if err := g.init(ctx); err != nil {
+		shared.leave()
 		return nil, err
 	}
 	return g, nil
@@ -403,20 +540,42 @@ func (g *gpu) Clear(col color.NRGBA) {
 
 func (g *gpu) Release() {
 	g.renderer.release()
-	g.drawOps.pathCache.release()
-	g.cache.release()
 	if g.timers != nil {
 		g.timers.release()
 	}
+	if !g.shared.leave() {
+		return
+	}
+	if g.shared != nil {
+		g.shared.release()
+		return
+	}
+	g.drawOps.pathCache.release()
+	g.cache.release()
 	g.ctx.Release()
 }
 
 func (g *gpu) Collect(viewport image.Point, frameOps *op.Ops) {
 	g.renderer.blitter.viewport = viewport
 	g.renderer.pather.viewport = viewport
+	g.frameStart = time.Now()
 	g.drawOps.reset(g.cache, viewport)
 	g.drawOps.collect(g.ctx, g.cache, frameOps, viewport)
-	g.frameStart = time.Now()
+	for _, m := range g.drawOps.mutableImages {
+		v := m.handle.Version()
+		t, exists := g.cache.get(m.handle)
+		if !exists {
+			// The texture is created from the current contents.
+			g.cache.put(m.handle, &texture{src: m.src, version: v})
+			continue
+		}
+		tex := t.(*texture)
+		tex.dirty = tex.dirty.Union(m.handle.Changes(tex.version))
+		tex.version = v
+	}
+	g.frameProfile.Collect = time.Since(g.frameStart)
+	// The operations are drawn as collected; there is no separate encoding
+	// step and Encode is left zero.
 	if g.drawOps.profile && g.timers == nil && g.ctx.Caps().Features.Has(driver.FeatureTimers) {
 		g.timers = newTimers(g.ctx)
 		g.zopsTimer = g.timers.newTimer()
@@ -430,6 +589,7 @@ func (g *gpu) Frame() error {
 	viewport := g.renderer.blitter.viewport
 	defFBO := g.ctx.BeginFrame(g.drawOps.clear, viewport)
 	defer g.ctx.EndFrame()
+	g.renderer.uploadBytes = 0
 	for _, img := range g.drawOps.imageOps {
 		expandPathOp(img.path, img.clip)
 	}
@@ -464,8 +624,9 @@ func (g *gpu) Frame() error {
 	g.coverTimer.end()
 	g.ctx.BindFramebuffer(defFBO)
 	g.cleanupTimer.begin()
-	g.cache.frame()
-	g.drawOps.pathCache.frame()
+	keep := g.shared.keep()
+	g.cache.frame(keep)
+	g.drawOps.pathCache.frame(keep)
 	g.cleanupTimer.end()
 	if g.drawOps.profile && g.timers.ready() {
 		zt, st, covt, cleant := g.zopsTimer.Elapsed, g.stencilTimer.Elapsed, g.coverTimer.Elapsed, g.cleanupTimer.Elapsed
@@ -475,7 +636,18 @@ func (g *gpu) Frame() error {
 		frameDur := time.Since(g.frameStart).Round(q)
 		ft = ft.Round(q)
 		g.profile = fmt.Sprintf("draw:%7s gpu:%7s zt:%7s st:%7s cov:%7s", frameDur, ft, zt, st, covt)
-	}
+		g.frameProfile.Stages = append(g.frameProfile.Stages[:0],
+			profile.Stage{Name: "zops", Duration: g.zopsTimer.Elapsed},
+			profile.Stage{Name: "stencil", Duration: g.stencilTimer.Elapsed},
+			profile.Stage{Name: "cover", Duration: g.coverTimer.Elapsed},
+			profile.Stage{Name: "cleanup", Duration: g.cleanupTimer.Elapsed},
+		)
+	}
+	p := &g.frameProfile
+	p.UploadBytes = g.drawOps.uploadBytes + g.renderer.uploadBytes
+	su, ss := g.renderer.packer.usage()
+	iu, is := g.renderer.intersections.usage()
+	p.AtlasUsed, p.AtlasSize = su+iu, ss+is
 	return nil
 }
 
@@ -483,6 +655,26 @@ func (g *gpu) Profile() string {
 	return g.profile
 }
 
+// Damage returns the whole viewport, because the renderer draws every
+// frame in full.
+func (g *gpu) Damage() image.Rectangle {
+	return image.Rectangle{Max: g.renderer.blitter.viewport}
+}
+
+// Pending always reports false, because the renderer completes frames
+// without checks.
+func (g *gpu) Pending() bool {
+	return false
+}
+
+func (g *gpu) Verify(wait bool) (bool, error) {
+	return false, nil
+}
+
+func (g *gpu) FrameProfile() profile.Frame {
+	return g.frameProfile
+}
+
 func (r *renderer) texHandle(cache *resourceCache, data imageOpData) driver.Texture {
 	var tex *texture
 	t, exists := cache.get(data.handle)
@@ -494,6 +686,12 @@ func (r *renderer) texHandle(cache *resourceCache, data imageOpData) driver.Text
 	}
 	tex = t.(*texture)
 	if tex.tex != nil {
+		if !tex.dirty.Empty() {
+			sub := tex.src.SubImage(tex.dirty).(*image.RGBA)
+			driver.UploadImage(tex.tex, tex.dirty.Min, sub)
+			r.uploadBytes += tex.dirty.Dx() * tex.dirty.Dy() * 4
+			tex.dirty = image.Rectangle{}
+		}
 		return tex.tex
 	}
 	handle, err := r.ctx.NewTexture(driver.TextureFormatSRGB, data.src.Bounds().Dx(), data.src.Bounds().Dy(), driver.FilterLinear, driver.FilterLinear, driver.BufferBindingTexture)
@@ -501,6 +699,7 @@ func (r *renderer) texHandle(cache *resourceCache, data imageOpData) driver.Text
 		panic(err)
 	}
 	driver.UploadImage(handle, image.Pt(0, 0), data.src)
+	r.uploadBytes += len(data.src.Pix)
 	tex.tex = handle
 	return tex.tex
 }
@@ -516,6 +715,8 @@ func newRenderer(ctx driver.Device) *renderer {
 		ctx:     ctx,
 		blitter: newBlitter(ctx),
 		pather:  newPather(ctx),
+		// batcher is nil if the backend doesn't support batched draws.
+		batcher: newBatcher(ctx),
 	}
 
 	maxDim := ctx.Caps().MaxTextureSize
@@ -533,6 +734,9 @@ func newRenderer(ctx driver.Device) *renderer {
 func (r *renderer) release() {
 	r.pather.release()
 	r.blitter.release()
+	if r.batcher != nil {
+		r.batcher.release()
+	}
 }
 
 func newBlitter(ctx driver.Device) *blitter {
@@ -644,17 +848,20 @@ func (r *renderer) stencilClips(pathCache *opCache, ops []*pathOp) {
 	if len(r.packer.sizes) == 0 {
 		return
 	}
-	fbo := -1
 	r.pather.begin(r.packer.sizes)
-	for _, p := range ops {
-		if fbo != p.place.Idx {
-			fbo = p.place.Idx
-			f := r.pather.stenciler.cover(fbo)
-			r.ctx.BindFramebuffer(f.fbo)
-			r.ctx.Clear(0.0, 0.0, 0.0, 0.0)
+	// The packer fills earlier pages when later pages are full, so
+	// stencil the paths one page at a time.
+	for fbo := range r.packer.sizes {
+		f := r.pather.stenciler.cover(fbo)
+		r.ctx.BindFramebuffer(f.fbo)
+		r.ctx.Clear(0.0, 0.0, 0.0, 0.0)
+		for _, p := range ops {
+			if p.place.Idx != fbo {
+				continue
+			}
+			v, _ := pathCache.get(p.pathKey)
+			r.pather.stencilPath(p.clip, p.off, p.place.Pos, v.data)
 		}
-		v, _ := pathCache.get(p.pathKey)
-		r.pather.stencilPath(p.clip, p.off, p.place.Pos, v.data)
 	}
 }
 
@@ -662,22 +869,20 @@ func (r *renderer) intersect(ops []imageOp) {
 	if len(r.intersections.sizes) == 0 {
 		return
 	}
-	fbo := -1
 	r.pather.stenciler.beginIntersect(r.intersections.sizes)
 	r.ctx.BindVertexBuffer(r.blitter.quadVerts, 4*4, 0)
 	r.ctx.BindInputLayout(r.pather.stenciler.iprog.layout)
-	for _, img := range ops {
-		if img.clipType != clipTypeIntersection {
-			continue
-		}
-		if fbo != img.place.Idx {
-			fbo = img.place.Idx
-			f := r.pather.stenciler.intersections.fbos[fbo]
-			r.ctx.BindFramebuffer(f.fbo)
-			r.ctx.Clear(1.0, 0.0, 0.0, 0.0)
+	for fbo := range r.intersections.sizes {
+		f := r.pather.stenciler.intersections.fbos[fbo]
+		r.ctx.BindFramebuffer(f.fbo)
+		r.ctx.Clear(1.0, 0.0, 0.0, 0.0)
+		for _, img := range ops {
+			if img.clipType != clipTypeIntersection || img.place.Idx != fbo {
+				continue
+			}
+			r.ctx.Viewport(img.place.Pos.X, img.place.Pos.Y, img.clip.Dx(), img.clip.Dy())
+			r.intersectPath(img.path, img.clip)
 		}
-		r.ctx.Viewport(img.place.Pos.X, img.place.Pos.Y, img.clip.Dx(), img.clip.Dy())
-		r.intersectPath(img.path, img.clip)
 	}
 }
 
@@ -786,6 +991,7 @@ func floor(v float32) int {
 
 func (d *drawOps) reset(cache *resourceCache, viewport image.Point) {
 	d.profile = false
+	d.uploadBytes = 0
 	d.cache = cache
 	d.viewport = viewport
 	d.imageOps = d.imageOps[:0]
@@ -794,29 +1000,45 @@ func (d *drawOps) reset(cache *resourceCache, viewport image.Point) {
 	d.pathOps = d.pathOps[:0]
 	d.pathOpCache = d.pathOpCache[:0]
 	d.vertCache = d.vertCache[:0]
+	d.paintOps = d.paintOps[:0]
+	d.mutableImages = d.mutableImages[:0]
+	d.pathJobs = d.pathJobs[:0]
+	d.pathJobRefs = d.pathJobRefs[:0]
+	for i := range d.workers {
+		d.workers[i].vertCache = d.workers[i].vertCache[:0]
+	}
 }
 
 func (d *drawOps) collect(ctx driver.Device, cache *resourceCache, root *op.Ops, viewport image.Point) {
-	clip := f32.Rectangle{
-		Max: f32.Point{X: float32(viewport.X), Y: float32(viewport.Y)},
-	}
 	d.reader.Reset(root)
 	state := drawState{
-		clip:  clip,
 		rect:  true,
 		color: color.NRGBA{A: 0xff},
 	}
 	d.collectOps(&d.reader, state)
+	d.resolvePaths()
+	for i := range d.paintOps {
+		p := &d.paintOps[i]
+		p.clipBounds = d.clipBounds(p.state.cpath)
+	}
+	d.resolvePaints()
+	d.mergePaints()
 	for _, p := range d.pathOps {
 		if v, exists := d.pathCache.get(p.pathKey); !exists || v.data.data == nil {
+			bounds := p.bounds
+			if exists {
+				// Keep the bounds of local space paths.
+				bounds = v.bounds
+			}
 			data := buildPath(ctx, p.pathVerts)
+			d.uploadBytes += len(p.pathVerts)
 			var computePath encoder
 			if d.compute {
 				computePath = encodePath(p.pathVerts)
 			}
 			d.pathCache.put(p.pathKey, opCacheValue{
 				data:        data,
-				bounds:      p.bounds,
+				bounds:      bounds,
 				computePath: computePath,
 			})
 		}
@@ -868,7 +1090,6 @@ func (d *drawOps) collectOps(r *ops.Reader, state drawState) {
 	var (
 		quads quadsOp
 		str   clip.StrokeStyle
-		z     int
 	)
 	d.save(opconst.InitialStateID, state)
 loop:
@@ -896,34 +1117,63 @@ loop:
 			op.decode(encOp.Data)
 			bounds := op.bounds
 			trans, off := splitTransform(state.t)
+			job, local := -1, false
 			if len(quads.aux) > 0 {
 				// There is a clipping path, build the gpu data and update the
 				// cache key such that it will be equal only if the transform is the
 				// same also. Use cached data if we have it.
-				quads.key = quads.key.SetTransform(trans)
+				//
+				// The compute renderer transforms paths on the GPU, so its cache
+				// entries are in local space and only the bounds are transformed.
+				// Strokes are widened by the scale of the transform which is only
+				// exact for similarity transforms.
+				local = d.compute && (str.Width == 0 || isSimilarity(trans))
+				pathTrans := trans
+				if local {
+					pathTrans = f32.Affine2D{}
+				}
+				quads.key = quads.key.SetTransform(pathTrans)
 				if v, ok := d.pathCache.get(quads.key); ok {
 					// Since the GPU data exists in the cache aux will not be used.
 					// Why is this not used for the offset shapes?
 					op.bounds = v.bounds
+					if local {
+						op.bounds = transformBounds(v.bounds, trans)
+					}
 				} else {
-					pathData, bounds := d.buildVerts(
-						quads.aux, trans, op.outline, str,
-					)
-					op.bounds = bounds
-					if !d.compute {
-						quads.aux = pathData
+					// Build the vertices and bounds in resolvePaths, along with
+					// the other paths missing from the cache.
+					j, exists := d.pathJobIdx[quads.key]
+					if !exists {
+						j = len(d.pathJobs)
+						d.pathJobs = append(d.pathJobs, pathJob{
+							key:     quads.key,
+							aux:     quads.aux,
+							trans:   pathTrans,
+							outline: op.outline,
+							stroke:  str,
+						})
+						if d.pathJobIdx == nil {
+							d.pathJobIdx = make(map[ops.Key]int)
+						}
+						d.pathJobIdx[quads.key] = j
 					}
-					// add it to the cache, without GPU data, so the transform can be
-					// reused.
-					d.pathCache.put(quads.key, opCacheValue{bounds: op.bounds})
+					job = j
 				}
 			} else {
-				quads.aux, op.bounds, _ = d.boundsForTransformedRect(bounds, trans)
+				quads.aux, op.bounds, _ = d.boundsForTransformedRect(&d.vertCache, bounds, trans)
 				quads.key = encOp.Key
 				quads.key.SetTransform(trans)
 			}
-			state.clip = state.clip.Intersect(op.bounds.Add(off))
 			d.addClipPath(&state, quads.aux, quads.key, op.bounds, off, state.t, str)
+			if job != -1 {
+				d.pathJobRefs = append(d.pathJobRefs, pathJobRef{
+					op:    state.cpath,
+					job:   job,
+					local: local,
+					trans: trans,
+				})
+			}
 			quads = quadsOp{}
 			str = clip.StrokeStyle{}
 
@@ -940,73 +1190,11 @@ loop:
 		case opconst.TypeImage:
 			state.matType = materialTexture
 			state.image = decodeImageOp(encOp.Data, encOp.Refs)
-		case opconst.TypePaint:
-			// Transform (if needed) the painting rectangle and if so generate a clip path,
-			// for those cases also compute a partialTrans that maps texture coordinates between
-			// the new bounding rectangle and the transformed original paint rectangle.
-			trans, off := splitTransform(state.t)
-			// Fill the clip area, unless the material is a (bounded) image.
-			// TODO: Find a tighter bound.
-			inf := float32(1e6)
-			dst := f32.Rect(-inf, -inf, inf, inf)
-			if state.matType == materialTexture {
-				dst = layout.FRect(state.image.src.Rect)
-			}
-			clipData, bnd, partialTrans := d.boundsForTransformedRect(dst, trans)
-			cl := state.clip.Intersect(bnd.Add(off))
-			if cl.Empty() {
-				continue
-			}
-
-			wasrect := state.rect
-			if clipData != nil {
-				// The paint operation is sheared or rotated, add a clip path representing
-				// this transformed rectangle.
-				encOp.Key.SetTransform(trans)
-				d.addClipPath(&state, clipData, encOp.Key, bnd, off, state.t, clip.StrokeStyle{})
-			}
-
-			bounds := boundRectF(cl)
-			mat := state.materialFor(bnd, off, partialTrans, bounds, state.t)
-
-			if bounds.Min == (image.Point{}) && bounds.Max == d.viewport && state.rect && mat.opaque && (mat.material == materialColor) {
-				// The image is a uniform opaque color and takes up the whole screen.
-				// Scrap images up to and including this image and set clear color.
-				d.allImageOps = d.allImageOps[:0]
-				d.zimageOps = d.zimageOps[:0]
-				d.imageOps = d.imageOps[:0]
-				z = 0
-				d.clearColor = mat.color.Opaque()
-				d.clear = true
-				continue
-			}
-			z++
-			if z != int(uint16(z)) {
-				// TODO(eliasnaur) gioui.org/issue/127.
-				panic("more than 65k paint objects not supported")
-			}
-			// Assume 16-bit depth buffer.
-			const zdepth = 1 << 16
-			// Convert z to window-space, assuming depth range [0;1].
-			zf := float32(z)*2/zdepth - 1.0
-			img := imageOp{
-				z:        zf,
-				path:     state.cpath,
-				clip:     bounds,
-				material: mat,
-			}
-
-			d.allImageOps = append(d.allImageOps, img)
-			if state.rect && img.material.opaque {
-				d.zimageOps = append(d.zimageOps, img)
-			} else {
-				d.imageOps = append(d.imageOps, img)
-			}
-			if clipData != nil {
-				// we added a clip path that should not remain
-				state.cpath = state.cpath.parent
-				state.rect = wasrect
+			if m, ok := state.image.handle.(mutableImage); ok {
+				d.mutableImages = append(d.mutableImages, mutableImageRef{handle: m, src: state.image.src})
 			}
+		case opconst.TypePaint:
+			d.paintOps = append(d.paintOps, paintOp{state: state, key: encOp.Key})
 		case opconst.TypeSave:
 			id := ops.DecodeSave(encOp.Data)
 			d.save(id, state)
@@ -1023,6 +1211,176 @@ loop:
 	}
 }
 
+// resolvePaths builds the vertices and bounds of the clip paths
+// missing from the path cache, split among goroutines if there
+// are enough of them.
+func (d *drawOps) resolvePaths() {
+	d.forEach(len(d.pathJobs), minPathsPerWorker, func(w *collectWorker, i int) {
+		j := &d.pathJobs[i]
+		j.verts, j.bounds = w.buildVerts(j.aux, j.trans, j.outline, j.stroke)
+	})
+	for i := range d.pathJobs {
+		j := &d.pathJobs[i]
+		// Add the path to the cache, without GPU data, so the transform can be
+		// reused.
+		d.pathCache.put(j.key, opCacheValue{bounds: j.bounds})
+		delete(d.pathJobIdx, j.key)
+	}
+	for _, r := range d.pathJobRefs {
+		j := &d.pathJobs[r.job]
+		r.op.bounds = j.bounds
+		if r.local {
+			r.op.bounds = transformBounds(j.bounds, r.trans)
+		}
+		if !d.compute {
+			r.op.pathVerts = j.verts
+		}
+	}
+}
+
+// clipBounds returns the intersection of the viewport and the bounds
+// of p and its parents.
+func (d *drawOps) clipBounds(p *pathOp) f32.Rectangle {
+	if p == nil {
+		return f32.Rectangle{
+			Max: f32.Point{X: float32(d.viewport.X), Y: float32(d.viewport.Y)},
+		}
+	}
+	if !p.clipDone {
+		p.clipBounds = d.clipBounds(p.parent).Intersect(p.bounds.Add(p.off))
+		p.clipDone = true
+	}
+	return p.clipBounds
+}
+
+// resolvePaints resolves the collected paint operations, split among
+// goroutines if there are enough of them.
+func (d *drawOps) resolvePaints() {
+	d.forEach(len(d.paintOps), minPaintsPerWorker, func(w *collectWorker, i int) {
+		d.resolvePaint(w, &d.paintOps[i])
+	})
+}
+
+// forEach calls f for every index in [0;n). The indices are split among
+// goroutines with at least minPerWorker indices each, up to GOMAXPROCS.
+// Each goroutine is given a distinct worker.
+func (d *drawOps) forEach(n, minPerWorker int, f func(w *collectWorker, i int)) {
+	nworkers := runtime.GOMAXPROCS(0)
+	if max := n / minPerWorker; nworkers > max {
+		nworkers = max
+	}
+	if nworkers < 1 {
+		nworkers = 1
+	}
+	if len(d.workers) < nworkers {
+		d.workers = append(d.workers, make([]collectWorker, nworkers-len(d.workers))...)
+	}
+	if nworkers == 1 {
+		w := &d.workers[0]
+		for i := 0; i < n; i++ {
+			f(w, i)
+		}
+		return
+	}
+	var wg sync.WaitGroup
+	wg.Add(nworkers)
+	chunk := (n + nworkers - 1) / nworkers
+	for i := 0; i < nworkers; i++ {
+		start, end := i*chunk, (i+1)*chunk
+		if end > n {
+			end = n
+		}
+		go func(w *collectWorker, start, end int) {
+			defer wg.Done()
+			for i := start; i < end; i++ {
+				f(w, i)
+			}
+		}(&d.workers[i], start, end)
+	}
+	wg.Wait()
+}
+
+// resolvePaint computes the clip and material of p. It must not
+// modify d and may be called concurrently with different workers.
+func (d *drawOps) resolvePaint(w *collectWorker, p *paintOp) {
+	state := &p.state
+	// Transform (if needed) the painting rectangle and if so generate a clip path,
+	// for those cases also compute a partialTrans that maps texture coordinates between
+	// the new bounding rectangle and the transformed original paint rectangle.
+	trans, off := splitTransform(state.t)
+	// Fill the clip area, unless the material is a (bounded) image.
+	// TODO: Find a tighter bound.
+	inf := float32(1e6)
+	dst := f32.Rect(-inf, -inf, inf, inf)
+	if state.matType == materialTexture {
+		dst = layout.FRect(state.image.src.Rect)
+	}
+	clipData, bnd, partialTrans := d.boundsForTransformedRect(&w.vertCache, dst, trans)
+	cl := p.clipBounds.Intersect(bnd.Add(off))
+	if cl.Empty() {
+		p.culled = true
+		return
+	}
+	p.clipData = clipData
+	p.bnd = bnd
+	p.off = off
+	p.clip = boundRectF(cl)
+	p.material = state.materialFor(bnd, off, partialTrans, p.clip, state.t)
+}
+
+// mergePaints adds the resolved paint operations to the image
+// operations, in drawing order.
+func (d *drawOps) mergePaints() {
+	z := 0
+	for i := range d.paintOps {
+		p := &d.paintOps[i]
+		if p.culled {
+			continue
+		}
+		state := p.state
+		if p.clipData != nil {
+			// The paint operation is sheared or rotated, add a clip path representing
+			// this transformed rectangle.
+			d.addClipPath(&state, p.clipData, p.key, p.bnd, p.off, state.t, clip.StrokeStyle{})
+		}
+		mat := p.material
+		bounds := p.clip
+		if bounds.Min == (image.Point{}) && bounds.Max == d.viewport && state.rect && mat.opaque && (mat.material == materialColor) {
+			// The image is a uniform opaque color and takes up the whole screen.
+			// Scrap images up to and including this image and set clear color.
+			d.allImageOps = d.allImageOps[:0]
+			d.zimageOps = d.zimageOps[:0]
+			d.imageOps = d.imageOps[:0]
+			z = 0
+			d.clearColor = mat.color.Opaque()
+			d.clear = true
+			continue
+		}
+		z++
+		if z != int(uint16(z)) {
+			// TODO(eliasnaur) gioui.org/issue/127.
+			panic("more than 65k paint objects not supported")
+		}
+		// Assume 16-bit depth buffer.
+		const zdepth = 1 << 16
+		// Convert z to window-space, assuming depth range [0;1].
+		zf := float32(z)*2/zdepth - 1.0
+		img := imageOp{
+			z:        zf,
+			path:     state.cpath,
+			clip:     bounds,
+			material: mat,
+		}
+
+		d.allImageOps = append(d.allImageOps, img)
+		if state.rect && img.material.opaque {
+			d.zimageOps = append(d.zimageOps, img)
+		} else {
+			d.imageOps = append(d.imageOps, img)
+		}
+	}
+}
+
 func expandPathOp(p *pathOp, clip image.Rectangle) {
 	for p != nil {
 		pclip := p.clip
@@ -1077,6 +1435,9 @@ func (d *drawState) materialFor(rect f32.Rectangle, off f32.Point, partTrans f32
 
 func (r *renderer) drawZOps(cache *resourceCache, ops []imageOp) {
 	r.ctx.SetDepthTest(true)
+	// The depth test orders opaque ops, so every color op can be
+	// drawn in the same batch.
+	batched := r.batchZOps(ops)
 	r.ctx.BindVertexBuffer(r.blitter.quadVerts, 4*4, 0)
 	r.ctx.BindInputLayout(r.blitter.layout)
 	// Render front to back.
@@ -1084,6 +1445,10 @@ func (r *renderer) drawZOps(cache *resourceCache, ops []imageOp) {
 		img := ops[i]
 		m := img.material
 		switch m.material {
+		case materialColor:
+			if batched {
+				continue
+			}
 		case materialTexture:
 			r.ctx.BindTexture(0, r.texHandle(cache, m.data))
 		}
@@ -1094,14 +1459,125 @@ func (r *renderer) drawZOps(cache *resourceCache, ops []imageOp) {
 	r.ctx.SetDepthTest(false)
 }
 
+// batchZOps draws the color ops of the opaque pass in a single batch.
+// It reports whether the ops were drawn.
+func (r *renderer) batchZOps(ops []imageOp) bool {
+	b := r.batcher
+	if b == nil {
+		return false
+	}
+	b.reset()
+	run := batchRun{}
+	for _, img := range ops {
+		m := img.material
+		if m.material != materialColor {
+			continue
+		}
+		scale, off := clipSpaceTransform(img.clip, r.blitter.viewport)
+		b.addQuad(img.z, m.color, scale, off, f32.Point{}, f32.Point{})
+		run.n++
+	}
+	if run.n < minBatch {
+		return false
+	}
+	b.upload(&b.zbuf)
+	b.draw(&b.zbuf, run)
+	return true
+}
+
+// batchOps collects runs of consecutive color ops that share a cover
+// texture, and uploads their vertices.
+func (r *renderer) batchOps(ops []imageOp) []batchRun {
+	b := r.batcher
+	if b == nil {
+		return nil
+	}
+	b.reset()
+	run := batchRun{op: -1}
+	endRun := func() {
+		if run.n >= minBatch {
+			b.runs = append(b.runs, run)
+		} else {
+			// Drop the vertices of runs too short for batching.
+			b.verts = b.verts[:run.vert]
+		}
+		run = batchRun{op: -1}
+	}
+	for i, img := range ops {
+		m := img.material
+		if m.material != materialColor {
+			endRun()
+			continue
+		}
+		fbo, clipped := r.coverFBO(img)
+		if run.op != -1 && run.cover != fbo.tex {
+			endRun()
+		}
+		if run.op == -1 {
+			run = batchRun{op: i, cover: fbo.tex, vert: len(b.verts)}
+		}
+		scale, off := clipSpaceTransform(img.clip, r.blitter.viewport)
+		var coverScale, coverOff f32.Point
+		if clipped {
+			coverScale, coverOff = coverTransform(img, fbo)
+		}
+		b.addQuad(img.z, m.color, scale, off, coverScale, coverOff)
+		run.n++
+	}
+	endRun()
+	b.upload(&b.buf)
+	return b.runs
+}
+
+// coverFBO returns the cover texture of an op, or false if the op is
+// not clipped by a path.
+func (r *renderer) coverFBO(img imageOp) (stencilFBO, bool) {
+	switch img.clipType {
+	case clipTypePath:
+		return r.pather.stenciler.cover(img.place.Idx), true
+	case clipTypeIntersection:
+		return r.pather.stenciler.intersections.fbos[img.place.Idx], true
+	}
+	return stencilFBO{}, false
+}
+
+// coverTransform returns the transformation from the quad texture
+// coordinates to the cover coordinates of an op.
+func coverTransform(img imageOp, fbo stencilFBO) (f32.Point, f32.Point) {
+	uv := image.Rectangle{
+		Min: img.place.Pos,
+		Max: img.place.Pos.Add(img.clip.Size()),
+	}
+	return texSpaceTransform(layout.FRect(uv), fbo.size)
+}
+
 func (r *renderer) drawOps(cache *resourceCache, ops []imageOp) {
 	r.ctx.SetDepthTest(true)
 	r.ctx.DepthMask(false)
 	r.ctx.BlendFunc(driver.BlendFactorOne, driver.BlendFactorOneMinusSrcAlpha)
-	r.ctx.BindVertexBuffer(r.blitter.quadVerts, 4*4, 0)
-	r.ctx.BindInputLayout(r.pather.coverer.layout)
+	runs := r.batchOps(ops)
 	var coverTex driver.Texture
-	for _, img := range ops {
+	// bound tracks whether the quad vertices are bound.
+	bound := false
+	for i := 0; i < len(ops); i++ {
+		if len(runs) > 0 && runs[0].op == i {
+			run := runs[0]
+			runs = runs[1:]
+			if run.cover != nil && coverTex != run.cover {
+				coverTex = run.cover
+				r.ctx.BindTexture(1, coverTex)
+			}
+			r.batcher.draw(&r.batcher.buf, run)
+			bound = false
+			i += run.n - 1
+			continue
+		}
+		if !bound {
+			r.ctx.BindVertexBuffer(r.blitter.quadVerts, 4*4, 0)
+			r.ctx.BindInputLayout(r.pather.coverer.layout)
+			bound = true
+		}
+		img := ops[i]
 		m := img.material
 		switch m.material {
 		case materialTexture:
@@ -1110,25 +1586,16 @@ func (r *renderer) drawOps(cache *resourceCache, ops []imageOp) {
 		drc := img.clip
 
 		scale, off := clipSpaceTransform(drc, r.blitter.viewport)
-		var fbo stencilFBO
-		switch img.clipType {
-		case clipTypeNone:
+		fbo, clipped := r.coverFBO(img)
+		if !clipped {
 			r.blitter.blit(img.z, m.material, m.color, m.color1, m.color2, scale, off, m.uvTrans)
 			continue
-		case clipTypePath:
-			fbo = r.pather.stenciler.cover(img.place.Idx)
-		case clipTypeIntersection:
-			fbo = r.pather.stenciler.intersections.fbos[img.place.Idx]
 		}
 		if coverTex != fbo.tex {
 			coverTex = fbo.tex
 			r.ctx.BindTexture(1, coverTex)
 		}
-		uv := image.Rectangle{
-			Min: img.place.Pos,
-			Max: img.place.Pos.Add(drc.Size()),
-		}
-		coverScale, coverOff := texSpaceTransform(layout.FRect(uv), fbo.size)
+		coverScale, coverOff := coverTransform(img, fbo)
 		r.pather.cover(img.z, m.material, m.color, m.color1, m.color2, scale, off, m.uvTrans, coverScale, coverOff)
 	}
 	r.ctx.DepthMask(true)
@@ -1309,20 +1776,15 @@ func fillContourMaxY(maxy float32, verts []byte) {
 	}
 }
 
-func (d *drawOps) writeVertCache(n int) []byte {
-	d.vertCache = append(d.vertCache, make([]byte, n)...)
-	return d.vertCache[len(d.vertCache)-n:]
-}
-
 // transform, split paths as needed, calculate maxY, bounds and create GPU vertices.
-func (d *drawOps) buildVerts(pathData []byte, tr f32.Affine2D, outline bool, str clip.StrokeStyle) (verts []byte, bounds f32.Rectangle) {
+func (w *collectWorker) buildVerts(pathData []byte, tr f32.Affine2D, outline bool, str clip.StrokeStyle) (verts []byte, bounds f32.Rectangle) {
 	inf := float32(math.Inf(+1))
-	d.qs.bounds = f32.Rectangle{
+	w.qs.bounds = f32.Rectangle{
 		Min: f32.Point{X: inf, Y: inf},
 		Max: f32.Point{X: -inf, Y: -inf},
 	}
-	d.qs.d = d
-	startLength := len(d.vertCache)
+	w.qs.verts = &w.vertCache
+	startLength := len(w.vertCache)
 
 	switch {
 	case str.Width > 0:
@@ -1335,18 +1797,18 @@ func (d *drawOps) buildVerts(pathData []byte, tr f32.Affine2D, outline bool, str
 		}
 		quads := stroke.StrokePathCommands(ss, stroke.DashOp{}, pathData)
 		for _, quad := range quads {
-			d.qs.contour = quad.Contour
+			w.qs.contour = quad.Contour
 			quad.Quad = quad.Quad.Transform(tr)
 
-			d.qs.splitAndEncode(quad.Quad)
+			w.qs.splitAndEncode(quad.Quad)
 		}
 
 	case outline:
-		decodeToOutlineQuads(&d.qs, tr, pathData)
+		decodeToOutlineQuads(&w.qs, tr, pathData)
 	}
 
-	fillMaxY(d.vertCache[startLength:])
-	return d.vertCache[startLength:], d.qs.bounds
+	fillMaxY(w.vertCache[startLength:])
+	return w.vertCache[startLength:], w.qs.bounds
 }
 
 // decodeOutlineQuads decodes scene commands, splits them into quadratic béziers
@@ -1380,7 +1842,7 @@ func decodeToOutlineQuads(qs *quadSplitter, tr f32.Affine2D, pathData []byte) {
 }
 
 // create GPU vertices for transformed r, find the bounds and establish texture transform.
-func (d *drawOps) boundsForTransformedRect(r f32.Rectangle, tr f32.Affine2D) (aux []byte, bnd f32.Rectangle, ptr f32.Affine2D) {
+func (d *drawOps) boundsForTransformedRect(vertCache *[]byte, r f32.Rectangle, tr f32.Affine2D) (aux []byte, bnd f32.Rectangle, ptr f32.Affine2D) {
 	if isPureOffset(tr) {
 		// fast-path to allow blitting of pure rectangles
 		_, _, ox, _, _, oy := tr.Elems()
@@ -1413,18 +1875,18 @@ func (d *drawOps) boundsForTransformedRect(r f32.Rectangle, tr f32.Affine2D) (au
 	}
 
 	// build the GPU vertices
-	l := len(d.vertCache)
+	l := len(*vertCache)
 	if !d.compute {
-		d.vertCache = append(d.vertCache, make([]byte, vertStride*4*4)...)
-		aux = d.vertCache[l:]
+		*vertCache = append(*vertCache, make([]byte, vertStride*4*4)...)
+		aux = (*vertCache)[l:]
 		encodeQuadTo(aux, 0, corners[0], corners[0].Add(corners[1]).Mul(0.5), corners[1])
 		encodeQuadTo(aux[vertStride*4:], 0, corners[1], corners[1].Add(corners[2]).Mul(0.5), corners[2])
 		encodeQuadTo(aux[vertStride*4*2:], 0, corners[2], corners[2].Add(corners[3]).Mul(0.5), corners[3])
 		encodeQuadTo(aux[vertStride*4*3:], 0, corners[3], corners[3].Add(corners[0]).Mul(0.5), corners[0])
 		fillMaxY(aux)
 	} else {
-		d.vertCache = append(d.vertCache, make([]byte, (scene.CommandSize+4)*4)...)
-		aux = d.vertCache[l:]
+		*vertCache = append(*vertCache, make([]byte, (scene.CommandSize+4)*4)...)
+		aux = (*vertCache)[l:]
 		buf := aux
 		bo := binary.LittleEndian
 		bo.PutUint32(buf, 0) // Contour
@@ -1458,3 +1920,26 @@ func isPureOffset(t f32.Affine2D) bool {
 	a, b, _, d, e, _ := t.Elems()
 	return a == 1 && b == 0 && d == 0 && e == 1
 }
+
+// isSimilarity reports whether t is a combination of uniform scaling,
+// rotation, reflection and offset.
+func isSimilarity(t f32.Affine2D) bool {
+	sx, hx, _, hy, sy, _ := t.Elems()
+	return sx == sy && hx == -hy || sx == -sy && hx == hy
+}
+
+// transformBounds returns the bounds of r transformed by t.
+func transformBounds(r f32.Rectangle, t f32.Affine2D) f32.Rectangle {
+	if r.Empty() {
+		return r
+	}
+	corners := [4]f32.Point{
+		t.Transform(r.Min), t.Transform(f32.Pt(r.Max.X, r.Min.Y)),
+		t.Transform(r.Max), t.Transform(f32.Pt(r.Min.X, r.Max.Y)),
+	}
+	b := f32.Rectangle{Min: corners[0], Max: corners[0]}
+	for _, c := range corners[1:] {
+		b = unionRect(b, f32.Rectangle{Min: c, Max: c})
+	}
+	return b
+}
@@ -5,12 +5,15 @@
 package headless
 
 import (
+	"errors"
 	"image"
 	"image/color"
 	"runtime"
+	"sync"
 
 	"gioui.org/gpu"
 	"gioui.org/gpu/internal/driver"
+	"gioui.org/io/profile"
 	"gioui.org/op"
 )
 
@@ -18,12 +21,57 @@ import (
 type Window struct {
 	size   image.Point
 	ctx    context
+	thread *renderThread
+	share  *share
 	dev    driver.Device
 	gpu    gpu.GPU
 	fboTex driver.Texture
 	fbo    driver.Framebuffer
+	// async is set if screenshots can be read back without
+	// waiting for the GPU.
+	async bool
+	// readbacks are the idle screenshot buffers.
+	readbacks []*readback
+	// batch is scratch space for FrameBatch.
+	batch []*readback
 }
 
+// PendingScreenshot is a screenshot started by ScreenshotAsync.
+type PendingScreenshot struct {
+	w  *Window
+	rb *readback
+}
+
+// readback holds the pixels of a screenshot.
+type readback struct {
+	// buf and fence track an asynchronous read of the pixels.
+	buf   driver.Buffer
+	fence driver.Fence
+	// pixels contains the pixels of a synchronous read.
+	pixels []byte
+}
+
+// share is the state shared by windows created with NewSharedWindow.
+type share struct {
+	gpu gpu.Shared
+	dev driver.Device
+	// windows is the number of windows using the context. It is
+	// accessed only from the render thread.
+	windows int
+}
+
+// renderThread runs functions on a dedicated OS thread with a context
+// current.
+type renderThread struct {
+	mu      sync.Mutex
+	funcs   chan func() error
+	results chan error
+}
+
+// maxFramesInFlight is the number of frames FrameBatch renders
+// before waiting for the screenshot of the oldest frame.
+const maxFramesInFlight = 3
+
 type context interface {
 	API() gpu.API
 	MakeCurrent() error
@@ -37,16 +85,45 @@ func NewWindow(width, height int) (*Window, error) {
 	if err != nil {
 		return nil, err
 	}
+	thread, err := newRenderThread(ctx)
+	if err != nil {
+		ctx.Release()
+		return nil, err
+	}
+	w, err := newWindow(ctx, thread, new(share), width, height)
+	if err != nil {
+		thread.release()
+		ctx.Release()
+		return nil, err
+	}
+	return w, nil
+}
+
+// NewSharedWindow creates a headless window that renders with the
+// context and render thread of w, and shares its GPU resources such as
+// programs, image textures and cached paths. The windows can have
+// different sizes.
+func NewSharedWindow(w *Window, width, height int) (*Window, error) {
+	return newWindow(w.ctx, w.thread, w.share, width, height)
+}
+
+func newWindow(ctx context, thread *renderThread, s *share, width, height int) (*Window, error) {
 	w := &Window{
-		size: image.Point{X: width, Y: height},
-		ctx:  ctx,
+		size:   image.Point{X: width, Y: height},
+		ctx:    ctx,
+		thread: thread,
+		share:  s,
 	}
-	err = contextDo(ctx, func() error {
+	err := thread.do(func() error {
 		api := ctx.API()
-		dev, err := driver.NewDevice(api)
-		if err != nil {
-			return err
+		if s.dev == nil {
+			dev, err := driver.NewDevice(api)
+			if err != nil {
+				return err
+			}
+			s.dev = dev
 		}
+		dev := s.dev
 		dev.Viewport(0, 0, width, height)
 		fboTex, err := dev.NewTexture(
 			driver.TextureFormatSRGB,
@@ -63,7 +140,7 @@ func NewWindow(width, height int) (*Window, error) {
 			fboTex.Release()
 			return err
 		}
-		gp, err := gpu.New(api)
+		gp, err := gpu.NewShared(api, &s.gpu)
 		if err != nil {
 			fbo.Release()
 			fboTex.Release()
@@ -73,10 +150,11 @@ func NewWindow(width, height int) (*Window, error) {
 		w.fbo = fbo
 		w.gpu = gp
 		w.dev = dev
-		return err
+		w.async = dev.Caps().Features.Has(driver.FeaturePixelPack | driver.FeatureFences)
+		s.windows++
+		return nil
 	})
 	if err != nil {
-		ctx.Release()
 		return nil, err
 	}
 	return w, nil
@@ -84,7 +162,17 @@ func NewWindow(width, height int) (*Window, error) {
 
 // Release resources associated with the window.
 func (w *Window) Release() {
-	contextDo(w.ctx, func() error {
+	if w.thread == nil {
+		return
+	}
+	last := false
+	w.thread.do(func() error {
+		w.share.windows--
+		last = w.share.windows == 0
+		for _, rb := range w.readbacks {
+			rb.release()
+		}
+		w.readbacks = nil
 		if w.fbo != nil {
 			w.fbo.Release()
 			w.fbo = nil
@@ -99,49 +187,292 @@ func (w *Window) Release() {
 		}
 		return nil
 	})
-	if w.ctx != nil {
+	if last {
+		w.thread.release()
 		w.ctx.Release()
-		w.ctx = nil
 	}
+	w.thread = nil
+	w.ctx = nil
 }
 
 // Frame replace the window content and state with the
 // operation list.
 func (w *Window) Frame(frame *op.Ops) error {
-	return contextDo(w.ctx, func() error {
-		w.dev.BindFramebuffer(w.fbo)
-		w.gpu.Clear(color.NRGBA{})
-		w.gpu.Collect(w.size, frame)
-		return w.gpu.Frame()
+	return w.thread.do(func() error {
+		return w.frame(frame)
+	})
+}
+
+func (w *Window) frame(frame *op.Ops) error {
+	w.dev.BindFramebuffer(w.fbo)
+	w.gpu.Clear(color.NRGBA{})
+	w.gpu.Collect(w.size, frame)
+	return w.gpu.Frame()
+}
+
+// FrameProfile returns the profile of the most recent frame. GPU
+// stage timings are measured only for frames containing a profile.Op.
+func (w *Window) FrameProfile() profile.Frame {
+	var p profile.Frame
+	w.thread.do(func() error {
+		p = w.gpu.FrameProfile()
+		// The renderer reuses the stages for later frames.
+		p.Stages = append([]profile.Stage(nil), p.Stages...)
+		return nil
 	})
+	return p
 }
 
 // Screenshot returns an image with the content of the window.
 func (w *Window) Screenshot() (*image.RGBA, error) {
-	var img *image.RGBA
-	err := contextDo(w.ctx, func() error {
+	img := image.NewRGBA(image.Rectangle{Max: w.size})
+	if err := w.ScreenshotInto(img); err != nil {
+		return nil, err
+	}
+	return img, nil
+}
+
+// ScreenshotInto copies the content of the window to img, which must
+// have the size of the window and contiguous rows.
+func (w *Window) ScreenshotInto(img *image.RGBA) error {
+	if err := w.checkImage(img); err != nil {
+		return err
+	}
+	return w.thread.do(func() error {
+		if err := w.verify(); err != nil {
+			return err
+		}
+		return driver.ReadImage(w.dev, w.fbo, img)
+	})
+}
+
+// ScreenshotAsync starts copying the content of the window without
+// waiting for the rendering to complete. Use the returned
+// PendingScreenshot to retrieve the image; the window can meanwhile
+// render new frames.
+func (w *Window) ScreenshotAsync() (*PendingScreenshot, error) {
+	var rb *readback
+	err := w.thread.do(func() error {
 		var err error
-		img, err = driver.DownloadImage(w.dev, w.fbo, image.Rectangle{Max: w.size})
+		rb, err = w.startReadback()
 		return err
 	})
 	if err != nil {
 		return nil, err
 	}
-	return img, nil
+	return &PendingScreenshot{w: w, rb: rb}, nil
+}
+
+// Ready reports whether Wait can complete without blocking.
+func (s *PendingScreenshot) Ready() bool {
+	if s.rb == nil || s.rb.fence == nil {
+		return true
+	}
+	ready := false
+	s.w.thread.do(func() error {
+		ready = s.rb.fence.Signaled()
+		return nil
+	})
+	return ready
+}
+
+// Wait copies the screenshot to img, which must have the size of the
+// window and contiguous rows. Wait blocks until the pixels are available.
+// Every PendingScreenshot must be waited for exactly once.
+func (s *PendingScreenshot) Wait(img *image.RGBA) error {
+	if s.rb == nil {
+		return errors.New("headless: screenshot already retrieved")
+	}
+	if err := s.w.checkImage(img); err != nil {
+		return err
+	}
+	rb := s.rb
+	s.rb = nil
+	return s.w.thread.do(func() error {
+		return s.w.finishReadback(rb, img)
+	})
+}
+
+// FrameBatch renders every frame and copies the resulting window content
+// to the image with the same index, as if by calling Frame and
+// ScreenshotInto for each frame. The screenshots are downloaded while the
+// following frames render, and the whole batch is rendered in a single
+// round trip to the render thread. Like every screenshot, a frame is
+// copied only after the renderer confirms that it completed.
+func (w *Window) FrameBatch(frames []*op.Ops, imgs []*image.RGBA) error {
+	if len(frames) != len(imgs) {
+		return errors.New("headless: the number of frames and images differ")
+	}
+	for _, img := range imgs {
+		if err := w.checkImage(img); err != nil {
+			return err
+		}
+	}
+	return w.thread.do(func() error {
+		pending := w.batch[:0]
+		defer func() {
+			// Recycle the readbacks of a failed batch.
+			w.readbacks = append(w.readbacks, pending...)
+			w.batch = pending[:0]
+		}()
+		for i, frame := range frames {
+			if err := w.frame(frame); err != nil {
+				return err
+			}
+			rb, err := w.startReadback()
+			if err != nil {
+				return err
+			}
+			pending = append(pending, rb)
+			if len(pending) < maxFramesInFlight && i < len(frames)-1 {
+				continue
+			}
+			// Wait for the oldest frame, or all of them after the last frame.
+			n := 1
+			if i == len(frames)-1 {
+				n = len(pending)
+			}
+			for j := 0; j < n; j++ {
+				rb := pending[0]
+				pending = append(pending[:0], pending[1:]...)
+				if err := w.finishReadback(rb, imgs[i-len(pending)]); err != nil {
+					return err
+				}
+			}
+		}
+		return nil
+	})
 }
 
-func contextDo(ctx context, f func() error) error {
-	errCh := make(chan error)
-	go func() {
-		runtime.LockOSThread()
-		defer runtime.UnlockOSThread()
-		if err := ctx.MakeCurrent(); err != nil {
-			errCh <- err
-			return
+func (w *Window) checkImage(img *image.RGBA) error {
+	r := img.Bounds()
+	if r.Size() != w.size || img.Stride != r.Dx()*4 {
+		return errors.New("headless: image doesn't match the window size")
+	}
+	return nil
+}
+
+// verify waits for the checks of the most recent frame, which is rendered
+// again if it turns out incomplete.
+func (w *Window) verify() error {
+	if !w.gpu.Pending() {
+		return nil
+	}
+	w.dev.BindFramebuffer(w.fbo)
+	_, err := w.gpu.Verify(true)
+	return err
+}
+
+// startReadback starts reading the window content into an idle readback.
+func (w *Window) startReadback() (*readback, error) {
+	if err := w.verify(); err != nil {
+		return nil, err
+	}
+	var rb *readback
+	if n := len(w.readbacks); n > 0 {
+		rb = w.readbacks[n-1]
+		w.readbacks = w.readbacks[:n-1]
+	} else {
+		rb = new(readback)
+	}
+	if rb.fence != nil {
+		// Left over from a failed FrameBatch.
+		rb.fence.Release()
+		rb.fence = nil
+	}
+	r := image.Rectangle{Max: w.size}
+	if !w.async {
+		if rb.pixels == nil {
+			rb.pixels = make([]byte, r.Dx()*r.Dy()*4)
+		}
+		if err := w.fbo.ReadPixels(r, rb.pixels); err != nil {
+			w.readbacks = append(w.readbacks, rb)
+			return nil, err
+		}
+		return rb, nil
+	}
+	if rb.buf == nil {
+		buf, err := w.dev.NewBuffer(driver.BufferBindingPixelPack, r.Dx()*r.Dy()*4)
+		if err != nil {
+			return nil, err
 		}
-		err := f()
-		ctx.ReleaseCurrent()
-		errCh <- err
+		rb.buf = buf
+	}
+	if err := w.fbo.ReadPixelsBuffer(r, rb.buf); err != nil {
+		w.readbacks = append(w.readbacks, rb)
+		return nil, err
+	}
+	rb.fence = w.dev.NewFence()
+	return rb, nil
+}
+
+// finishReadback copies the pixels of rb to img and makes rb idle.
+func (w *Window) finishReadback(rb *readback, img *image.RGBA) error {
+	defer func() {
+		w.readbacks = append(w.readbacks, rb)
 	}()
-	return <-errCh
+	if rb.fence != nil {
+		rb.fence.Release()
+		rb.fence = nil
+	}
+	if rb.buf == nil {
+		copy(img.Pix, rb.pixels)
+	} else if err := rb.buf.Download(img.Pix); err != nil {
+		return err
+	}
+	driver.FixOrigin(w.dev, img)
+	return nil
+}
+
+func (r *readback) release() {
+	if r.fence != nil {
+		r.fence.Release()
+	}
+	if r.buf != nil {
+		r.buf.Release()
+	}
+	*r = readback{}
+}
+
+func newRenderThread(ctx context) (*renderThread, error) {
+	t := &renderThread{
+		funcs:   make(chan func() error),
+		results: make(chan error),
+	}
+	go t.run(ctx)
+	if err := <-t.results; err != nil {
+		return nil, err
+	}
+	return t, nil
+}
+
+func (t *renderThread) run(ctx context) {
+	runtime.LockOSThread()
+	defer runtime.UnlockOSThread()
+	if err := ctx.MakeCurrent(); err != nil {
+		t.results <- err
+		return
+	}
+	t.results <- nil
+	for f := range t.funcs {
+		t.results <- f()
+	}
+	ctx.ReleaseCurrent()
+	t.results <- nil
+}
+
+// do runs f on the thread and returns its result.
+func (t *renderThread) do(f func() error) error {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	t.funcs <- f
+	return <-t.results
+}
+
+// release stops the thread after releasing its context.
+func (t *renderThread) release() {
+	t.mu.Lock()
+	defer t.mu.Unlock()
+	close(t.funcs)
+	<-t.results
 }
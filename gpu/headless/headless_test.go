@@ -40,6 +40,20 @@ func TestHeadless(t *testing.T) {
 	}
 }
 
+func TestFrameProfile(t *testing.T) {
+	w, release := newTestWindow(t)
+	defer release()
+
+	var ops op.Ops
+	paint.FillShape(&ops, color.NRGBA{A: 0xff}, clip.RRect{Rect: f32.Rect(10, 10, 50, 50), SE: 10}.Op(&ops))
+	if err := w.Frame(&ops); err != nil {
+		t.Fatal(err)
+	}
+	if p := w.FrameProfile(); p.UploadBytes == 0 {
+		t.Errorf("got %d uploaded bytes for the first frame, expected more", p.UploadBytes)
+	}
+}
+
 func TestClipping(t *testing.T) {
 	w, release := newTestWindow(t)
 	defer release()
@@ -143,3 +157,148 @@ func newTestWindow(t *testing.T) (*Window, func()) {
 		w.Release()
 	}
 }
+
+func TestScreenshotAsync(t *testing.T) {
+	w, release := newTestWindow(t)
+	defer release()
+
+	red := color.NRGBA{R: 0xFF, A: 0xFF}
+	blue := color.NRGBA{B: 0xFF, A: 0xFF}
+	var pending []*PendingScreenshot
+	for _, col := range []color.NRGBA{red, blue} {
+		var ops op.Ops
+		paint.FillShape(&ops, col, clip.Rect(image.Rect(0, 0, 100, 100)).Op())
+		if err := w.Frame(&ops); err != nil {
+			t.Fatal(err)
+		}
+		s, err := w.ScreenshotAsync()
+		if err != nil {
+			t.Fatal(err)
+		}
+		pending = append(pending, s)
+	}
+	img := image.NewRGBA(image.Rectangle{Max: w.size})
+	for i, col := range []color.NRGBA{red, blue} {
+		if err := pending[i].Wait(img); err != nil {
+			t.Fatal(err)
+		}
+		if got := img.RGBAAt(50, 50); got != f32color.NRGBAToRGBA(col) {
+			t.Errorf("screenshot %d: got color %v, expected %v", i, got, f32color.NRGBAToRGBA(col))
+		}
+		if got := img.RGBAAt(150, 150); got != (color.RGBA{}) {
+			t.Errorf("screenshot %d: got background %v, expected transparent", i, got)
+		}
+	}
+	if err := pending[0].Wait(img); err == nil {
+		t.Error("waiting twice for a screenshot succeeded")
+	}
+}
+
+func TestFrameBatch(t *testing.T) {
+	w, release := newTestWindow(t)
+	defer release()
+
+	const n = maxFramesInFlight*2 + 1
+	var frames []*op.Ops
+	var imgs []*image.RGBA
+	for i := 0; i < n; i++ {
+		ops := new(op.Ops)
+		paint.FillShape(ops, color.NRGBA{R: uint8(i * 16), A: 0xFF}, clip.Rect(image.Rect(0, 0, 100, 100)).Op())
+		frames = append(frames, ops)
+		imgs = append(imgs, image.NewRGBA(image.Rectangle{Max: w.size}))
+	}
+	if err := w.FrameBatch(frames, imgs); err != nil {
+		t.Fatal(err)
+	}
+	for i, img := range imgs {
+		exp := f32color.NRGBAToRGBA(color.NRGBA{R: uint8(i * 16), A: 0xFF})
+		if got := img.RGBAAt(50, 50); got != exp {
+			t.Errorf("frame %d: got color %v, expected %v", i, got, exp)
+		}
+	}
+	if err := w.FrameBatch(frames[:1], imgs); err == nil {
+		t.Error("FrameBatch accepted mismatched frames and images")
+	}
+}
+
+func TestSharedWindow(t *testing.T) {
+	w, release := newTestWindow(t)
+	defer release()
+	w2, err := NewSharedWindow(w, 200, 100)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer w2.Release()
+
+	im := image.NewRGBA(image.Rect(0, 0, 4, 4))
+	blue := color.NRGBA{B: 0xFF, A: 0xFF}
+	for i := range im.Pix {
+		im.Pix[i] = 0xFF
+		if i%4 == 0 || i%4 == 1 {
+			im.Pix[i] = 0
+		}
+	}
+	var ops op.Ops
+	paint.NewImageOp(im).Add(&ops)
+	clip.Rect(image.Rect(0, 0, 50, 50)).Add(&ops)
+	paint.PaintOp{}.Add(&ops)
+	for i := 0; i < 3; i++ {
+		for _, w := range []*Window{w, w2} {
+			if err := w.Frame(&ops); err != nil {
+				t.Fatal(err)
+			}
+			img, err := w.Screenshot()
+			if err != nil {
+				t.Fatal(err)
+			}
+			if got := img.RGBAAt(2, 2); got != f32color.NRGBAToRGBA(blue) {
+				t.Errorf("got color %v, expected %v", got, f32color.NRGBAToRGBA(blue))
+			}
+		}
+	}
+	// The remaining window must keep working.
+	w2.Release()
+	if err := w.Frame(&ops); err != nil {
+		t.Fatal(err)
+	}
+	if _, err := w.Screenshot(); err != nil {
+		t.Fatal(err)
+	}
+}
+
+func TestSharedWindowMutableImage(t *testing.T) {
+	w, release := newTestWindow(t)
+	defer release()
+	w2, err := NewSharedWindow(w, 200, 100)
+	if err != nil {
+		t.Fatal(err)
+	}
+	defer w2.Release()
+
+	m := paint.NewMutableImage(image.Pt(4, 4))
+	var ops op.Ops
+	m.Op().Add(&ops)
+	clip.Rect(image.Rect(0, 0, 50, 50)).Add(&ops)
+	paint.PaintOp{}.Add(&ops)
+	for _, col := range []color.NRGBA{{R: 0xFF, A: 0xFF}, {B: 0xFF, A: 0xFF}} {
+		rgba := m.RGBA()
+		for i := 0; i < len(rgba.Pix); i += 4 {
+			rgba.Pix[i], rgba.Pix[i+1], rgba.Pix[i+2], rgba.Pix[i+3] = col.R, col.G, col.B, col.A
+		}
+		m.Invalidate(rgba.Bounds())
+		// Every window must display the change, regardless of which
+		// window uploaded it.
+		for _, w := range []*Window{w, w2} {
+			if err := w.Frame(&ops); err != nil {
+				t.Fatal(err)
+			}
+			img, err := w.Screenshot()
+			if err != nil {
+				t.Fatal(err)
+			}
+			if got := img.RGBAAt(2, 2); got != f32color.NRGBAToRGBA(col) {
+				t.Errorf("got color %v, expected %v", got, f32color.NRGBAToRGBA(col))
+			}
+		}
+	}
+}
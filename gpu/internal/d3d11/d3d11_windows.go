@@ -187,6 +187,10 @@ func (b *Backend) NewTimer() driver.Timer {
 	panic("timers not supported")
 }
 
+func (b *Backend) NewFence() driver.Fence {
+	panic("fences not supported")
+}
+
 func (b *Backend) IsTimeContinuous() bool {
 	panic("timers not supported")
 }
@@ -398,12 +402,18 @@ func (b *Backend) NewComputeProgram(shader driver.ShaderSources) (driver.Program
 }
 
 func (b *Backend) NewProgram(vertexShader, fragmentShader driver.ShaderSources) (driver.Program, error) {
+	for _, src := range []driver.ShaderSources{vertexShader, fragmentShader} {
+		if src.HLSL == "" {
+			return nil, fmt.Errorf("NewProgram: no HLSL bytecode for %s", src.Name)
+		}
+	}
 	vs, err := b.dev.CreateVertexShader([]byte(vertexShader.HLSL))
 	if err != nil {
 		return nil, err
 	}
 	ps, err := b.dev.CreatePixelShader([]byte(fragmentShader.HLSL))
 	if err != nil {
+		d3d11.IUnknownRelease(unsafe.Pointer(vs), vs.Vtbl.Release)
 		return nil, err
 	}
 	p := &Program{backend: b}
@@ -552,6 +562,37 @@ func (b *Backend) DispatchCompute(x, y, z int) {
 	panic("not implemented")
 }
 
+func (b *Backend) BlitFramebuffer(dst, src driver.Framebuffer, srect, drect image.Rectangle) {
+	if srect.Size() != drect.Size() {
+		panic("BlitFramebuffer: scaling not supported")
+	}
+	box := &d3d11.BOX{
+		Left:   uint32(srect.Min.X),
+		Top:    uint32(srect.Min.Y),
+		Right:  uint32(srect.Max.X),
+		Bottom: uint32(srect.Max.Y),
+		Front:  0,
+		Back:   1,
+	}
+	dres := dst.(*Framebuffer).resource
+	sres := src.(*Framebuffer).resource
+	b.ctx.CopySubresourceRegion(dres, 0, uint32(drect.Min.X), uint32(drect.Min.Y), 0, sres, 0, box)
+}
+
+func (b *Backend) CopyBuffer(dst, src driver.Buffer, dstOffset, srcOffset, size int) {
+	box := &d3d11.BOX{
+		Left:   uint32(srcOffset),
+		Top:    0,
+		Right:  uint32(srcOffset + size),
+		Bottom: 1,
+		Front:  0,
+		Back:   1,
+	}
+	dres := (*d3d11.Resource)(unsafe.Pointer(dst.(*Buffer).buf))
+	sres := (*d3d11.Resource)(unsafe.Pointer(src.(*Buffer).buf))
+	b.ctx.CopySubresourceRegion(dres, 0, uint32(dstOffset), 0, 0, sres, 0, box)
+}
+
 func (t *Texture) Upload(offset, size image.Point, pixels []byte) {
 	stride := size.X * 4
 	dst := &d3d11.BOX{
@@ -624,11 +665,30 @@ func (b *Buffer) Upload(data []byte) {
 	b.backend.ctx.UpdateSubresource((*d3d11.Resource)(unsafe.Pointer(b.buf)), nil, 0, 0, data)
 }
 
+func (b *Buffer) UploadRange(offset int, data []byte) {
+	if b.bind&d3d11.BIND_CONSTANT_BUFFER != 0 {
+		panic("partial updates of constant buffers are not supported")
+	}
+	dst := &d3d11.BOX{
+		Left:   uint32(offset),
+		Top:    0,
+		Right:  uint32(offset + len(data)),
+		Bottom: 1,
+		Front:  0,
+		Back:   1,
+	}
+	b.backend.ctx.UpdateSubresource((*d3d11.Resource)(unsafe.Pointer(b.buf)), dst, 0, 0, data)
+}
+
 func (b *Buffer) Release() {
 	d3d11.IUnknownRelease(unsafe.Pointer(b.buf), b.buf.Vtbl.Release)
 	b.buf = nil
 }
 
+func (f *Framebuffer) ReadPixelsBuffer(src image.Rectangle, buf driver.Buffer) error {
+	return errors.New("ReadPixelsBuffer not supported")
+}
+
 func (f *Framebuffer) ReadPixels(src image.Rectangle, pixels []byte) error {
 	if f.resource == nil {
 		return errors.New("framebuffer does not support ReadPixels")
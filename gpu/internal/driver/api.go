@@ -23,6 +23,18 @@ type OpenGL struct {
 	// empty for all other platforms; an OpenGL context is assumed current when
 	// calling NewDevice.
 	Context gl.Context
+	// ProgramCache, if set, stores the compiled programs for skipping
+	// shader compilation the next time they are created.
+	ProgramCache ProgramCache
+}
+
+// ProgramCache stores compiled GPU programs. The keys identify the
+// program sources and the GPU driver.
+type ProgramCache interface {
+	// Get returns the data stored for key, or nil.
+	Get(key string) []byte
+	// Put stores data for key.
+	Put(key string, data []byte)
 }
 
 type Direct3D11 struct {
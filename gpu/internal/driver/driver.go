@@ -16,6 +16,9 @@ type Device interface {
 	EndFrame()
 	Caps() Caps
 	NewTimer() Timer
+	// NewFence inserts a fence after the commands issued so far. It
+	// requires FeatureFences.
+	NewFence() Fence
 	// IsContinuousTime reports whether all timer measurements
 	// are valid at the point of call.
 	IsTimeContinuous() bool
@@ -45,6 +48,12 @@ type Device interface {
 	BindVertexBuffer(b Buffer, stride, offset int)
 	BindIndexBuffer(b Buffer)
 	BindImageTexture(unit int, texture Texture, access AccessBits, format TextureFormat)
+	// BlitFramebuffer copies the srect rectangle of src into the drect
+	// rectangle of dst. The rectangles must have the same size.
+	BlitFramebuffer(dst, src Framebuffer, srect, drect image.Rectangle)
+	// CopyBuffer copies size bytes from srcOffset in src to dstOffset in
+	// dst.
+	CopyBuffer(dst, src Buffer, dstOffset, srcOffset, size int)
 
 	MemoryBarrier()
 	DispatchCompute(x, y, z int)
@@ -149,6 +158,9 @@ type Program interface {
 type Buffer interface {
 	Release()
 	Upload(data []byte)
+	// UploadRange replaces the buffer contents in the range
+	// [offset, offset+len(data)).
+	UploadRange(offset int, data []byte)
 	Download(data []byte) error
 }
 
@@ -156,6 +168,12 @@ type Framebuffer interface {
 	Invalidate()
 	Release()
 	ReadPixels(src image.Rectangle, pixels []byte) error
+	// ReadPixelsBuffer starts copying the pixels in src to buf without
+	// waiting for them. Use a Fence to determine when buf can be
+	// downloaded without blocking. The buffer must have the
+	// BufferBindingPixelPack binding, and ReadPixelsBuffer requires
+	// FeaturePixelPack.
+	ReadPixelsBuffer(src image.Rectangle, buf Buffer) error
 }
 
 type Timer interface {
@@ -165,6 +183,14 @@ type Timer interface {
 	Release()
 }
 
+// Fence tracks the completion of the commands issued before it.
+type Fence interface {
+	// Signaled reports whether the commands before the fence completed.
+	// Signaled does not block.
+	Signaled() bool
+	Release()
+}
+
 type Texture interface {
 	Upload(offset, size image.Point, pixels []byte)
 	Release()
@@ -188,6 +214,7 @@ const (
 	BufferBindingTexture
 	BufferBindingFramebuffer
 	BufferBindingShaderStorage
+	BufferBindingPixelPack
 )
 
 const (
@@ -210,6 +237,8 @@ const (
 	FeatureTimers Features = 1 << iota
 	FeatureFloatRenderTargets
 	FeatureCompute
+	FeatureFences
+	FeaturePixelPack
 )
 
 const (
@@ -232,15 +261,35 @@ func (f Features) Has(feats Features) bool {
 
 func DownloadImage(d Device, f Framebuffer, r image.Rectangle) (*image.RGBA, error) {
 	img := image.NewRGBA(r)
-	if err := f.ReadPixels(r, img.Pix); err != nil {
+	if err := ReadImage(d, f, img); err != nil {
 		return nil, err
 	}
+	return img, nil
+}
+
+// ReadImage reads the pixels of f inside the bounds of img into img. The
+// rows of img must be contiguous.
+func ReadImage(d Device, f Framebuffer, img *image.RGBA) error {
+	r := img.Bounds()
+	if img.Stride != r.Dx()*4 {
+		return errors.New("image rows are not contiguous")
+	}
+	if err := f.ReadPixels(r, img.Pix); err != nil {
+		return err
+	}
+	FixOrigin(d, img)
+	return nil
+}
+
+// FixOrigin flips img vertically if the pixels were read from a device
+// with its origin in the lower-left corner.
+func FixOrigin(d Device, img *image.RGBA) {
 	if d.Caps().BottomLeftOrigin {
 		// OpenGL origin is in the lower-left corner. Flip the image to
 		// match.
+		r := img.Bounds()
 		flipImageY(r.Dx()*4, r.Dy(), img.Pix)
 	}
-	return img, nil
 }
 
 func flipImageY(stride, height int, pixels []byte) {
@@ -259,12 +308,20 @@ func flipImageY(stride, height int, pixels []byte) {
 
 func UploadImage(t Texture, offset image.Point, img *image.RGBA) {
 	var pixels []byte
-	size := img.Bounds().Size()
-	if img.Stride != size.X*4 {
-		panic("unsupported stride")
+	b := img.Bounds()
+	size := b.Size()
+	start := img.PixOffset(b.Min.X, b.Min.Y)
+	if img.Stride == size.X*4 {
+		end := img.PixOffset(b.Max.X, b.Max.Y-1)
+		pixels = img.Pix[start:end]
+	} else {
+		// Pack the rows of a sub-image.
+		rowLen := size.X * 4
+		pixels = make([]byte, rowLen*size.Y)
+		for y := 0; y < size.Y; y++ {
+			row := start + y*img.Stride
+			copy(pixels[y*rowLen:], img.Pix[row:row+rowLen])
+		}
 	}
-	start := img.PixOffset(0, 0)
-	end := img.PixOffset(size.X, size.Y-1)
-	pixels = img.Pix[start:end]
 	t.Upload(offset, size, pixels)
 }
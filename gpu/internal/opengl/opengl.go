@@ -3,9 +3,13 @@
 package opengl
 
 import (
+	"crypto/sha256"
+	"encoding/binary"
+	"encoding/hex"
 	"errors"
 	"fmt"
 	"image"
+	"runtime"
 	"strings"
 	"time"
 	"unsafe"
@@ -36,6 +40,12 @@ type Backend struct {
 
 	sRGBFBO *SRGBFBO
 
+	// programs caches program binaries, or is nil if the driver
+	// doesn't support them. driverID identifies the driver in the
+	// cache keys.
+	programs driver.ProgramCache
+	driverID string
+
 	// vertArray is bound during a frame. We don't need it, but
 	// core desktop OpenGL profile 3.3 requires some array bound.
 	vertArray gl.VertexArray
@@ -66,6 +76,7 @@ type glState struct {
 	uniBufs   [2]gl.Buffer
 	storeBuf  gl.Buffer
 	storeBufs [4]gl.Buffer
+	packBuf   gl.Buffer
 	vertArray gl.VertexArray
 	depthMask bool
 	depthFunc gl.Enum
@@ -114,6 +125,11 @@ type gpuFramebuffer struct {
 	foreign  bool
 }
 
+type gpuFence struct {
+	backend *Backend
+	obj     gl.Sync
+}
+
 type gpuBuffer struct {
 	backend   *Backend
 	hasBuffer bool
@@ -187,6 +203,7 @@ func newOpenGLDevice(api driver.OpenGL) (driver.Device, error) {
 	}
 	gles30 := gles && ver[0] >= 3
 	gles31 := gles && (ver[0] > 3 || (ver[0] == 3 && ver[1] >= 1))
+	gl32 := !gles && (ver[0] > 3 || (ver[0] == 3 && ver[1] >= 2))
 	gl40 := !gles && ver[0] >= 4
 	b := &Backend{
 		glver:       ver,
@@ -204,9 +221,23 @@ func newOpenGLDevice(api driver.OpenGL) (driver.Device, error) {
 	if gles31 {
 		b.feats.Features |= driver.FeatureCompute
 	}
+	if gles30 || gl32 {
+		b.feats.Features |= driver.FeatureFences
+	}
+	// WebGL can't map buffers for downloading the pixels.
+	if (gles30 || !gles) && runtime.GOOS != "js" {
+		b.feats.Features |= driver.FeaturePixelPack
+	}
 	if hasExtension(exts, "GL_EXT_disjoint_timer_query_webgl2") || hasExtension(exts, "GL_EXT_disjoint_timer_query") {
 		b.feats.Features |= driver.FeatureTimers
 	}
+	gl41 := !gles && (ver[0] > 4 || (ver[0] == 4 && ver[1] >= 1))
+	if api.ProgramCache != nil && runtime.GOOS != "js" && (gles30 || gl41 || hasExtension(exts, "GL_ARB_get_program_binary")) {
+		if f.GetInteger(gl.NUM_PROGRAM_BINARY_FORMATS) > 0 {
+			b.programs = api.ProgramCache
+			b.driverID = strings.Join([]string{f.GetString(gl.VENDOR), f.GetString(gl.RENDERER), glVer}, "\x00")
+		}
+	}
 	b.feats.MaxTextureSize = f.GetInteger(gl.MAX_TEXTURE_SIZE)
 	return b, nil
 }
@@ -294,6 +325,7 @@ func (b *Backend) queryState() glState {
 		s.vertArray = gl.VertexArray(b.funcs.GetBinding(gl.VERTEX_ARRAY_BINDING))
 		s.readFBO = gl.Framebuffer(b.funcs.GetBinding(gl.READ_FRAMEBUFFER_BINDING))
 		s.uniBuf = gl.Buffer(b.funcs.GetBinding(gl.UNIFORM_BUFFER_BINDING))
+		s.packBuf = gl.Buffer(b.funcs.GetBinding(gl.PIXEL_PACK_BUFFER_BINDING))
 		for i := range s.uniBufs {
 			s.uniBufs[i] = gl.Buffer(b.funcs.GetBindingi(gl.UNIFORM_BUFFER_BINDING, i))
 		}
@@ -347,6 +379,7 @@ func (b *Backend) restoreState(dst glState) {
 		src.bindBufferBase(f, gl.SHADER_STORAGE_BUFFER, i, b)
 	}
 	src.bindBuffer(f, gl.SHADER_STORAGE_BUFFER, dst.storeBuf)
+	src.bindBuffer(f, gl.PIXEL_PACK_BUFFER, dst.packBuf)
 	src.setDepthMask(f, dst.depthMask)
 	src.setClearDepth(f, dst.clearDepth)
 	col := dst.clearColor
@@ -553,6 +586,11 @@ func (s *glState) bindBuffer(f *gl.Functions, target gl.Enum, buf gl.Buffer) {
 			return
 		}
 		s.storeBuf = buf
+	case gl.PIXEL_PACK_BUFFER:
+		if buf.Equal(s.packBuf) {
+			return
+		}
+		s.packBuf = buf
 	default:
 		panic("unknown buffer target")
 	}
@@ -922,8 +960,48 @@ func (b *Backend) NewInputLayout(vs driver.ShaderSources, layout []driver.InputD
 	}, nil
 }
 
+// createProgram loads the program for the shader sources and
+// attributes from the program cache, or creates and caches it.
+func (b *Backend) createProgram(srcs, attribs []string, create func() (gl.Program, error)) (gl.Program, error) {
+	if b.programs == nil {
+		return create()
+	}
+	h := sha256.New()
+	h.Write([]byte(b.driverID))
+	for _, strs := range [][]string{srcs, attribs} {
+		for _, s := range strs {
+			h.Write([]byte{0})
+			h.Write([]byte(s))
+		}
+	}
+	key := hex.EncodeToString(h.Sum(nil))
+	// The cached data is the binary format followed by the binary.
+	if data := b.programs.Get(key); len(data) > 4 {
+		format := gl.Enum(binary.LittleEndian.Uint32(data))
+		if p, err := gl.CreateProgramBinary(b.funcs, format, data[4:]); err == nil {
+			return p, nil
+		}
+		// Clear the error of rejected formats.
+		b.funcs.GetError()
+	}
+	p, err := create()
+	if err != nil {
+		return p, err
+	}
+	// Drivers may report empty binaries for programs they can't save.
+	if bin, format := b.funcs.GetProgramBinary(p); len(bin) > 0 && format != 0 {
+		data := make([]byte, 4+len(bin))
+		binary.LittleEndian.PutUint32(data, uint32(format))
+		copy(data[4:], bin)
+		b.programs.Put(key, data)
+	}
+	return p, nil
+}
+
 func (b *Backend) NewComputeProgram(src driver.ShaderSources) (driver.Program, error) {
-	p, err := gl.CreateComputeProgram(b.funcs, src.GLSL310ES)
+	p, err := b.createProgram([]string{src.GLSL310ES}, nil, func() (gl.Program, error) {
+		return gl.CreateComputeProgram(b.funcs, src.GLSL310ES, b.programs != nil)
+	})
 	if err != nil {
 		return nil, fmt.Errorf("%s: %v", src.Name, err)
 	}
@@ -952,7 +1030,9 @@ func (b *Backend) NewProgram(vertShader, fragShader driver.ShaderSources) (drive
 			vsrc, fsrc = vertShader.GLSL130, fragShader.GLSL130
 		}
 	}
-	p, err := gl.CreateProgram(b.funcs, vsrc, fsrc, attr)
+	p, err := b.createProgram([]string{vsrc, fsrc}, attr, func() (gl.Program, error) {
+		return gl.CreateProgram(b.funcs, vsrc, fsrc, attr, b.programs != nil)
+	})
 	if err != nil {
 		return nil, err
 	}
@@ -1121,6 +1201,24 @@ func (b *gpuBuffer) Upload(data []byte) {
 	}
 }
 
+func (b *gpuBuffer) UploadRange(offset int, data []byte) {
+	if b.immutable {
+		panic("immutable buffer")
+	}
+	if offset < 0 || offset+len(data) > b.size {
+		panic("buffer size overflow")
+	}
+	b.version++
+	if b.data != nil {
+		copy(b.data[offset:], data)
+	}
+	if b.hasBuffer {
+		firstBinding := firstBufferType(b.typ)
+		b.backend.glstate.bindBuffer(b.backend.funcs, firstBinding, b.obj)
+		b.backend.funcs.BufferSubData(firstBinding, offset, data)
+	}
+}
+
 func (b *gpuBuffer) Download(data []byte) error {
 	if len(data) > b.size {
 		panic("buffer size overflow")
@@ -1202,16 +1300,66 @@ func (b *Backend) BlitFramebuffer(dst, src driver.Framebuffer, srect, drect imag
 		gl.NEAREST)
 }
 
+func (b *Backend) CopyBuffer(dst, src driver.Buffer, dstOffset, srcOffset, size int) {
+	dbuf, sbuf := dst.(*gpuBuffer), src.(*gpuBuffer)
+	if !dbuf.hasBuffer || !sbuf.hasBuffer {
+		panic("CopyBuffer: emulated buffers not supported")
+	}
+	// The copy targets are not tracked by glState; unbind them after use.
+	b.funcs.BindBuffer(gl.COPY_READ_BUFFER, sbuf.obj)
+	b.funcs.BindBuffer(gl.COPY_WRITE_BUFFER, dbuf.obj)
+	b.funcs.CopyBufferSubData(gl.COPY_READ_BUFFER, gl.COPY_WRITE_BUFFER, srcOffset, dstOffset, size)
+	b.funcs.BindBuffer(gl.COPY_READ_BUFFER, gl.Buffer{})
+	b.funcs.BindBuffer(gl.COPY_WRITE_BUFFER, gl.Buffer{})
+}
+
+func (b *Backend) NewFence() driver.Fence {
+	return &gpuFence{backend: b, obj: b.funcs.FenceSync(gl.SYNC_GPU_COMMANDS_COMPLETE, 0)}
+}
+
+func (f *gpuFence) Signaled() bool {
+	switch f.backend.funcs.ClientWaitSync(f.obj, gl.SYNC_FLUSH_COMMANDS_BIT, 0) {
+	case gl.ALREADY_SIGNALED, gl.CONDITION_SATISFIED:
+		return true
+	default:
+		return false
+	}
+}
+
+func (f *gpuFence) Release() {
+	f.backend.funcs.DeleteSync(f.obj)
+}
+
 func (f *gpuFramebuffer) ReadPixels(src image.Rectangle, pixels []byte) error {
 	glErr(f.backend.funcs)
 	f.backend.BindFramebuffer(f)
 	if len(pixels) < src.Dx()*src.Dy()*4 {
 		return errors.New("unexpected RGBA size")
 	}
+	// A bound pixel pack buffer would receive the pixels instead.
+	f.backend.glstate.bindBuffer(f.backend.funcs, gl.PIXEL_PACK_BUFFER, gl.Buffer{})
 	f.backend.funcs.ReadPixels(src.Min.X, src.Min.Y, src.Dx(), src.Dy(), gl.RGBA, gl.UNSIGNED_BYTE, pixels)
 	return glErr(f.backend.funcs)
 }
 
+func (f *gpuFramebuffer) ReadPixelsBuffer(src image.Rectangle, buffer driver.Buffer) error {
+	buf := buffer.(*gpuBuffer)
+	if buf.typ&driver.BufferBindingPixelPack == 0 {
+		panic("not a pixel pack buffer")
+	}
+	if buf.size < src.Dx()*src.Dy()*4 {
+		return errors.New("unexpected RGBA size")
+	}
+	glErr(f.backend.funcs)
+	f.backend.BindFramebuffer(f)
+	f.backend.glstate.bindBuffer(f.backend.funcs, gl.PIXEL_PACK_BUFFER, buf.obj)
+	// With a pixel pack buffer bound, the pixels are stored at offset 0
+	// in the buffer.
+	f.backend.funcs.ReadPixels(src.Min.X, src.Min.Y, src.Dx(), src.Dy(), gl.RGBA, gl.UNSIGNED_BYTE, nil)
+	f.backend.glstate.bindBuffer(f.backend.funcs, gl.PIXEL_PACK_BUFFER, gl.Buffer{})
+	return glErr(f.backend.funcs)
+}
+
 func (b *Backend) BindFramebuffer(fbo driver.Framebuffer) {
 	b.glstate.bindFramebuffer(b.funcs, gl.FRAMEBUFFER, fbo.(*gpuFramebuffer).obj)
 }
@@ -1374,6 +1522,8 @@ func firstBufferType(typ driver.BufferBinding) gl.Enum {
 		return gl.UNIFORM_BUFFER
 	case typ&driver.BufferBindingShaderStorage != 0:
 		return gl.SHADER_STORAGE_BUFFER
+	case typ&driver.BufferBindingPixelPack != 0:
+		return gl.PIXEL_PACK_BUFFER
 	default:
 		panic("unsupported buffer type")
 	}
@@ -62,7 +62,7 @@ func NewSRGBFBO(f *gl.Functions, state *glState) (*SRGBFBO, error) {
 
 func (s *SRGBFBO) Blit() {
 	if !s.blitted {
-		prog, err := gl.CreateProgram(s.c, blitVSrc, blitFSrc, []string{"pos", "uv"})
+		prog, err := gl.CreateProgram(s.c, blitVSrc, blitFSrc, []string{"pos", "uv"}, false)
 		if err != nil {
 			panic(err)
 		}
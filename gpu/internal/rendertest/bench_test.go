@@ -1,18 +1,23 @@
 package rendertest
 
 import (
+	"fmt"
 	"image"
 	"image/color"
 	"math"
+	"os"
 	"testing"
+	"time"
 
 	"gioui.org/f32"
 	"gioui.org/font/gofont"
 	"gioui.org/gpu/headless"
+	"gioui.org/io/profile"
 	"gioui.org/layout"
 	"gioui.org/op"
 	"gioui.org/op/clip"
 	"gioui.org/op/paint"
+	"gioui.org/unit"
 	"gioui.org/widget/material"
 )
 
@@ -150,6 +155,305 @@ func Benchmark1000CirclesInstanced(b *testing.B) {
 	finishBenchmark(b, w)
 }
 
+// The BenchmarkRenderer benchmarks run every scene with both renderers
+// and report the frame profiles in addition to the time and
+// allocations per frame:
+//
+//	collect-ns/op   CPU time collecting the operations.
+//	encode-ns/op    CPU time encoding the operations.
+//	upload-B/op     Bytes uploaded to the GPU.
+//	gpu-ns/op       GPU time, if the GPU has timers.
+//	<stage>-ns/op   GPU time of each rendering stage.
+//
+// The results are in the standard benchmark format, for comparison
+// with tools such as benchstat.
+
+// benchRenderers are the renderers selected by GIORENDERER.
+var benchRenderers = []struct {
+	name, env string
+}{
+	{"stencil", ""},
+	{"compute", "forcecompute"},
+}
+
+// benchProfiler is the tag of the profile.Op added to the benchmark frames,
+// to enable the GPU timers.
+var benchProfiler = new(int)
+
+// benchmarkRenderers benchmarks the frames drawn by draw with every renderer.
+func benchmarkRenderers(b *testing.B, size image.Point, draw func(gtx layout.Context, frame int)) {
+	for _, r := range benchRenderers {
+		r := r
+		b.Run(r.name, func(b *testing.B) {
+			benchmarkFrames(b, newRendererWindow(b, r.env, size), size, draw)
+		})
+	}
+}
+
+// newRendererWindow creates a window for the renderer selected by
+// the GIORENDERER value env.
+func newRendererWindow(b *testing.B, env string, size image.Point) *headless.Window {
+	old, set := os.LookupEnv("GIORENDERER")
+	defer func() {
+		if set {
+			os.Setenv("GIORENDERER", old)
+		} else {
+			os.Unsetenv("GIORENDERER")
+		}
+	}()
+	os.Setenv("GIORENDERER", env)
+	return newWindow(b, size.X, size.Y)
+}
+
+func benchmarkFrames(b *testing.B, w *headless.Window, size image.Point, draw func(gtx layout.Context, frame int)) {
+	gtx := layout.Context{
+		Ops:         new(op.Ops),
+		Constraints: layout.Exact(size),
+	}
+	frame := func(i int) {
+		gtx.Ops.Reset()
+		profile.Op{Tag: benchProfiler}.Add(gtx.Ops)
+		draw(gtx, i)
+		if err := w.Frame(gtx.Ops); err != nil {
+			b.Fatal(err)
+		}
+	}
+	// Warm up the caches of the first frame.
+	frame(0)
+	var st benchStats
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		frame(i + 1)
+		st.add(w.FrameProfile())
+	}
+	b.StopTimer()
+	st.report(b)
+	finishBenchmark(b, w)
+}
+
+// benchStats accumulates the frame profiles of a benchmark.
+type benchStats struct {
+	frames          int
+	collect, encode time.Duration
+	uploadBytes     int
+	// gpuFrames counts the profiles with GPU timings, which
+	// lag the frames.
+	gpuFrames int
+	stages    []string
+	stageDurs map[string]time.Duration
+}
+
+func (s *benchStats) add(p profile.Frame) {
+	s.frames++
+	s.collect += p.Collect
+	s.encode += p.Encode
+	s.uploadBytes += p.UploadBytes
+	if len(p.Stages) == 0 {
+		return
+	}
+	s.gpuFrames++
+	if s.stageDurs == nil {
+		s.stageDurs = make(map[string]time.Duration)
+	}
+	for _, st := range p.Stages {
+		if _, exists := s.stageDurs[st.Name]; !exists {
+			s.stages = append(s.stages, st.Name)
+		}
+		s.stageDurs[st.Name] += st.Duration
+	}
+}
+
+func (s *benchStats) report(b *testing.B) {
+	if s.frames == 0 {
+		return
+	}
+	n := float64(s.frames)
+	b.ReportMetric(float64(s.collect.Nanoseconds())/n, "collect-ns/op")
+	b.ReportMetric(float64(s.encode.Nanoseconds())/n, "encode-ns/op")
+	b.ReportMetric(float64(s.uploadBytes)/n, "upload-B/op")
+	if s.gpuFrames == 0 {
+		return
+	}
+	n = float64(s.gpuFrames)
+	var total time.Duration
+	for _, name := range s.stages {
+		d := s.stageDurs[name]
+		total += d
+		b.ReportMetric(float64(d.Nanoseconds())/n, name+"-ns/op")
+	}
+	b.ReportMetric(float64(total.Nanoseconds())/n, "gpu-ns/op")
+}
+
+// benchSize is the viewport size of the renderer benchmarks.
+var benchSize = image.Pt(1024, 1200)
+
+func BenchmarkRendererShapes(b *testing.B) {
+	// Rounded rectangles, each in a separate path that can't be cached
+	// between frames. Frames are limited to 65k paint operations
+	// (gioui.org/issue/127).
+	for _, n := range []int{1e2, 1e3, 1e4, 6e4} {
+		n := n
+		b.Run(fmt.Sprintf("%d", n), func(b *testing.B) {
+			benchmarkRenderers(b, benchSize, func(gtx layout.Context, frame int) {
+				drawShapeGrid(gtx.Ops, benchSize, n)
+			})
+		})
+	}
+}
+
+func BenchmarkRendererSegments(b *testing.B) {
+	// A hundred filled paths with n line segments in total, for
+	// scenes larger than the paint operation limit of
+	// BenchmarkRendererShapes.
+	for _, n := range []int{1e4, 1e5, 1e6} {
+		n := n
+		b.Run(fmt.Sprintf("%d", n), func(b *testing.B) {
+			benchmarkRenderers(b, benchSize, func(gtx layout.Context, frame int) {
+				drawZigzags(gtx.Ops, benchSize, 100, n/100)
+			})
+		})
+	}
+}
+
+func BenchmarkRendererText(b *testing.B) {
+	// Text in several sizes, filling the viewport.
+	th := material.NewTheme(gofont.Collection())
+	benchmarkRenderers(b, benchSize, func(gtx layout.Context, frame int) {
+		gtx.Constraints.Min = image.Point{}
+		y := 0
+		for i := 0; i < 1000 && y < benchSize.Y; i++ {
+			p := op.Save(gtx.Ops)
+			op.Offset(f32.Pt(0, float32(y))).Add(gtx.Ops)
+			l := material.Label(th, unit.Sp(float32(10+i%4*4)), textRows[i%len(textRows)])
+			dims := l.Layout(gtx)
+			p.Load()
+			y += dims.Size.Y
+		}
+	})
+}
+
+func BenchmarkRendererImages(b *testing.B) {
+	// Images drawn from a pool twice their count, evicting and
+	// re-uploading a quarter of them every frame.
+	for _, n := range []int{10, 100, 1000} {
+		n := n
+		b.Run(fmt.Sprintf("%d", n), func(b *testing.B) {
+			imgs := make([]paint.ImageOp, 2*n)
+			for i := range imgs {
+				img := image.NewRGBA(image.Rect(0, 0, 32, 32))
+				col := color.RGBA{R: uint8(i), G: uint8(i >> 8), B: 0x80, A: 0xff}
+				for j := 0; j < len(img.Pix); j += 4 {
+					img.Pix[j], img.Pix[j+1], img.Pix[j+2], img.Pix[j+3] = col.R, col.G, col.B, col.A
+				}
+				imgs[i] = paint.NewImageOp(img)
+			}
+			cols := benchSize.X / 32
+			benchmarkRenderers(b, benchSize, func(gtx layout.Context, frame int) {
+				start := frame * n / 4
+				for i := 0; i < n; i++ {
+					p := op.Save(gtx.Ops)
+					op.Offset(f32.Pt(float32(i%cols*32), float32(i/cols%(benchSize.Y/32)*32))).Add(gtx.Ops)
+					imgs[(start+i)%len(imgs)].Add(gtx.Ops)
+					paint.PaintOp{}.Add(gtx.Ops)
+					p.Load()
+				}
+			})
+		})
+	}
+}
+
+func BenchmarkRendererClipDepth(b *testing.B) {
+	// A grid of stacks of nested rounded rectangle clips.
+	for _, depth := range []int{1, 10, 100} {
+		depth := depth
+		b.Run(fmt.Sprintf("%d", depth), func(b *testing.B) {
+			benchmarkRenderers(b, benchSize, func(gtx layout.Context, frame int) {
+				const cell = 128
+				for y := 0; y+cell <= benchSize.Y; y += cell {
+					for x := 0; x+cell <= benchSize.X; x += cell {
+						p := op.Save(gtx.Ops)
+						op.Offset(f32.Pt(float32(x), float32(y))).Add(gtx.Ops)
+						for d := 0; d < depth; d++ {
+							inset := float32(d) * cell / 2 / float32(depth)
+							r := f32.Rect(inset, inset, cell-inset, cell-inset)
+							clip.RRect{Rect: r, NE: 8, SE: 8, SW: 8, NW: 8}.Add(gtx.Ops)
+						}
+						paint.ColorOp{Color: color.NRGBA{R: uint8(x), G: uint8(y), B: 0x80, A: 0xff}}.Add(gtx.Ops)
+						paint.PaintOp{}.Add(gtx.Ops)
+						p.Load()
+					}
+				}
+			})
+		})
+	}
+}
+
+func BenchmarkRendererAnimated(b *testing.B) {
+	// Instanced circles, rotated and scaled differently every frame.
+	benchmarkRenderers(b, benchSize, func(gtx layout.Context, frame int) {
+		center := layout.FPt(benchSize).Mul(.5)
+		angle := float32(frame) * 0.01
+		scale := 1 + 0.1*float32(math.Sin(float64(frame)*0.1))
+		a := f32.Affine2D{}.Rotate(center, angle).Scale(center, f32.Pt(scale, scale))
+		op.Affine(a).Add(gtx.Ops)
+		draw1000CirclesInstanced(gtx)
+	})
+}
+
+func BenchmarkRendererViewport(b *testing.B) {
+	// The shapes and text of BenchmarkDrawUI in viewports of
+	// increasing size.
+	th := material.NewTheme(gofont.Collection())
+	for _, sz := range []int{256, 1024, 2048, 4096} {
+		size := image.Pt(sz, sz)
+		b.Run(fmt.Sprintf("%dx%d", sz, sz), func(b *testing.B) {
+			benchmarkRenderers(b, size, func(gtx layout.Context, frame int) {
+				op1.Reset()
+				op2.Reset()
+				op3.Reset()
+				drawCore(gtx, th)
+			})
+		})
+	}
+}
+
+// drawShapeGrid draws n rounded rectangles in a grid covering size.
+func drawShapeGrid(ops *op.Ops, size image.Point, n int) {
+	cols := int(math.Ceil(math.Sqrt(float64(n) * float64(size.X) / float64(size.Y))))
+	cell := float32(size.X) / float32(cols)
+	r := cell / 4
+	for i := 0; i < n; i++ {
+		x, y := i%cols, i/cols
+		p := op.Save(ops)
+		op.Offset(f32.Pt(float32(x)*cell, float32(y)*cell)).Add(ops)
+		paint.FillShape(ops,
+			color.NRGBA{R: uint8(x), G: uint8(y), B: 100, A: 200},
+			clip.RRect{Rect: f32.Rect(0, 0, cell*.8, cell*.8), NE: r, SE: r, SW: r, NW: r}.Op(ops),
+		)
+		p.Load()
+	}
+}
+
+// drawZigzags fills the given number of rows of size, each with a top
+// edge of segs line segments.
+func drawZigzags(ops *op.Ops, size image.Point, paths, segs int) {
+	h := float32(size.Y) / float32(paths)
+	dx := float32(size.X) / float32(segs)
+	for i := 0; i < paths; i++ {
+		y := float32(i) * h
+		var p clip.Path
+		p.Begin(ops)
+		p.MoveTo(f32.Pt(0, y+h))
+		for j := 0; j < segs; j++ {
+			p.LineTo(f32.Pt(float32(j)*dx, y+float32(j%2)*h/2))
+		}
+		p.LineTo(f32.Pt(float32(size.X), y+h))
+		p.Close()
+		paint.FillShape(ops, color.NRGBA{R: uint8(i), G: 0x80, B: 0x80, A: 0xff}, clip.Outline{Path: p.End()}.Op())
+	}
+}
+
 func draw1000Circles(gtx layout.Context) {
 	ops := gtx.Ops
 	for x := 0; x < 100; x++ {
@@ -3,6 +3,7 @@ package rendertest
 import (
 	"image"
 	"image/color"
+	"image/draw"
 	"math"
 	"testing"
 
@@ -223,6 +224,79 @@ func TestNegativeOverlaps(t *testing.T) {
 	})
 }
 
+func TestMutableImage(t *testing.T) {
+	img := paint.NewMutableImage(image.Pt(128, 128))
+	draw.Draw(img.RGBA(), img.RGBA().Bounds(), image.NewUniform(colornames.Red), image.Point{}, draw.Src)
+	paintImage := func(ops *op.Ops) {
+		clip.Rect{Max: image.Pt(128, 128)}.Add(ops)
+		img.Op().Add(ops)
+		paint.PaintOp{}.Add(ops)
+	}
+	multiRun(t,
+		frame(paintImage, func(r result) {
+			r.expect(32, 32, colornames.Red)
+			r.expect(96, 96, colornames.Red)
+		}),
+		frame(func(ops *op.Ops) {
+			dirty := image.Rect(0, 0, 64, 64)
+			draw.Draw(img.RGBA(), dirty, image.NewUniform(colornames.Green), image.Point{}, draw.Src)
+			img.Invalidate(dirty)
+			paintImage(ops)
+		}, func(r result) {
+			r.expect(32, 32, colornames.Green)
+			r.expect(96, 32, colornames.Red)
+			r.expect(96, 96, colornames.Red)
+		}),
+		frame(paintImage, func(r result) {
+			r.expect(32, 32, colornames.Green)
+			r.expect(96, 96, colornames.Red)
+		}))
+}
+
+func TestMutableImageReplay(t *testing.T) {
+	img := paint.NewMutableImage(image.Pt(128, 128))
+	draw.Draw(img.RGBA(), img.RGBA().Bounds(), image.NewUniform(colornames.Red), image.Point{}, draw.Src)
+	// The image is drawn by a macro recorded once, as by a cache of
+	// operation lists.
+	cache := new(op.Ops)
+	macro := op.Record(cache)
+	clip.Rect{Max: image.Pt(128, 128)}.Add(cache)
+	img.Op().Add(cache)
+	paint.PaintOp{}.Add(cache)
+	call := macro.Stop()
+	multiRun(t,
+		frame(func(ops *op.Ops) {
+			call.Add(ops)
+		}, func(r result) {
+			r.expect(32, 32, colornames.Red)
+		}),
+		frame(func(ops *op.Ops) {
+			dirty := image.Rect(0, 0, 64, 64)
+			draw.Draw(img.RGBA(), dirty, image.NewUniform(colornames.Green), image.Point{}, draw.Src)
+			img.Invalidate(dirty)
+			call.Add(ops)
+		}, func(r result) {
+			r.expect(32, 32, colornames.Green)
+			r.expect(96, 96, colornames.Red)
+		}),
+		frame(func(ops *op.Ops) {
+			// Change the image without drawing it; the unused
+			// ImageOp must not lose the change.
+			dirty := image.Rect(64, 64, 128, 128)
+			draw.Draw(img.RGBA(), dirty, image.NewUniform(colornames.Blue), image.Point{}, draw.Src)
+			img.Invalidate(dirty)
+			img.Op()
+		}, func(r result) {
+			r.expect(32, 32, transparent)
+		}),
+		frame(func(ops *op.Ops) {
+			call.Add(ops)
+		}, func(r result) {
+			r.expect(32, 32, colornames.Green)
+			r.expect(96, 96, colornames.Blue)
+		}))
+}
+
 func TestDepthOverlap(t *testing.T) {
 	run(t, func(ops *op.Ops) {
 		stack := op.Save(ops)
@@ -359,3 +433,19 @@ func lerp(a, b f32color.RGBA, p float32) f32color.RGBA {
 		A: a.A*(1-p) + b.A*p,
 	}
 }
+
+func TestPaintOffsetImages(t *testing.T) {
+	run(t, func(o *op.Ops) {
+		for i := 0; i < 4; i++ {
+			stack := op.Save(o)
+			op.Offset(f32.Pt(float32(i*32), float32(i*32))).Add(o)
+			smallSquares.Add(o)
+			paint.PaintOp{}.Add(o)
+			stack.Load()
+		}
+	}, func(r result) {
+		r.expect(0, 0, colornames.Blue)
+		r.expect(32, 32, colornames.Blue)
+		r.expect(96, 0, transparent)
+	})
+}
@@ -8,12 +8,32 @@ import (
 
 // packer packs a set of many smaller rectangles into
 // much fewer larger atlases.
+//
+// Each atlas is packed with the skyline algorithm: the allocated area is
+// bounded above by a skyline, and a rectangle is placed on the skyline
+// where its top is the lowest. Space wasted below the skyline and space
+// returned by free is kept in a list of free rectangles, which are tried
+// first.
 type packer struct {
 	maxDim int
-	spaces []image.Rectangle
+	pages  []packerPage
 
 	sizes []image.Point
-	pos   image.Point
+	// used is the area of the added rectangles.
+	used int
+}
+
+// packerPage tracks the free space of an atlas.
+type packerPage struct {
+	// skyline is the top edge of the allocated area, as segments ordered
+	// by x and covering the atlas width.
+	skyline []skylineSegment
+	// spaces are free rectangles below the skyline.
+	spaces []image.Rectangle
+}
+
+type skylineSegment struct {
+	x, y, width int
 }
 
 type placement struct {
@@ -33,53 +53,172 @@ func (p *packer) add(s image.Point) (placement, bool) {
 
 func (p *packer) clear() {
 	p.sizes = p.sizes[:0]
-	p.spaces = p.spaces[:0]
+	p.pages = p.pages[:0]
+	p.used = 0
+}
+
+// usage returns the area used by rectangles and the total area of the
+// atlases.
+func (p *packer) usage() (used, size int) {
+	return p.used, len(p.sizes) * p.maxDim * p.maxDim
+}
+
+// free returns the space of a rectangle previously allocated in
+// page idx.
+func (p *packer) free(idx int, r image.Rectangle) {
+	pg := &p.pages[idx]
+	pg.spaces = append(pg.spaces, r)
+	p.used -= r.Dx() * r.Dy()
 }
 
 func (p *packer) newPage() {
-	p.pos = image.Point{}
 	p.sizes = append(p.sizes, image.Point{})
-	p.spaces = p.spaces[:0]
-	p.spaces = append(p.spaces, image.Rectangle{
-		Max: image.Point{X: p.maxDim, Y: p.maxDim},
-	})
+	// Re-use the memory of cleared pages.
+	n := len(p.pages)
+	if n < cap(p.pages) {
+		p.pages = p.pages[:n+1]
+	} else {
+		p.pages = append(p.pages, packerPage{})
+	}
+	pg := &p.pages[n]
+	pg.spaces = pg.spaces[:0]
+	pg.skyline = append(pg.skyline[:0], skylineSegment{width: p.maxDim})
 }
 
+// tryAdd places a rectangle in the first atlas with room for it.
 func (p *packer) tryAdd(s image.Point) (placement, bool) {
+	for idx := range p.pages {
+		pg := &p.pages[idx]
+		pos, ok := pg.trySpaces(s)
+		if !ok {
+			pos, ok = pg.trySkyline(p.maxDim, s)
+		}
+		if !ok {
+			continue
+		}
+		size := &p.sizes[idx]
+		if x := pos.X + s.X; x > size.X {
+			size.X = x
+		}
+		if y := pos.Y + s.Y; y > size.Y {
+			size.Y = y
+		}
+		p.used += s.X * s.Y
+		return placement{Idx: idx, Pos: pos}, true
+	}
+	return placement{}, false
+}
+
+// trySpaces places a rectangle in one of the free spaces, splitting the
+// remaining space in (at most) two smaller spaces.
+func (pg *packerPage) trySpaces(s image.Point) (image.Point, bool) {
 	// Go backwards to prioritize smaller spaces first.
-	for i := len(p.spaces) - 1; i >= 0; i-- {
-		space := p.spaces[i]
+	for i := len(pg.spaces) - 1; i >= 0; i-- {
+		space := pg.spaces[i]
 		rightSpace := space.Dx() - s.X
 		bottomSpace := space.Dy() - s.Y
 		if rightSpace >= 0 && bottomSpace >= 0 {
 			// Remove space.
-			p.spaces[i] = p.spaces[len(p.spaces)-1]
-			p.spaces = p.spaces[:len(p.spaces)-1]
+			pg.spaces[i] = pg.spaces[len(pg.spaces)-1]
+			pg.spaces = pg.spaces[:len(pg.spaces)-1]
 			// Put s in the top left corner and add the (at most)
 			// two smaller spaces.
 			pos := space.Min
 			if bottomSpace > 0 {
-				p.spaces = append(p.spaces, image.Rectangle{
+				pg.spaces = append(pg.spaces, image.Rectangle{
 					Min: image.Point{X: pos.X, Y: pos.Y + s.Y},
 					Max: image.Point{X: space.Max.X, Y: space.Max.Y},
 				})
 			}
 			if rightSpace > 0 {
-				p.spaces = append(p.spaces, image.Rectangle{
+				pg.spaces = append(pg.spaces, image.Rectangle{
 					Min: image.Point{X: pos.X + s.X, Y: pos.Y},
 					Max: image.Point{X: space.Max.X, Y: pos.Y + s.Y},
 				})
 			}
-			idx := len(p.sizes) - 1
-			size := &p.sizes[idx]
-			if x := pos.X + s.X; x > size.X {
-				size.X = x
-			}
-			if y := pos.Y + s.Y; y > size.Y {
-				size.Y = y
+			return pos, true
+		}
+	}
+	return image.Point{}, false
+}
+
+// trySkyline places a rectangle on the skyline where its top is lowest,
+// preferring the leftmost position.
+func (pg *packerPage) trySkyline(maxDim int, s image.Point) (image.Point, bool) {
+	best, bestY := -1, 0
+	for i := range pg.skyline {
+		y, ok := pg.fitSkyline(maxDim, i, s)
+		if ok && (best == -1 || y < bestY) {
+			best, bestY = i, y
+		}
+	}
+	if best == -1 {
+		return image.Point{}, false
+	}
+	pos := image.Pt(pg.skyline[best].x, bestY)
+	pg.placeSkyline(best, pos, s)
+	return pos, true
+}
+
+// fitSkyline returns the lowest y where a rectangle starting at skyline
+// segment i fits.
+func (pg *packerPage) fitSkyline(maxDim, i int, s image.Point) (int, bool) {
+	x := pg.skyline[i].x
+	if x+s.X > maxDim {
+		return 0, false
+	}
+	y := 0
+	for j := i; j < len(pg.skyline) && pg.skyline[j].x < x+s.X; j++ {
+		if sy := pg.skyline[j].y; sy > y {
+			y = sy
+		}
+		if y+s.Y > maxDim {
+			return 0, false
+		}
+	}
+	return y, true
+}
+
+// placeSkyline raises the skyline over a rectangle placed at
+// skyline segment i.
+func (pg *packerPage) placeSkyline(i int, pos, s image.Point) {
+	sky := pg.skyline
+	end := pos.X + s.X
+	// Keep the space wasted below the rectangle.
+	j := i
+	for ; j < len(sky) && sky[j].x < end; j++ {
+		seg := sky[j]
+		if seg.y < pos.Y {
+			right := seg.x + seg.width
+			if right > end {
+				right = end
 			}
-			return placement{Idx: idx, Pos: pos}, true
+			pg.spaces = append(pg.spaces, image.Rect(seg.x, seg.y, right, pos.Y))
 		}
 	}
-	return placement{}, false
+	// Shorten the last segment if it is only partially covered.
+	if last := &sky[j-1]; last.x+last.width > end {
+		last.width -= end - last.x
+		last.x = end
+		j--
+	}
+	// Replace the covered segments sky[i:j] with the new segment.
+	seg := skylineSegment{x: pos.X, y: pos.Y + s.Y, width: s.X}
+	if j == i {
+		sky = append(sky, skylineSegment{})
+		copy(sky[i+1:], sky[i:])
+	} else {
+		sky = append(sky[:i+1], sky[j:]...)
+	}
+	sky[i] = seg
+	// Merge neighbours of equal height.
+	if i+1 < len(sky) && sky[i+1].y == seg.y {
+		sky[i].width += sky[i+1].width
+		sky = append(sky[:i+1], sky[i+2:]...)
+	}
+	if i > 0 && sky[i-1].y == seg.y {
+		sky[i-1].width += sky[i].width
+		sky = append(sky[:i], sky[i+1:]...)
+	}
+	pg.skyline = sky
 }
@@ -0,0 +1,107 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package gpu
+
+import (
+	"image"
+	"math/rand"
+	"testing"
+)
+
+// packRects adds rectangles of the given sizes to p and returns their
+// placements.
+func packRects(t *testing.T, p *packer, sizes []image.Point) []image.Rectangle {
+	t.Helper()
+	rects := make([]image.Rectangle, len(sizes))
+	pages := make([]int, len(sizes))
+	for i, s := range sizes {
+		place, ok := p.add(s)
+		if !ok {
+			t.Fatalf("rectangle %v not placed", s)
+		}
+		r := image.Rectangle{Min: place.Pos, Max: place.Pos.Add(s)}
+		if !r.In(image.Rectangle{Max: image.Pt(p.maxDim, p.maxDim)}) {
+			t.Errorf("rectangle placed at %v, outside the page", r)
+		}
+		if sz := p.sizes[place.Idx]; r.Max.X > sz.X || r.Max.Y > sz.Y {
+			t.Errorf("rectangle placed at %v, outside the page size %v", r, sz)
+		}
+		for j := 0; j < i; j++ {
+			if pages[j] == place.Idx && rects[j].Overlaps(r) {
+				t.Fatalf("rectangles overlap at %v and %v", rects[j], r)
+			}
+		}
+		rects[i], pages[i] = r, place.Idx
+	}
+	return rects
+}
+
+// mixedRects returns a fixed set of n icon and strip sized rectangles.
+func mixedRects(n int) []image.Point {
+	rng := rand.New(rand.NewSource(0))
+	sizes := make([]image.Point, n)
+	for i := range sizes {
+		if i%4 == 0 {
+			sizes[i] = image.Pt(64+rng.Intn(448), 2+rng.Intn(8))
+		} else {
+			d := 8 + rng.Intn(40)
+			sizes[i] = image.Pt(d, d)
+		}
+	}
+	return sizes
+}
+
+func TestPackerNoOverlap(t *testing.T) {
+	p := packer{maxDim: 512}
+	packRects(t, &p, mixedRects(500))
+	if used, _ := p.usage(); used == 0 {
+		t.Error("no area used")
+	}
+}
+
+func TestPackerPages(t *testing.T) {
+	sizes := mixedRects(2000)
+	area := 0
+	for _, s := range sizes {
+		area += s.X * s.Y
+	}
+	p := packer{maxDim: 512}
+	for _, s := range sizes {
+		if _, ok := p.add(s); !ok {
+			t.Fatalf("rectangle %v not placed", s)
+		}
+	}
+	// The rectangles cover a little more than 8 pages. A packer that
+	// only tries the most recent page needs about 50.
+	minPages := (area + 512*512 - 1) / (512 * 512)
+	if n := len(p.pages); n > minPages+1 {
+		t.Errorf("packed into %d pages, expected at most %d", n, minPages+1)
+	}
+}
+
+func TestPackerReuseFree(t *testing.T) {
+	p := packer{maxDim: 64}
+	quarter := image.Pt(32, 32)
+	rects := packRects(t, &p, []image.Point{quarter, quarter, quarter, quarter})
+	if n := len(p.pages); n != 1 {
+		t.Fatalf("%d pages, expected 1", n)
+	}
+	p.free(0, rects[2])
+	place, ok := p.add(quarter)
+	if !ok {
+		t.Fatal("rectangle not placed in freed space")
+	}
+	if place.Idx != 0 || place.Pos != rects[2].Min {
+		t.Errorf("rectangle placed at %d %v, expected the freed space at 0 %v", place.Idx, place.Pos, rects[2].Min)
+	}
+	if n := len(p.pages); n != 1 {
+		t.Errorf("%d pages after reusing freed space, expected 1", n)
+	}
+	// Space wasted below the skyline is reused too.
+	p = packer{maxDim: 64}
+	packRects(t, &p, []image.Point{{32, 16}, {32, 48}, {64, 16}})
+	place, ok = p.add(image.Pt(32, 32))
+	if !ok || place.Idx != 0 || place.Pos != image.Pt(0, 16) {
+		t.Errorf("rectangle placed at %d %v, expected the space below the skyline at 0 (0,16)", place.Idx, place.Pos)
+	}
+}
@@ -0,0 +1,253 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package gpu
+
+import (
+	"gioui.org/internal/scene"
+)
+
+// sceneLayout lays out the packed scene in the words of the scene buffer.
+// The buffer starts with a table of the byte offsets of every command,
+// followed by a single shared zero word for Nop commands, such as the
+// padding. The remaining words hold the commands, each stored in only the
+// words it uses.
+//
+// The commands of a segment of the scene, typically a single operation,
+// are stored together in a block that keeps its place between frames as
+// long as the segment is in the scene. A local change to the scene changes
+// only the words of the blocks of changed segments, and the table entries
+// of the commands that moved.
+type sceneLayout struct {
+	// words mirrors the scene buffer. It only grows, so that it always
+	// reflects what was uploaded to the buffer.
+	words []uint32
+	// tableCap is the number of table entries reserved before the shared
+	// Nop word.
+	tableCap int
+	// end is the end of the allocated blocks.
+	end int
+	// live is the number of words in allocated blocks.
+	live int
+	// blocks and prevBlocks map segment keys to their blocks in the
+	// current and the previous layout.
+	blocks, prevBlocks map[uint64]sceneBlock
+	// holes are the free blocks before end.
+	holes []sceneBlock
+	// pending is scratch space for the segments to place.
+	pending []int
+	// dirty are the ranges of words changed by the most recent layout.
+	dirty []wordRange
+	// known is the number of words in the buffer before the most recent
+	// layout. Words past it are dirty already.
+	known int
+}
+
+// sceneSegment is a range of commands stored in a single block.
+type sceneSegment struct {
+	// key identifies the segment between frames, such as the hash of its
+	// commands.
+	key        uint64
+	start, end int
+}
+
+type sceneBlock struct {
+	offset, size int
+}
+
+// wordRange is the range of words [start, end).
+type wordRange struct {
+	start, end int
+}
+
+const (
+	// sceneMergeGap is the number of unchanged words that may separate
+	// changed words in the same dirty range.
+	sceneMergeGap = 16
+	// sceneMinWaste is the number of free words that are always tolerated
+	// before the blocks are compacted.
+	sceneMinWaste = 4096
+)
+
+// layout updates the buffer contents to match cmds. The segments must be
+// ordered and cover every command that is not a Nop. Their keys are
+// replaced by the keys of their blocks, which differ from the segment keys
+// for repeated segments.
+func (l *sceneLayout) layout(cmds []scene.Command, segs []sceneSegment) {
+	l.dirty = l.dirty[:0]
+	if n := len(cmds); n > l.tableCap || l.blocks == nil {
+		// The table would overlap the blocks; start over with room for
+		// growth.
+		l.tableCap = n + n/4
+		l.blocks = make(map[uint64]sceneBlock)
+		l.prevBlocks = make(map[uint64]sceneBlock)
+		l.holes = l.holes[:0]
+		l.end = l.tableCap + 1
+		l.live = 0
+	}
+	l.blocks, l.prevBlocks = l.prevBlocks, l.blocks
+	for k := range l.blocks {
+		delete(l.blocks, k)
+	}
+	l.pending = l.pending[:0]
+	for i := range segs {
+		s := &segs[i]
+		for {
+			// Derive distinct keys for repeated segments.
+			if _, dup := l.blocks[s.key]; !dup {
+				break
+			}
+			s.key = s.key*0x100000001b3 + 1
+		}
+		size := 0
+		for _, c := range cmds[s.start:s.end] {
+			if c.Op() != scene.OpNop {
+				size += c.Words()
+			}
+		}
+		if b, ok := l.prevBlocks[s.key]; ok && b.size == size {
+			delete(l.prevBlocks, s.key)
+			l.blocks[s.key] = b
+			continue
+		}
+		l.blocks[s.key] = sceneBlock{size: size}
+		l.pending = append(l.pending, i)
+	}
+	// Free the blocks of the segments no longer in the scene.
+	for k, b := range l.prevBlocks {
+		l.free(b)
+		delete(l.prevBlocks, k)
+	}
+	for _, i := range l.pending {
+		k := segs[i].key
+		b := l.blocks[k]
+		b.offset = l.alloc(b.size)
+		l.blocks[k] = b
+	}
+	if waste := l.end - l.tableCap - 1 - l.live; waste > l.live/2+sceneMinWaste {
+		l.compact(segs)
+	}
+	l.known = len(l.words)
+	if n := l.end - l.known; n > 0 {
+		l.words = append(l.words, make([]uint32, n)...)
+		l.dirty = append(l.dirty, wordRange{start: l.known, end: l.end})
+	}
+	nop := uint32(l.tableCap * 4)
+	l.set(l.tableCap, 0)
+	ix := 0
+	for _, s := range segs {
+		for ; ix < s.start; ix++ {
+			l.set(ix, nop)
+		}
+		off := l.blocks[s.key].offset
+		for _, c := range cmds[s.start:s.end] {
+			if c.Op() == scene.OpNop {
+				l.set(ix, nop)
+				ix++
+				continue
+			}
+			l.set(ix, uint32(off*4))
+			ix++
+			w := c[:c.Words()]
+			dst := l.words[off : off+len(w)]
+			first, last := -1, 0
+			for j := range w {
+				if dst[j] != w[j] {
+					if first == -1 {
+						first = j
+					}
+					last = j
+				}
+			}
+			if first != -1 {
+				copy(dst[first:last+1], w[first:last+1])
+				l.markDirty(off+first, off+last+1)
+			}
+			off += len(w)
+		}
+	}
+	for ; ix < len(cmds); ix++ {
+		if cmds[ix].Op() != scene.OpNop {
+			panic("gpu: scene command outside segments")
+		}
+		l.set(ix, nop)
+	}
+}
+
+// size returns the number of words in use.
+func (l *sceneLayout) size() int {
+	return l.end
+}
+
+// alloc allocates a block of size words and returns its offset.
+func (l *sceneLayout) alloc(size int) int {
+	if size == 0 {
+		return 0
+	}
+	l.live += size
+	for i := range l.holes {
+		h := &l.holes[i]
+		if h.size < size {
+			continue
+		}
+		off := h.offset
+		h.offset += size
+		h.size -= size
+		if h.size == 0 {
+			l.holes[i] = l.holes[len(l.holes)-1]
+			l.holes = l.holes[:len(l.holes)-1]
+		}
+		return off
+	}
+	off := l.end
+	l.end += size
+	return off
+}
+
+func (l *sceneLayout) free(b sceneBlock) {
+	if b.size == 0 {
+		return
+	}
+	l.live -= b.size
+	l.holes = append(l.holes, b)
+}
+
+// compact moves every block to the start of the block area, in segment
+// order.
+func (l *sceneLayout) compact(segs []sceneSegment) {
+	l.holes = l.holes[:0]
+	l.end = l.tableCap + 1
+	l.live = 0
+	for _, s := range segs {
+		b := l.blocks[s.key]
+		b.offset = l.alloc(b.size)
+		l.blocks[s.key] = b
+	}
+}
+
+// set sets a single word of the buffer.
+func (l *sceneLayout) set(i int, v uint32) {
+	if l.words[i] != v {
+		l.words[i] = v
+		l.markDirty(i, i+1)
+	}
+}
+
+// markDirty adds the words [start, end) to the dirty ranges.
+func (l *sceneLayout) markDirty(start, end int) {
+	if end > l.known {
+		end = l.known
+	}
+	if start >= end {
+		return
+	}
+	if n := len(l.dirty); n > 0 {
+		last := &l.dirty[n-1]
+		if start >= last.start && start <= last.end+sceneMergeGap {
+			if end > last.end {
+				last.end = end
+			}
+			return
+		}
+	}
+	l.dirty = append(l.dirty, wordRange{start: start, end: end})
+}
@@ -0,0 +1,152 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package gpu
+
+import (
+	"hash/fnv"
+	"image/color"
+	"testing"
+
+	"gioui.org/f32"
+	"gioui.org/internal/byteslice"
+	"gioui.org/internal/scene"
+)
+
+// testScene is a scene of filled rectangles, one per operation.
+type testScene struct {
+	cmds []scene.Command
+	segs []sceneSegment
+}
+
+type testRect struct {
+	x   float32
+	col uint8
+}
+
+func newTestScene(rects []testRect) *testScene {
+	s := new(testScene)
+	s.cmds = append(s.cmds, scene.Transform(f32.Affine2D{}))
+	s.segs = append(s.segs, sceneSegment{key: s.hash(0), end: len(s.cmds)})
+	for _, r := range rects {
+		start := len(s.cmds)
+		c0, c1, c2, c3 := f32.Pt(r.x, 0), f32.Pt(r.x, 10), f32.Pt(r.x+10, 10), f32.Pt(r.x+10, 0)
+		s.cmds = append(s.cmds,
+			scene.Line(c0, c1), scene.Line(c1, c2), scene.Line(c2, c3), scene.Line(c3, c0),
+			scene.FillColor(color.RGBA{R: r.col, A: 0xff}),
+		)
+		s.segs = append(s.segs, sceneSegment{key: s.hash(start), start: start, end: len(s.cmds)})
+	}
+	// Padding.
+	s.cmds = append(s.cmds, make([]scene.Command, 7)...)
+	return s
+}
+
+func (s *testScene) hash(start int) uint64 {
+	h := fnv.New64a()
+	h.Write(byteslice.Slice(s.cmds[start:]))
+	return h.Sum64()
+}
+
+// testRects returns n distinct rectangles.
+func testRects(n int) []testRect {
+	rects := make([]testRect, n)
+	for i := range rects {
+		rects[i] = testRect{x: float32(i), col: uint8(i)}
+	}
+	return rects
+}
+
+// layoutScene lays out s and returns the number of changed words.
+func layoutScene(t *testing.T, l *sceneLayout, s *testScene) int {
+	t.Helper()
+	l.layout(s.cmds, s.segs)
+	checkLayout(t, l, s.cmds)
+	n := 0
+	for _, r := range l.dirty {
+		n += r.end - r.start
+	}
+	return n
+}
+
+// checkLayout verifies that the layout decodes to cmds.
+func checkLayout(t *testing.T, l *sceneLayout, cmds []scene.Command) {
+	t.Helper()
+	words := l.words[:l.size()]
+	for i, c := range cmds {
+		off := int(words[i] / 4)
+		n := c.Words()
+		if off+n > len(words) {
+			t.Fatalf("command %d: offset %d out of range", i, off)
+		}
+		for j, w := range c[:n] {
+			if words[off+j] != w {
+				t.Fatalf("command %d: word %d is %#x, expected %#x", i, j, words[off+j], w)
+			}
+		}
+	}
+}
+
+func TestSceneLayoutLocalChange(t *testing.T) {
+	rects := testRects(1000)
+	l := new(sceneLayout)
+	full := layoutScene(t, l, newTestScene(rects))
+	if full != l.size() {
+		t.Errorf("initial layout changed %d words, expected all %d", full, l.size())
+	}
+	if n := layoutScene(t, l, newTestScene(rects)); n != 0 {
+		t.Errorf("unchanged scene changed %d words", n)
+	}
+	// Change the color of a single rectangle.
+	rects[500].col++
+	if n := layoutScene(t, l, newTestScene(rects)); n != 1 {
+		t.Errorf("color change changed %d words, expected 1", n)
+	}
+}
+
+func TestSceneLayoutInsert(t *testing.T) {
+	rects := testRects(1000)
+	l := new(sceneLayout)
+	layoutScene(t, l, newTestScene(rects))
+	blocks := l.tableCap + 1
+	// Insert a rectangle near the start. Only the new block and the
+	// table entries of the moved commands should change.
+	rects = append(rects[:10], append([]testRect{{x: -1}}, rects[10:]...)...)
+	s := newTestScene(rects)
+	n := layoutScene(t, l, s)
+	if max := l.size() / 4; n > max {
+		t.Errorf("insertion changed %d of %d words, expected at most %d", n, l.size(), max)
+	}
+	blockWords := 0
+	for _, r := range l.dirty {
+		if r.start >= blocks {
+			blockWords += r.end - r.start
+		}
+	}
+	// The inserted rectangle has 4 lines and a color.
+	if exp := 4*scene.Line(f32.Point{}, f32.Point{}).Words() + scene.FillColor(color.RGBA{}).Words(); blockWords != exp {
+		t.Errorf("insertion changed %d words of blocks, expected %d", blockWords, exp)
+	}
+}
+
+func TestSceneLayoutRemoveAndGrow(t *testing.T) {
+	l := new(sceneLayout)
+	layoutScene(t, l, newTestScene(testRects(1000)))
+	// Removing most of the scene compacts the blocks.
+	layoutScene(t, l, newTestScene(testRects(10)))
+	if waste := l.size() - l.tableCap - 1 - l.live; waste > 0 {
+		t.Errorf("%d words wasted after compaction", waste)
+	}
+	// Growing past the table capacity moves the blocks.
+	layoutScene(t, l, newTestScene(testRects(2000)))
+	layoutScene(t, l, newTestScene(testRects(2000)))
+}
+
+func TestSceneLayoutRepeatedSegments(t *testing.T) {
+	// Identical rectangles share keys.
+	rects := make([]testRect, 100)
+	l := new(sceneLayout)
+	layoutScene(t, l, newTestScene(rects))
+	if n := layoutScene(t, l, newTestScene(rects)); n != 0 {
+		t.Errorf("unchanged scene changed %d words", n)
+	}
+}
@@ -251,6 +251,224 @@ void main()
 
 `,
 	}
+	shader_batch_cover_frag = driver.ShaderSources{
+		Name:     "batch_cover.frag",
+		Inputs:   []driver.InputLocation{{Name: "vColor", Location: 0, Semantic: "TEXCOORD", SemanticIndex: 0, Type: 0x0, Size: 4}, {Name: "vCoverUV", Location: 1, Semantic: "TEXCOORD", SemanticIndex: 1, Type: 0x0, Size: 2}},
+		Textures: []driver.TextureBinding{{Name: "cover", Binding: 1}},
+		GLSL100ES: `#version 100
+precision mediump float;
+precision highp int;
+
+uniform mediump sampler2D cover;
+
+varying vec4 vColor;
+varying highp vec2 vCoverUV;
+
+void main()
+{
+    gl_FragData[0] = vColor;
+    float cover_1 = min(abs(texture2D(cover, vCoverUV).x), 1.0);
+    gl_FragData[0] *= cover_1;
+}
+
+`,
+		GLSL300ES: `#version 300 es
+precision mediump float;
+precision highp int;
+
+uniform mediump sampler2D cover;
+
+layout(location = 0) out vec4 fragColor;
+in vec4 vColor;
+in highp vec2 vCoverUV;
+
+void main()
+{
+    fragColor = vColor;
+    float cover_1 = min(abs(texture(cover, vCoverUV).x), 1.0);
+    fragColor *= cover_1;
+}
+
+`,
+		GLSL130: `#version 130
+
+uniform sampler2D cover;
+
+out vec4 fragColor;
+in vec4 vColor;
+in vec2 vCoverUV;
+
+void main()
+{
+    fragColor = vColor;
+    float cover_1 = min(abs(texture(cover, vCoverUV).x), 1.0);
+    fragColor *= cover_1;
+}
+
+`,
+		GLSL150: `#version 150
+
+uniform sampler2D cover;
+
+out vec4 fragColor;
+in vec4 vColor;
+in vec2 vCoverUV;
+
+void main()
+{
+    fragColor = vColor;
+    float cover_1 = min(abs(texture(cover, vCoverUV).x), 1.0);
+    fragColor *= cover_1;
+}
+
+`,
+		HLSL: "DXBC\xcc\xfa\x9b\xff6\xa0\xc6Me\x9d>\xad\xec\xe6\x12\xda\x01\x00\x00\x00(\x03\x00\x00\x06\x00\x00\x008\x00\x00\x00\xcc\x00\x00\x00\x88\x01\x00\x00\x04\x02\x00\x00\xa8\x02\x00\x00\xf4\x02\x00\x00Aon9\x8c\x00\x00\x00\x8c\x00\x00\x00\x00\x02\xff\xffd\x00\x00\x00(\x00\x00\x00\x00\x00(\x00\x00\x00(\x00\x00\x00(\x00\x01\x00$\x00\x00\x00(\x00\x01\x01\x00\x00\x00\x02\xff\xff\x1f\x00\x00\x02\x00\x00\x00\x80\x00\x00\x0f\xb0\x1f\x00\x00\x02\x00\x00\x00\x80\x01\x00\x0f\xb0\x1f\x00\x00\x02\x00\x00\x00\x90\x00\b\x0f\xa0B\x00\x00\x03\x00\x00\x0f\x80\x01\x00\xe4\xb0\x00\b\xe4\xa0#\x00\x00\x02\x00\x00\x11\x80\x00\x00\x00\x80\x05\x00\x00\x03\x00\x00\x0f\x80\x00\x00\x00\x80\x00\x00\xe4\xb0\x01\x00\x00\x02\x00\b\x0f\x80\x00\x00\xe4\x80\xff\xff\x00\x00SHDR\xb4\x00\x00\x00@\x00\x00\x00-\x00\x00\x00Z\x00\x00\x03\x00`\x10\x00\x01\x00\x00\x00X\x18\x00\x04\x00p\x10\x00\x01\x00\x00\x00UU\x00\x00b\x10\x00\x03\xf2\x10\x10\x00\x00\x00\x00\x00b\x10\x00\x032\x10\x10\x00\x01\x00\x00\x00e\x00\x00\x03\xf2 \x10\x00\x00\x00\x00\x00h\x00\x00\x02\x01\x00\x00\x00E\x00\x00\t\xf2\x00\x10\x00\x00\x00\x00\x00F\x10\x10\x00\x01\x00\x00\x00F~\x10\x00\x01\x00\x00\x00\x00`\x10\x00\x01\x00\x00\x003\x00\x00\b\x12\x00\x10\x00\x00\x00\x00\x00\n\x00\x10\x80\x81\x00\x00\x00\x00\x00\x00\x00\x01@\x00\x00\x00\x00\x80?8\x00\x00\a\xf2 \x10\x00\x00\x00\x00\x00\x06\x00\x10\x00\x00\x00\x00\x00F\x1e\x10\x00\x00\x00\x00\x00>\x00\x00\x01STATt\x00\x00\x00\x04\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x02\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00RDEF\x9c\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x02\x00\x00\x00\x1c\x00\x00\x00\x00\x04\xff\xff\x00\x01\x00\x00q\x00\x00\x00\\\x00\x00\x00\x03\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x01\x00\x00\x00\x01\x00\x00\x00\x01\x00\x00\x00k\x00\x00\x00\x02\x00\x00\x00\x05\x00\x00\x00\x04\x00\x00\x00\xff\xff\xff\xff\x01\x00\x00\x00\x01\x00\x00\x00\r\x00\x00\x00_cover_sampler\x00cover\x00Microsoft (R) HLSL Shader Compiler 10.1\x00\xab\xab\xabISGND\x00\x00\x00\x02\x00\x00\x00\b\x00\x00\x008\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x00\x00\x00\x00\x0f\x0f\x00\x008\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x01\x00\x00\x00\x03\x03\x00\x00TEXCOORD\x00\xab\xab\xabOSGN,\x00\x00\x00\x01\x00\x00\x00\b\x00\x00\x00 \x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x00\x00\x00\x00\x0f\x00\x00\x00SV_Target\x00\xab\xab",
+	}
+	shader_batch_frag = driver.ShaderSources{
+		Name:   "batch.frag",
+		Inputs: []driver.InputLocation{{Name: "vColor", Location: 0, Semantic: "TEXCOORD", SemanticIndex: 0, Type: 0x0, Size: 4}},
+		GLSL100ES: `#version 100
+precision mediump float;
+precision highp int;
+
+varying vec4 vColor;
+
+void main()
+{
+    gl_FragData[0] = vColor;
+}
+
+`,
+		GLSL300ES: `#version 300 es
+precision mediump float;
+precision highp int;
+
+layout(location = 0) out vec4 fragColor;
+in vec4 vColor;
+
+void main()
+{
+    fragColor = vColor;
+}
+
+`,
+		GLSL130: `#version 130
+
+out vec4 fragColor;
+in vec4 vColor;
+
+void main()
+{
+    fragColor = vColor;
+}
+
+`,
+		GLSL150: `#version 150
+
+out vec4 fragColor;
+in vec4 vColor;
+
+void main()
+{
+    fragColor = vColor;
+}
+
+`,
+		HLSL: "DXBC\xe8\x17\xffX\xe4\x80Ӂ\x94\xcd\xc5\xdeC]H\x9f\x01\x00\x00\x00\xf4\x01\x00\x00\x06\x00\x00\x008\x00\x00\x00\x84\x00\x00\x00\xc4\x00\x00\x00@\x01\x00\x00\x8c\x01\x00\x00\xc0\x01\x00\x00Aon9D\x00\x00\x00D\x00\x00\x00\x00\x02\xff\xff \x00\x00\x00$\x00\x00\x00\x00\x00$\x00\x00\x00$\x00\x00\x00$\x00\x00\x00$\x00\x00\x00$\x00\x00\x02\xff\xff\x1f\x00\x00\x02\x00\x00\x00\x80\x00\x00\x0f\xb0\x01\x00\x00\x02\x00\b\x0f\x80\x00\x00\xe4\xb0\xff\xff\x00\x00SHDR8\x00\x00\x00@\x00\x00\x00\x0e\x00\x00\x00b\x10\x00\x03\xf2\x10\x10\x00\x00\x00\x00\x00e\x00\x00\x03\xf2 \x10\x00\x00\x00\x00\x006\x00\x00\x05\xf2 \x10\x00\x00\x00\x00\x00F\x1e\x10\x00\x00\x00\x00\x00>\x00\x00\x01STATt\x00\x00\x00\x02\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x02\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00RDEFD\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x1c\x00\x00\x00\x00\x04\xff\xff\x00\x01\x00\x00\x1c\x00\x00\x00Microsoft (R) HLSL Shader Compiler 10.1\x00ISGN,\x00\x00\x00\x01\x00\x00\x00\b\x00\x00\x00 \x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x00\x00\x00\x00\x0f\x0f\x00\x00TEXCOORD\x00\xab\xab\xabOSGN,\x00\x00\x00\x01\x00\x00\x00\b\x00\x00\x00 \x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x00\x00\x00\x00\x0f\x00\x00\x00SV_Target\x00\xab\xab",
+	}
+	shader_batch_vert = driver.ShaderSources{
+		Name:   "batch.vert",
+		Inputs: []driver.InputLocation{{Name: "pos", Location: 0, Semantic: "TEXCOORD", SemanticIndex: 0, Type: 0x0, Size: 3}, {Name: "color", Location: 1, Semantic: "TEXCOORD", SemanticIndex: 1, Type: 0x0, Size: 4}, {Name: "coverUV", Location: 2, Semantic: "TEXCOORD", SemanticIndex: 2, Type: 0x0, Size: 2}},
+		GLSL100ES: `#version 100
+
+attribute vec3 pos;
+varying vec4 vColor;
+attribute vec4 color;
+varying vec2 vCoverUV;
+attribute vec2 coverUV;
+
+vec4 toClipSpace(vec4 pos_1)
+{
+    return pos_1;
+}
+
+void main()
+{
+    vec4 param = vec4(pos, 1.0);
+    gl_Position = toClipSpace(param);
+    vColor = color;
+    vCoverUV = coverUV;
+}
+
+`,
+		GLSL300ES: `#version 300 es
+
+layout(location = 0) in vec3 pos;
+out vec4 vColor;
+layout(location = 1) in vec4 color;
+out vec2 vCoverUV;
+layout(location = 2) in vec2 coverUV;
+
+vec4 toClipSpace(vec4 pos_1)
+{
+    return pos_1;
+}
+
+void main()
+{
+    vec4 param = vec4(pos, 1.0);
+    gl_Position = toClipSpace(param);
+    vColor = color;
+    vCoverUV = coverUV;
+}
+
+`,
+		GLSL130: `#version 130
+
+in vec3 pos;
+out vec4 vColor;
+in vec4 color;
+out vec2 vCoverUV;
+in vec2 coverUV;
+
+vec4 toClipSpace(vec4 pos_1)
+{
+    return pos_1;
+}
+
+void main()
+{
+    vec4 param = vec4(pos, 1.0);
+    gl_Position = toClipSpace(param);
+    vColor = color;
+    vCoverUV = coverUV;
+}
+
+`,
+		GLSL150: `#version 150
+
+in vec3 pos;
+out vec4 vColor;
+in vec4 color;
+out vec2 vCoverUV;
+in vec2 coverUV;
+
+vec4 toClipSpace(vec4 pos_1)
+{
+    return pos_1;
+}
+
+void main()
+{
+    vec4 param = vec4(pos, 1.0);
+    gl_Position = toClipSpace(param);
+    vColor = color;
+    vCoverUV = coverUV;
+}
+
+`,
+		HLSL: "DXBC\xe5\xf5.Z.\x1d\xd3F҄w\xb7\xa9T<R\x01\x00\x00\x00d\x03\x00\x00\x06\x00\x00\x008\x00\x00\x00\xf4\x00\x00\x00\xc8\x01\x00\x00D\x02\x00\x00\x90\x02\x00\x00\xf4\x02\x00\x00Aon9\xb4\x00\x00\x00\xb4\x00\x00\x00\x00\x02\xfe\xff\x8c\x00\x00\x00(\x00\x00\x00\x00\x00$\x00\x00\x00$\x00\x00\x00$\x00\x00\x00$\x00\x01\x00$\x00\x00\x00\x00\x00\x00\x02\xfe\xffQ\x00\x00\x05\x01\x00\x0f\xa0\x00\x00\x00?\x00\x00\x80?\x00\x00\x00\x00\x00\x00\x00\x00\x1f\x00\x00\x02\x05\x00\x00\x80\x00\x00\x0f\x90\x1f\x00\x00\x02\x05\x00\x01\x80\x01\x00\x0f\x90\x1f\x00\x00\x02\x05\x00\x02\x80\x02\x00\x0f\x90\x02\x00\x00\x03\x00\x00\x03\xc0\x00\x00\xe4\x90\x00\x00\xe4\xa0\x04\x00\x00\x04\x00\x00\x04\xc0\x00\x00\xaa\x90\x01\x00\x00\xa0\x01\x00\x00\xa0\x01\x00\x00\x02\x00\x00\b\xc0\x01\x00U\xa0\x01\x00\x00\x02\x00\x00\x0f\xe0\x01\x00\xe4\x90\x01\x00\x00\x02\x01\x00\x03\xe0\x02\x00\xe4\x90\xff\xff\x00\x00SHDR\xcc\x00\x00\x00@\x00\x01\x003\x00\x00\x00_\x00\x00\x03r\x10\x10\x00\x00\x00\x00\x00_\x00\x00\x03\xf2\x10\x10\x00\x01\x00\x00\x00_\x00\x00\x032\x10\x10\x00\x02\x00\x00\x00e\x00\x00\x03\xf2 \x10\x00\x00\x00\x00\x00e\x00\x00\x032 \x10\x00\x01\x00\x00\x00g\x00\x00\x04\xf2 \x10\x00\x02\x00\x00\x00\x01\x00\x00\x006\x00\x00\x05\xf2 \x10\x00\x00\x00\x00\x00F\x1e\x10\x00\x01\x00\x00\x006\x00\x00\x052 \x10\x00\x01\x00\x00\x00F\x10\x10\x00\x02\x00\x00\x006\x00\x00\x052 \x10\x00\x02\x00\x00\x00F\x10\x10\x00\x00\x00\x00\x002\x00\x00\tB \x10\x00\x02\x00\x00\x00*\x10\x10\x00\x00\x00\x00\x00\x01@\x00\x00\x00\x00\x00?\x01@\x00\x00\x00\x00\x00?6\x00\x00\x05\x82 \x10\x00\x02\x00\x00\x00\x01@\x00\x00\x00\x00\x80?>\x00\x00\x01STATt\x00\x00\x00\x06\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x06\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x04\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00RDEFD\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x1c\x00\x00\x00\x00\x04\xfe\xff\x00\x01\x00\x00\x1c\x00\x00\x00Microsoft (R) HLSL Shader Compiler 10.1\x00ISGN\\\x00\x00\x00\x03\x00\x00\x00\b\x00\x00\x00P\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x00\x00\x00\x00\a\a\x00\x00P\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x01\x00\x00\x00\x0f\x0f\x00\x00P\x00\x00\x00\x02\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x02\x00\x00\x00\x03\x03\x00\x00TEXCOORD\x00\xab\xab\xabOSGNh\x00\x00\x00\x03\x00\x00\x00\b\x00\x00\x00P\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x00\x00\x00\x00\x0f\x00\x00\x00P\x00\x00\x00\x01\x00\x00\x00\x00\x00\x00\x00\x03\x00\x00\x00\x01\x00\x00\x00\x03\f\x00\x00Y\x00\x00\x00\x00\x00\x00\x00\x01\x00\x00\x00\x03\x00\x00\x00\x02\x00\x00\x00\x0f\x00\x00\x00TEXCOORD\x00SV_Position\x00\xab\xab\xab",
+	}
 	shader_binning_comp = driver.ShaderSources{
 		Name: "binning.comp",
 		GLSL310ES: `#version 310 es
@@ -1949,6 +2167,17 @@ void main()
                         param_38.offset = _1066.conf.anno_alloc.offset;
                         AnnotatedRef param_39 = ref;
                         AnnoColor fill = Annotated_Color_read(param_38, param_39);
+                        uint param_97 = tag_2.flags;
+                        if (((((clip_depth == 0u) && (tile_1.tile.offset == 0u)) && (tile_1.backdrop != 0)) && (fill_mode_from_flags(param_97) == 0u)) && ((fill.rgba_color & 255u) == 255u))
+                        {
+                            Alloc param_98;
+                            param_98.offset = _1066.conf.ptcl_alloc.offset;
+                            uint param_99 = this_tile_ix * 1024u;
+                            uint param_100 = 1024u;
+                            cmd_alloc = slice_mem(param_98, param_99, param_100);
+                            cmd_ref = CmdRef(cmd_alloc.offset + 8u);
+                            cmd_limit = (cmd_alloc.offset + 1024u) - 36u;
+                        }
                         Alloc param_40 = cmd_alloc;
                         CmdRef param_41 = cmd_ref;
                         uint param_42 = cmd_limit;
@@ -3330,9 +3559,9 @@ State map_element(ElementRef ref)
     return c;
 }
 
-ElementRef Element_index(ElementRef ref, uint index)
+ElementRef element_ref(uint ix)
 {
-    return ElementRef(ref.offset + (index * 36u));
+    return ElementRef(_323.scene[ix]);
 }
 
 State combine_state(State a, State b)
@@ -3847,15 +4076,15 @@ void main()
     barrier();
     uint part_ix = sh_part_ix;
     uint ix = (part_ix * 128u) + (gl_LocalInvocationID.x * 4u);
-    ElementRef ref = ElementRef(ix * 36u);
-    ElementRef param = ref;
+    uint param = ix;
+    ElementRef ref = element_ref(param);
+    ElementRef param_1 = ref;
     State th_state[4];
-    th_state[0] = map_element(param);
+    th_state[0] = map_element(param_1);
     for (uint i = 1u; i < 4u; i++)
     {
-        ElementRef param_1 = ref;
-        uint param_2 = i;
-        ElementRef param_3 = Element_index(param_1, param_2);
+        uint param_2 = ix + i;
+        ElementRef param_3 = element_ref(param_2);
         State param_4 = th_state[i - 1u];
         State param_5 = map_element(param_3);
         th_state[i] = combine_state(param_4, param_5);
@@ -3936,7 +4165,8 @@ void main()
                         continue;
                     }
                 }
-                ElementRef ref_1 = ElementRef(((look_back_ix * 128u) + their_ix) * 36u);
+                uint param_86 = (look_back_ix * 128u) + their_ix;
+                ElementRef ref_1 = element_ref(param_86);
                 ElementRef param_24 = ref_1;
                 State s = map_element(param_24);
                 if (their_ix == 0u)
@@ -4009,9 +4239,8 @@ void main()
         State param_37 = row;
         State param_38 = th_state[i_2];
         State st = combine_state(param_37, param_38);
-        ElementRef param_39 = ref;
-        uint param_40 = i_2;
-        ElementRef this_ref = Element_index(param_39, param_40);
+        uint param_40 = ix + i_2;
+        ElementRef this_ref = element_ref(param_40);
         ElementRef param_41 = this_ref;
         ElementTag tag = Element_tag(param_41);
         uint param_42 = st.flags >> uint(4);
@@ -4564,6 +4793,11 @@ layout(binding = 1, std430) restrict readonly buffer ConfigBuf
     Config conf;
 } _686;
 
+layout(binding = 2, std430) restrict readonly buffer SceneBuf
+{
+    uint scene[];
+} _1305;
+
 layout(binding = 3, rgba8) uniform restrict readonly highp image2D images[1];
 layout(binding = 2, rgba8) uniform restrict writeonly highp image2D image;
 
@@ -4780,6 +5014,25 @@ mediump vec4[8] fillImage(uvec2 xy, CmdImage cmd_img)
     return rgba;
 }
 
+mediump vec4[8] fillGradient(uvec2 xy, uint index)
+{
+    uint ix = _1305.scene[index] >> uint(2);
+    vec3 line = uintBitsToFloat(uvec3(_1305.scene[ix + 3u], _1305.scene[ix + 4u], _1305.scene[ix + 5u]));
+    uint param = _1305.scene[ix + 6u];
+    mediump vec4 color1 = unpacksRGB(param);
+    uint param_1 = _1305.scene[ix + 7u];
+    mediump vec4 color2 = unpacksRGB(param_1);
+    mediump vec4 rgba[8];
+    for (uint i = 0u; i < 8u; i++)
+    {
+        uint param_2 = i;
+        vec2 pos = vec2(xy + chunk_offset(param_2));
+        float t = clamp(dot(line.xy, pos) + line.z, 0.0, 1.0);
+        rgba[i] = mix(color1, color2, vec4(t));
+    }
+    return rgba;
+}
+
 mediump vec3 tosRGB(mediump vec3 rgb)
 {
     bvec3 cutoff = greaterThanEqual(rgb, vec3(0.003130800090730190277099609375));
@@ -4846,6 +5099,7 @@ void main()
     }
     uint clip_depth = 0u;
     bool mem_ok = _198.mem_error == 0u;
+    bool solid_tile = true;
     mediump float df[8];
     TileSegRef tile_seg_ref;
     mediump float area[8];
@@ -4863,6 +5117,7 @@ void main()
         {
             case 2u:
             {
+                solid_tile = false;
                 Alloc param_7 = cmd_alloc;
                 CmdRef param_8 = cmd_ref;
                 CmdStroke stroke = Cmd_Stroke_read(param_7, param_8);
@@ -4899,6 +5154,7 @@ void main()
             }
             case 1u:
             {
+                solid_tile = false;
                 Alloc param_15 = cmd_alloc;
                 CmdRef param_16 = cmd_ref;
                 CmdFill fill = Cmd_Fill_read(param_15, param_16);
@@ -4983,12 +5239,23 @@ void main()
             }
             case 6u:
             {
+                solid_tile = false;
                 Alloc param_28 = cmd_alloc;
                 CmdRef param_29 = cmd_ref;
                 CmdImage fill_img = Cmd_Image_read(param_28, param_29);
-                uvec2 param_30 = xy_uint;
-                CmdImage param_31 = fill_img;
-                mediump vec4 img[8] = fillImage(param_30, param_31);
+                mediump vec4 img[8];
+                if ((fill_img.index & 2147483648u) != 0u)
+                {
+                    uvec2 param_30 = xy_uint;
+                    uint param_31 = fill_img.index & 2147483647u;
+                    img = fillGradient(param_30, param_31);
+                }
+                else
+                {
+                    uvec2 param_52 = xy_uint;
+                    CmdImage param_53 = fill_img;
+                    img = fillImage(param_52, param_53);
+                }
                 for (uint k_9 = 0u; k_9 < 8u; k_9++)
                 {
                     mediump vec4 fg_k_1 = img[k_9] * area[k_9];
@@ -4999,6 +5266,7 @@ void main()
             }
             case 7u:
             {
+                solid_tile = false;
                 base_ix = (scratch_alloc.offset >> uint(2)) + (2u * ((((clip_depth * 32u) * 32u) + gl_LocalInvocationID.x) + (32u * gl_LocalInvocationID.y)));
                 for (uint k_10 = 0u; k_10 < 8u; k_10++)
                 {
@@ -5024,6 +5292,7 @@ void main()
             }
             case 8u:
             {
+                solid_tile = false;
                 clip_depth--;
                 base_ix = (scratch_alloc.offset >> uint(2)) + (2u * ((((clip_depth * 32u) * 32u) + gl_LocalInvocationID.x) + (32u * gl_LocalInvocationID.y)));
                 for (uint k_11 = 0u; k_11 < 8u; k_11++)
@@ -5054,6 +5323,17 @@ void main()
             }
         }
     }
+    if (solid_tile)
+    {
+        mediump vec3 param_50 = rgba[0].xyz;
+        mediump vec4 srgba = vec4(tosRGB(param_50), rgba[0].w);
+        for (uint i_2 = 0u; i_2 < 8u; i_2++)
+        {
+            uint param_51 = i_2;
+            imageStore(image, ivec2(xy_uint + chunk_offset(param_51)), srgba);
+        }
+        return;
+    }
     for (uint i_1 = 0u; i_1 < 8u; i_1++)
     {
         uint param_48 = i_1;
@@ -0,0 +1,13 @@
+#version 310 es
+
+// SPDX-License-Identifier: Unlicense OR MIT
+
+precision mediump float;
+
+layout(location = 0) in vec4 vColor;
+
+layout(location = 0) out vec4 fragColor;
+
+void main() {
+	fragColor = vColor;
+}
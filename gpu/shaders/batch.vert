@@ -0,0 +1,24 @@
+#version 310 es
+
+// SPDX-License-Identifier: Unlicense OR MIT
+
+#extension GL_GOOGLE_include_directive : enable
+
+precision highp float;
+
+#include "common.h"
+
+layout(location = 0) in vec3 pos;
+
+layout(location = 1) in vec4 color;
+
+layout(location = 2) in vec2 coverUV;
+
+layout(location = 0) out vec4 vColor;
+layout(location = 1) out vec2 vCoverUV;
+
+void main() {
+	gl_Position = toClipSpace(vec4(pos, 1));
+	vColor = color;
+	vCoverUV = coverUV;
+}
@@ -0,0 +1,20 @@
+#version 310 es
+
+// SPDX-License-Identifier: Unlicense OR MIT
+
+precision mediump float;
+
+layout(location = 0) in vec4 vColor;
+// Use high precision to be pixel accurate for
+// large cover atlases.
+layout(location = 1) in highp vec2 vCoverUV;
+
+layout(binding = 1) uniform sampler2D cover;
+
+layout(location = 0) out vec4 fragColor;
+
+void main() {
+	fragColor = vColor;
+	float cover = min(abs(texture(cover, vCoverUV).r), 1.0);
+	fragColor *= cover;
+}
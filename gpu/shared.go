@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: Unlicense OR MIT
+
+package gpu
+
+import (
+	"gioui.org/gpu/internal/driver"
+)
+
+// Shared holds the resources shared by GPUs created by NewShared: the
+// device, the programs, the image textures and atlas, and the cached path
+// data. The zero value is ready to use.
+//
+// Every GPU sharing resources must render with the graphics context
+// current when the first of them was created, and only one of them
+// may be used at a time. A resource is released when it is not used by
+// any of as many recent frames as there are GPUs, regardless of which
+// GPU rendered them. Render targets and the atlases of intermediate
+// results are not shared.
+type Shared struct {
+	ctx   driver.Device
+	cache *resourceCache
+	paths *opCache
+	// images is the image atlas of the compute renderers.
+	images *imageAtlas
+	// programs are the programs of the GPUs, by shader sources.
+	programs map[programKey]*cachedProgram
+	// users is the number of GPUs using the resources.
+	users int
+}
+
+// programKey identifies the shaders of a program.
+type programKey struct {
+	vert, frag shaderKey
+}
+
+type shaderKey struct {
+	name, glsl100es, glsl300es, glsl310es, glsl130, glsl150, hlsl string
+}
+
+type cachedProgram struct {
+	prog driver.Program
+	refs int
+}
+
+// sharedDevice is the device of a GPU using a Shared. It shares programs
+// with the other GPUs. Because the buffers bound to a program are not
+// shared, the programs of a sharedDevice record them and set them on the
+// shared program when bound.
+type sharedDevice struct {
+	driver.Device
+	shared *Shared
+}
+
+// sharedProgram is a program of a sharedDevice.
+type sharedProgram struct {
+	shared     *Shared
+	key        programKey
+	prog       driver.Program
+	vert, frag driver.Buffer
+	storage    []driver.Buffer
+}
+
+// NewShared is like New, but the returned GPU shares resources with
+// the other GPUs created with s. The api is ignored if s is already
+// in use.
+func NewShared(api API, s *Shared) (GPU, error) {
+	if s.ctx == nil {
+		d, err := driver.NewDevice(api)
+		if err != nil {
+			return nil, err
+		}
+		s.ctx = d
+		s.cache = newResourceCache()
+		s.paths = newOpCache()
+		s.images = new(imageAtlas)
+		s.programs = make(map[programKey]*cachedProgram)
+	}
+	g, err := newFor(&sharedDevice{Device: s.ctx, shared: s}, s)
+	if err != nil && s.ctx != nil && s.users == 0 {
+		s.release()
+	}
+	return g, err
+}
+
+// release the resources of s when no GPU uses them.
+func (s *Shared) release() {
+	s.paths.release()
+	s.cache.release()
+	s.images.release()
+	for _, p := range s.programs {
+		p.prog.Release()
+	}
+	s.ctx.Release()
+	*s = Shared{}
+}
+
+// join adds a user of the shared resources.
+func (s *Shared) join() {
+	if s != nil {
+		s.users++
+	}
+}
+
+// keep returns the number of recent frames whose resources are kept in
+// the caches.
+func (s *Shared) keep() int {
+	if s == nil {
+		return 1
+	}
+	return s.users
+}
+
+// leave removes a user of the shared resources. It reports whether it
+// was the last user and the shared resources should be released.
+func (s *Shared) leave() bool {
+	if s == nil {
+		return true
+	}
+	s.users--
+	return s.users == 0
+}
+
+func (d *sharedDevice) NewProgram(vs, fs driver.ShaderSources) (driver.Program, error) {
+	return d.program(programKey{vert: newShaderKey(vs), frag: newShaderKey(fs)}, func() (driver.Program, error) {
+		return d.Device.NewProgram(vs, fs)
+	})
+}
+
+func (d *sharedDevice) NewComputeProgram(src driver.ShaderSources) (driver.Program, error) {
+	return d.program(programKey{frag: newShaderKey(src)}, func() (driver.Program, error) {
+		return d.Device.NewComputeProgram(src)
+	})
+}
+
+// program returns a program for the shaders of key, created by create
+// if no GPU uses one.
+func (d *sharedDevice) program(key programKey, create func() (driver.Program, error)) (driver.Program, error) {
+	s := d.shared
+	p, exists := s.programs[key]
+	if !exists {
+		prog, err := create()
+		if err != nil {
+			return nil, err
+		}
+		p = &cachedProgram{prog: prog}
+		s.programs[key] = p
+	}
+	p.refs++
+	return &sharedProgram{shared: s, key: key, prog: p.prog}, nil
+}
+
+func (d *sharedDevice) BindProgram(prog driver.Program) {
+	p := prog.(*sharedProgram)
+	if p.vert != nil {
+		p.prog.SetVertexUniforms(p.vert)
+	}
+	if p.frag != nil {
+		p.prog.SetFragmentUniforms(p.frag)
+	}
+	for i, buf := range p.storage {
+		if buf != nil {
+			p.prog.SetStorageBuffer(i, buf)
+		}
+	}
+	d.Device.BindProgram(p.prog)
+}
+
+func (p *sharedProgram) SetVertexUniforms(buf driver.Buffer) {
+	p.vert = buf
+}
+
+func (p *sharedProgram) SetFragmentUniforms(buf driver.Buffer) {
+	p.frag = buf
+}
+
+func (p *sharedProgram) SetStorageBuffer(binding int, buf driver.Buffer) {
+	for len(p.storage) <= binding {
+		p.storage = append(p.storage, nil)
+	}
+	p.storage[binding] = buf
+}
+
+func (p *sharedProgram) Release() {
+	if p.prog == nil {
+		return
+	}
+	c := p.shared.programs[p.key]
+	c.refs--
+	if c.refs == 0 {
+		c.prog.Release()
+		delete(p.shared.programs, p.key)
+	}
+	p.prog = nil
+}
+
+func newShaderKey(src driver.ShaderSources) shaderKey {
+	return shaderKey{
+		name:      src.Name,
+		glsl100es: src.GLSL100ES,
+		glsl300es: src.GLSL300ES,
+		glsl310es: src.GLSL310ES,
+		glsl130:   src.GLSL130,
+		glsl150:   src.GLSL150,
+		hlsl:      src.HLSL,
+	}
+}
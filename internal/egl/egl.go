@@ -7,8 +7,10 @@ package egl
 import (
 	"errors"
 	"fmt"
+	"image"
 	"runtime"
 	"strings"
+	"sync"
 
 	"gioui.org/gpu"
 )
@@ -19,6 +21,22 @@ type Context struct {
 	eglSurf       _EGLSurface
 	width, height int
 	refreshFBO    bool
+	// share is the Share of the context, or nil.
+	share *Share
+}
+
+// Share is an EGL context shared by the Contexts created by
+// NewSharedContext, for sharing GPU resources between them. The Contexts
+// have their own surfaces and are current only while locked, one at a
+// time. The zero value is ready to use.
+type Share struct {
+	// mu is held while a Context is locked.
+	mu sync.Mutex
+	// setup guards the fields below.
+	setup  sync.Mutex
+	disp   _EGLDisplay
+	eglCtx *eglContext
+	refs   int
 }
 
 type eglContext struct {
@@ -27,6 +45,8 @@ type eglContext struct {
 	visualID    int
 	srgb        bool
 	surfaceless bool
+	// swapDamage is set if eglSwapBuffersWithDamage is supported.
+	swapDamage bool
 }
 
 var (
@@ -57,6 +77,14 @@ const (
 )
 
 func (c *Context) Release() {
+	if s := c.share; s != nil {
+		s.mu.Lock()
+		c.ReleaseSurface()
+		s.mu.Unlock()
+		s.release()
+		c.share = nil
+		c.eglCtx = nil
+	}
 	c.ReleaseSurface()
 	if c.eglCtx != nil {
 		eglDestroyContext(c.disp, c.eglCtx.ctx)
@@ -65,6 +93,58 @@ func (c *Context) Release() {
 	c.disp = nilEGLDisplay
 }
 
+// NewSharedContext is like NewContext, but the Context shares the EGL
+// context of s with the other Contexts of s. The first Context creates the
+// EGL context on disp, and the surfaces of every Context are created on
+// that display.
+func NewSharedContext(disp NativeDisplayType, s *Share) (*Context, error) {
+	s.setup.Lock()
+	defer s.setup.Unlock()
+	if s.eglCtx == nil {
+		c, err := NewContext(disp)
+		if err != nil {
+			return nil, err
+		}
+		s.disp, s.eglCtx = c.disp, c.eglCtx
+	}
+	s.refs++
+	return &Context{disp: s.disp, eglCtx: s.eglCtx, share: s}, nil
+}
+
+// release a use of the EGL context of s, and destroy it after the last.
+func (s *Share) release() {
+	s.setup.Lock()
+	defer s.setup.Unlock()
+	s.refs--
+	if s.refs == 0 {
+		eglDestroyContext(s.disp, s.eglCtx.ctx)
+		s.disp, s.eglCtx = nilEGLDisplay, nil
+	}
+}
+
+// Lock waits for the other Contexts of the Share of c to unlock, and makes
+// c current to the calling thread if it has a surface. Lock and Unlock do
+// nothing for Contexts that don't share.
+func (c *Context) Lock() {
+	if c.share == nil {
+		return
+	}
+	c.share.mu.Lock()
+	if c.eglSurf != nilEGLSurface {
+		eglMakeCurrent(c.disp, c.eglSurf, c.eglSurf, c.eglCtx.ctx)
+	}
+}
+
+// Unlock releases c from the calling thread, for other Contexts of its
+// Share to lock.
+func (c *Context) Unlock() {
+	if c.share == nil {
+		return
+	}
+	c.ReleaseCurrent()
+	c.share.mu.Unlock()
+}
+
 func (c *Context) Present() error {
 	if !eglSwapBuffers(c.disp, c.eglSurf) {
 		return fmt.Errorf("eglSwapBuffers failed (%x)", eglGetError())
@@ -72,6 +152,24 @@ func (c *Context) Present() error {
 	return nil
 }
 
+// PresentDamage is like Present, but hints that only the region r of the
+// surface changed since the previous frame. The region is in surface
+// coordinates with the origin in the upper left corner.
+func (c *Context) PresentDamage(r image.Rectangle) error {
+	if !c.eglCtx.swapDamage || r.Empty() {
+		return c.Present()
+	}
+	// EGL damage rectangles have their origin in the lower left corner.
+	rect := []_EGLint{
+		_EGLint(r.Min.X), _EGLint(c.height - r.Max.Y),
+		_EGLint(r.Dx()), _EGLint(r.Dy()),
+	}
+	if !eglSwapBuffersWithDamage(c.disp, c.eglSurf, rect) {
+		return fmt.Errorf("eglSwapBuffersWithDamage failed (%x)", eglGetError())
+	}
+	return nil
+}
+
 func NewContext(disp NativeDisplayType) (*Context, error) {
 	if err := loadEGL(); err != nil {
 		return nil, err
@@ -226,6 +324,7 @@ func createContext(disp _EGLDisplay) (*eglContext, error) {
 		visualID:    int(visID),
 		srgb:        srgb,
 		surfaceless: hasExtension(exts, "EGL_KHR_surfaceless_context"),
+		swapDamage:  loadSwapBuffersWithDamage(exts),
 	}, nil
 }
 
@@ -13,11 +13,24 @@ package egl
 #cgo openbsd LDFLAGS: -L/usr/X11R6/lib
 #cgo CFLAGS: -DEGL_NO_X11
 
+#include <stdlib.h>
 #include <EGL/egl.h>
 #include <EGL/eglext.h>
+
+typedef EGLBoolean (EGLAPIENTRYP gio_swapDamageFunc)(EGLDisplay, EGLSurface, const EGLint *, EGLint);
+
+static EGLBoolean gio_eglSwapBuffersWithDamage(void *f, EGLDisplay disp, EGLSurface surf, EGLint *rects, EGLint n) {
+	return ((gio_swapDamageFunc)f)(disp, surf, rects, n);
+}
 */
 import "C"
 
+import "unsafe"
+
+// swapBuffersWithDamage is the eglSwapBuffersWithDamage{KHR,EXT} function,
+// if supported.
+var swapBuffersWithDamage unsafe.Pointer
+
 type (
 	_EGLint           = C.EGLint
 	_EGLDisplay       = C.EGLDisplay
@@ -82,6 +95,26 @@ func eglSwapBuffers(disp _EGLDisplay, surf _EGLSurface) bool {
 	return C.eglSwapBuffers(disp, surf) == C.EGL_TRUE
 }
 
+func loadSwapBuffersWithDamage(exts []string) bool {
+	var name string
+	switch {
+	case hasExtension(exts, "EGL_KHR_swap_buffers_with_damage"):
+		name = "eglSwapBuffersWithDamageKHR"
+	case hasExtension(exts, "EGL_EXT_swap_buffers_with_damage"):
+		name = "eglSwapBuffersWithDamageEXT"
+	default:
+		return false
+	}
+	cname := C.CString(name)
+	defer C.free(unsafe.Pointer(cname))
+	swapBuffersWithDamage = unsafe.Pointer(C.eglGetProcAddress(cname))
+	return swapBuffersWithDamage != nil
+}
+
+func eglSwapBuffersWithDamage(disp _EGLDisplay, surf _EGLSurface, rects []_EGLint) bool {
+	return C.gio_eglSwapBuffersWithDamage(swapBuffersWithDamage, disp, surf, &rects[0], C.EGLint(len(rects)/4)) == C.EGL_TRUE
+}
+
 func eglSwapInterval(disp _EGLDisplay, interval _EGLint) bool {
 	return C.eglSwapInterval(disp, interval) == C.EGL_TRUE
 }
@@ -137,6 +137,17 @@ func eglReleaseThread() bool {
 	return r != 0
 }
 
+// loadSwapBuffersWithDamage reports whether eglSwapBuffersWithDamage is
+// available. It is not used on Windows, where presentation is always of
+// the whole surface.
+func loadSwapBuffersWithDamage(exts []string) bool {
+	return false
+}
+
+func eglSwapBuffersWithDamage(disp _EGLDisplay, surf _EGLSurface, rects []_EGLint) bool {
+	return eglSwapBuffers(disp, surf)
+}
+
 func eglSwapInterval(disp _EGLDisplay, interval _EGLint) bool {
 	r, _, _ := _eglSwapInterval.Call(uintptr(disp), uintptr(interval))
 	return r != 0
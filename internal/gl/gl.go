@@ -10,6 +10,7 @@ type (
 const (
 	ACTIVE_TEXTURE                        = 0x84E0
 	ALL_BARRIER_BITS                      = 0xffffffff
+	ALREADY_SIGNALED                      = 0x911A
 	ARRAY_BUFFER                          = 0x8892
 	ARRAY_BUFFER_BINDING                  = 0x8894
 	BACK                                  = 0x0405
@@ -24,6 +25,9 @@ const (
 	COLOR_CLEAR_VALUE                     = 0x0C22
 	COMPILE_STATUS                        = 0x8b81
 	COMPUTE_SHADER                        = 0x91B9
+	CONDITION_SATISFIED                   = 0x911C
+	COPY_READ_BUFFER                      = 0x8F36
+	COPY_WRITE_BUFFER                     = 0x8F37
 	CURRENT_PROGRAM                       = 0x8B8D
 	DEPTH_ATTACHMENT                      = 0x8d00
 	DEPTH_BUFFER_BIT                      = 0x100
@@ -63,9 +67,11 @@ const (
 	NEAREST                               = 0x2600
 	NO_ERROR                              = 0x0
 	NUM_EXTENSIONS                        = 0x821D
+	NUM_PROGRAM_BINARY_FORMATS            = 0x87FE
 	ONE                                   = 0x1
 	ONE_MINUS_SRC_ALPHA                   = 0x303
 	PROGRAM_BINARY_LENGTH                 = 0x8741
+	PROGRAM_BINARY_RETRIEVABLE_HINT       = 0x8257
 	QUERY_RESULT                          = 0x8866
 	QUERY_RESULT_AVAILABLE                = 0x8867
 	R16F                                  = 0x822d
@@ -83,6 +89,8 @@ const (
 	RGB                                   = 0x1907
 	RGBA                                  = 0x1908
 	RGBA8                                 = 0x8058
+	PIXEL_PACK_BUFFER                     = 0x88EB
+	PIXEL_PACK_BUFFER_BINDING             = 0x88ED
 	SHADER_STORAGE_BUFFER                 = 0x90D2
 	SHADER_STORAGE_BUFFER_BINDING         = 0x90D3
 	SHORT                                 = 0x1402
@@ -92,6 +100,8 @@ const (
 	SRGB8_ALPHA8                          = 0x8c43
 	STATIC_DRAW                           = 0x88e4
 	STENCIL_BUFFER_BIT                    = 0x00000400
+	SYNC_FLUSH_COMMANDS_BIT               = 0x00000001
+	SYNC_GPU_COMMANDS_COMPLETE            = 0x9117
 	TEXTURE_2D                            = 0xde1
 	TEXTURE_BINDING_2D                    = 0x8069
 	TEXTURE_MAG_FILTER                    = 0x2800
@@ -108,6 +118,7 @@ const (
 	UNPACK_ALIGNMENT                      = 0xcf5
 	UNSIGNED_BYTE                         = 0x1401
 	UNSIGNED_SHORT                        = 0x1403
+	VENDOR                                = 0x1F00
 	VIEWPORT                              = 0x0BA2
 	VERSION                               = 0x1f02
 	VERTEX_ARRAY_BINDING                  = 0x85B5
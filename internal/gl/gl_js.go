@@ -125,9 +125,15 @@ func (f *Functions) ClearColor(red, green, blue, alpha float32) {
 func (f *Functions) ClearDepthf(d float32) {
 	f.Ctx.Call("clearDepth", d)
 }
+func (f *Functions) ClientWaitSync(s Sync, flags Enum, timeout uint64) Enum {
+	return Enum(f.Ctx.Call("clientWaitSync", js.Value(s), int(flags), timeout).Int())
+}
 func (f *Functions) CompileShader(s Shader) {
 	f.Ctx.Call("compileShader", js.Value(s))
 }
+func (f *Functions) CopyBufferSubData(readTarget, writeTarget Enum, readOffset, writeOffset, size int) {
+	f.Ctx.Call("copyBufferSubData", int(readTarget), int(writeTarget), readOffset, writeOffset, size)
+}
 func (f *Functions) CreateBuffer() Buffer {
 	return Buffer(f.Ctx.Call("createBuffer"))
 }
@@ -171,6 +177,9 @@ func (f *Functions) DeleteQuery(query Query) {
 func (f *Functions) DeleteShader(s Shader) {
 	f.Ctx.Call("deleteShader", js.Value(s))
 }
+func (f *Functions) DeleteSync(s Sync) {
+	f.Ctx.Call("deleteSync", js.Value(s))
+}
 func (f *Functions) DeleteRenderbuffer(v Renderbuffer) {
 	f.Ctx.Call("deleteRenderbuffer", js.Value(v))
 }
@@ -214,6 +223,9 @@ func (f *Functions) EndQuery(target Enum) {
 		f.EXT_disjoint_timer_query.Call("endQueryEXT", int(target))
 	}
 }
+func (f *Functions) FenceSync(condition Enum, flags Enum) Sync {
+	return Sync(f.Ctx.Call("fenceSync", int(condition), int(flags)))
+}
 func (f *Functions) Finish() {
 	f.Ctx.Call("finish")
 }
@@ -279,6 +291,9 @@ func (f *Functions) GetFloat4(pname Enum) [4]float32 {
 func (f *Functions) GetProgrami(p Program, pname Enum) int {
 	return paramVal(f.Ctx.Call("getProgramParameter", js.Value(p), int(pname)))
 }
+func (f *Functions) GetProgramBinary(p Program) ([]byte, Enum) {
+	panic("not supported")
+}
 func (f *Functions) GetProgramInfoLog(p Program) string {
 	return f.Ctx.Call("getProgramInfoLog", js.Value(p)).String()
 }
@@ -346,6 +361,12 @@ func (f *Functions) LinkProgram(p Program) {
 func (f *Functions) PixelStorei(pname Enum, param int32) {
 	f.Ctx.Call("pixelStorei", int(pname), param)
 }
+func (f *Functions) ProgramBinary(p Program, format Enum, binary []byte) {
+	panic("not supported")
+}
+func (f *Functions) ProgramParameteri(p Program, pname Enum, value int) {
+	panic("not supported")
+}
 func (f *Functions) MemoryBarrier(barriers Enum) {
 	panic("not implemented")
 }
@@ -32,6 +32,8 @@ typedef int GLint;
 typedef unsigned char GLboolean;
 typedef int GLsizei;
 typedef uint8_t GLubyte;
+typedef uint64_t GLuint64;
+typedef struct __GLsync *GLsync;
 
 typedef struct {
 	void (*glActiveTexture)(GLenum texture);
@@ -119,6 +121,8 @@ typedef struct {
 	void (*glGenQueries)(GLsizei n, GLuint *ids);
 	void (*glGenVertexArrays)(GLsizei n, GLuint *ids);
 	void (*glGetProgramBinary)(GLuint program, GLsizei bufsize, GLsizei *length, GLenum *binaryFormat, void *binary);
+	void (*glProgramBinary)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+	void (*glProgramParameteri)(GLuint program, GLenum pname, GLint value);
 	void (*glGetQueryObjectuiv)(GLuint id, GLenum pname, GLuint *params);
 	const GLubyte* (*glGetStringi)(GLenum name, GLuint index);
 	void (*glDispatchCompute)(GLuint x, GLuint y, GLuint z);
@@ -128,6 +132,10 @@ typedef struct {
 	void (*glBindImageTexture)(GLuint unit, GLuint texture, GLint level, GLboolean layered, GLint layer, GLenum access, GLenum format);
 	void (*glTexStorage2D)(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
 	void (*glBlitFramebuffer)(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
+	void (*glCopyBufferSubData)(GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size);
+	GLsync (*glFenceSync)(GLenum condition, GLbitfield flags);
+	GLenum (*glClientWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+	void (*glDeleteSync)(GLsync sync);
 } glFunctions;
 
 static void glActiveTexture(glFunctions *f, GLenum texture) {
@@ -478,6 +486,14 @@ static void glGetProgramBinary(glFunctions *f, GLuint program, GLsizei bufsize,
 	f->glGetProgramBinary(program, bufsize, length, binaryFormat, binary);
 }
 
+static void glProgramBinary(glFunctions *f, GLuint program, GLenum binaryFormat, const void *binary, GLsizei length) {
+	f->glProgramBinary(program, binaryFormat, binary, length);
+}
+
+static void glProgramParameteri(glFunctions *f, GLuint program, GLenum pname, GLint value) {
+	f->glProgramParameteri(program, pname, value);
+}
+
 static void glGetQueryObjectuiv(glFunctions *f, GLuint id, GLenum pname, GLuint *params) {
 	f->glGetQueryObjectuiv(id, pname, params);
 }
@@ -509,6 +525,22 @@ static void glTexStorage2D(glFunctions *f, GLenum target, GLsizei levels, GLenum
 static void glBlitFramebuffer(glFunctions *f, GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0, GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter) {
 	f->glBlitFramebuffer(srcX0, srcY0, srcX1, srcY1, dstX0, dstY0, dstX1, dstY1, mask, filter);
 }
+
+static void glCopyBufferSubData(glFunctions *f, GLenum readTarget, GLenum writeTarget, GLintptr readOffset, GLintptr writeOffset, GLsizeiptr size) {
+	f->glCopyBufferSubData(readTarget, writeTarget, readOffset, writeOffset, size);
+}
+
+static uintptr_t glFenceSync(glFunctions *f, GLenum condition, GLbitfield flags) {
+	return (uintptr_t)f->glFenceSync(condition, flags);
+}
+
+static GLenum glClientWaitSync(glFunctions *f, uintptr_t sync, GLbitfield flags, GLuint64 timeout) {
+	return f->glClientWaitSync((GLsync)sync, flags, timeout);
+}
+
+static void glDeleteSync(glFunctions *f, uintptr_t sync) {
+	f->glDeleteSync((GLsync)sync);
+}
 */
 import "C"
 
@@ -702,7 +734,13 @@ func (f *Functions) load(forceES bool) error {
 	f.f.glBindImageTexture = load("glBindImageTexture")
 	f.f.glTexStorage2D = load("glTexStorage2D")
 	f.f.glBlitFramebuffer = load("glBlitFramebuffer")
+	f.f.glCopyBufferSubData = load("glCopyBufferSubData")
+	f.f.glFenceSync = load("glFenceSync")
+	f.f.glClientWaitSync = load("glClientWaitSync")
+	f.f.glDeleteSync = load("glDeleteSync")
 	f.f.glGetProgramBinary = load("glGetProgramBinary")
+	f.f.glProgramBinary = load("glProgramBinary")
+	f.f.glProgramParameteri = load("glProgramParameteri")
 
 	return loadErr
 }
@@ -801,10 +839,18 @@ func (f *Functions) ClearDepthf(d float32) {
 	C.glClearDepthf(&f.f, C.GLfloat(d))
 }
 
+func (f *Functions) ClientWaitSync(s Sync, flags Enum, timeout uint64) Enum {
+	return Enum(C.glClientWaitSync(&f.f, C.uintptr_t(s.V), C.GLbitfield(flags), C.GLuint64(timeout)))
+}
+
 func (f *Functions) CompileShader(s Shader) {
 	C.glCompileShader(&f.f, C.GLuint(s.V))
 }
 
+func (f *Functions) CopyBufferSubData(readTarget, writeTarget Enum, readOffset, writeOffset, size int) {
+	C.glCopyBufferSubData(&f.f, C.GLenum(readTarget), C.GLenum(writeTarget), C.GLintptr(readOffset), C.GLintptr(writeOffset), C.GLsizeiptr(size))
+}
+
 func (f *Functions) CreateBuffer() Buffer {
 	C.glGenBuffers(&f.f, 1, &f.uints[0])
 	return Buffer{uint(f.uints[0])}
@@ -876,6 +922,10 @@ func (f *Functions) DeleteShader(s Shader) {
 	C.glDeleteShader(&f.f, C.GLuint(s.V))
 }
 
+func (f *Functions) DeleteSync(s Sync) {
+	C.glDeleteSync(&f.f, C.uintptr_t(s.V))
+}
+
 func (f *Functions) DeleteTexture(v Texture) {
 	f.uints[0] = C.GLuint(v.V)
 	C.glDeleteTextures(&f.f, 1, &f.uints[0])
@@ -925,6 +975,10 @@ func (f *Functions) EnableVertexAttribArray(a Attrib) {
 	C.glEnableVertexAttribArray(&f.f, C.GLuint(a))
 }
 
+func (f *Functions) FenceSync(condition Enum, flags Enum) Sync {
+	return Sync{uintptr(C.glFenceSync(&f.f, C.GLenum(condition), C.GLbitfield(flags)))}
+}
+
 func (f *Functions) Finish() {
 	C.glFinish(&f.f)
 }
@@ -1001,15 +1055,24 @@ func (f *Functions) GetProgrami(p Program, pname Enum) int {
 	return int(f.ints[0])
 }
 
-func (f *Functions) GetProgramBinary(p Program) []byte {
+func (f *Functions) GetProgramBinary(p Program) ([]byte, Enum) {
 	sz := f.GetProgrami(p, PROGRAM_BINARY_LENGTH)
 	if sz == 0 {
-		return nil
+		return nil, 0
 	}
 	buf := make([]byte, sz)
+	var n C.GLsizei
 	var format C.GLenum
-	C.glGetProgramBinary(&f.f, C.GLuint(p.V), C.GLsizei(sz), nil, &format, unsafe.Pointer(&buf[0]))
-	return buf
+	C.glGetProgramBinary(&f.f, C.GLuint(p.V), C.GLsizei(sz), &n, &format, unsafe.Pointer(&buf[0]))
+	return buf[:n], Enum(format)
+}
+
+func (f *Functions) ProgramBinary(p Program, format Enum, binary []byte) {
+	C.glProgramBinary(&f.f, C.GLuint(p.V), C.GLenum(format), unsafe.Pointer(&binary[0]), C.GLsizei(len(binary)))
+}
+
+func (f *Functions) ProgramParameteri(p Program, pname Enum, value int) {
+	C.glProgramParameteri(&f.f, C.GLuint(p.V), C.GLenum(pname), C.GLint(value))
 }
 
 func (f *Functions) GetProgramInfoLog(p Program) string {
@@ -31,6 +31,8 @@ var (
 	_glClear                               = LibGLESv2.NewProc("glClear")
 	_glClearColor                          = LibGLESv2.NewProc("glClearColor")
 	_glClearDepthf                         = LibGLESv2.NewProc("glClearDepthf")
+	_glClientWaitSync                      = LibGLESv2.NewProc("glClientWaitSync")
+	_glCopyBufferSubData                   = LibGLESv2.NewProc("glCopyBufferSubData")
 	_glDeleteQueries                       = LibGLESv2.NewProc("glDeleteQueries")
 	_glDeleteVertexArrays                  = LibGLESv2.NewProc("glDeleteVertexArrays")
 	_glCompileShader                       = LibGLESv2.NewProc("glCompileShader")
@@ -46,6 +48,7 @@ var (
 	_glDeleteFramebuffers                  = LibGLESv2.NewProc("glDeleteFramebuffers")
 	_glDeleteProgram                       = LibGLESv2.NewProc("glDeleteProgram")
 	_glDeleteShader                        = LibGLESv2.NewProc("glDeleteShader")
+	_glDeleteSync                          = LibGLESv2.NewProc("glDeleteSync")
 	_glDeleteRenderbuffers                 = LibGLESv2.NewProc("glDeleteRenderbuffers")
 	_glDeleteTextures                      = LibGLESv2.NewProc("glDeleteTextures")
 	_glDepthFunc                           = LibGLESv2.NewProc("glDepthFunc")
@@ -57,6 +60,7 @@ var (
 	_glEnable                              = LibGLESv2.NewProc("glEnable")
 	_glEnableVertexAttribArray             = LibGLESv2.NewProc("glEnableVertexAttribArray")
 	_glEndQuery                            = LibGLESv2.NewProc("glEndQuery")
+	_glFenceSync                           = LibGLESv2.NewProc("glFenceSync")
 	_glFinish                              = LibGLESv2.NewProc("glFinish")
 	_glFlush                               = LibGLESv2.NewProc("glFlush")
 	_glFramebufferRenderbuffer             = LibGLESv2.NewProc("glFramebufferRenderbuffer")
@@ -68,6 +72,7 @@ var (
 	_glGetFramebufferAttachmentParameteriv = LibGLESv2.NewProc("glGetFramebufferAttachmentParameteriv")
 	_glGetIntegerv                         = LibGLESv2.NewProc("glGetIntegerv")
 	_glGetIntegeri_v                       = LibGLESv2.NewProc("glGetIntegeri_v")
+	_glGetProgramBinary                    = LibGLESv2.NewProc("glGetProgramBinary")
 	_glGetProgramiv                        = LibGLESv2.NewProc("glGetProgramiv")
 	_glGetProgramInfoLog                   = LibGLESv2.NewProc("glGetProgramInfoLog")
 	_glGetQueryObjectuiv                   = LibGLESv2.NewProc("glGetQueryObjectuiv")
@@ -80,7 +85,10 @@ var (
 	_glInvalidateFramebuffer               = LibGLESv2.NewProc("glInvalidateFramebuffer")
 	_glIsEnabled                           = LibGLESv2.NewProc("glIsEnabled")
 	_glLinkProgram                         = LibGLESv2.NewProc("glLinkProgram")
+	_glMapBufferRange                      = LibGLESv2.NewProc("glMapBufferRange")
 	_glPixelStorei                         = LibGLESv2.NewProc("glPixelStorei")
+	_glProgramBinary                       = LibGLESv2.NewProc("glProgramBinary")
+	_glProgramParameteri                   = LibGLESv2.NewProc("glProgramParameteri")
 	_glReadPixels                          = LibGLESv2.NewProc("glReadPixels")
 	_glRenderbufferStorage                 = LibGLESv2.NewProc("glRenderbufferStorage")
 	_glScissor                             = LibGLESv2.NewProc("glScissor")
@@ -95,6 +103,7 @@ var (
 	_glUniform2f                           = LibGLESv2.NewProc("glUniform2f")
 	_glUniform3f                           = LibGLESv2.NewProc("glUniform3f")
 	_glUniform4f                           = LibGLESv2.NewProc("glUniform4f")
+	_glUnmapBuffer                         = LibGLESv2.NewProc("glUnmapBuffer")
 	_glUseProgram                          = LibGLESv2.NewProc("glUseProgram")
 	_glVertexAttribPointer                 = LibGLESv2.NewProc("glVertexAttribPointer")
 	_glViewport                            = LibGLESv2.NewProc("glViewport")
@@ -350,6 +359,17 @@ func (c *Functions) GetProgrami(p Program, pname Enum) int {
 	syscall.Syscall(_glGetProgramiv.Addr(), 3, uintptr(p.V), uintptr(pname), uintptr(unsafe.Pointer(&c.int32s[0])))
 	return int(c.int32s[0])
 }
+func (c *Functions) GetProgramBinary(p Program) ([]byte, Enum) {
+	sz := c.GetProgrami(p, PROGRAM_BINARY_LENGTH)
+	if sz == 0 {
+		return nil, 0
+	}
+	buf := make([]byte, sz)
+	var n int32
+	var format uint32
+	syscall.Syscall6(_glGetProgramBinary.Addr(), 5, uintptr(p.V), uintptr(sz), uintptr(unsafe.Pointer(&n)), uintptr(unsafe.Pointer(&format)), uintptr(unsafe.Pointer(&buf[0])), 0)
+	return buf[:n], Enum(format)
+}
 func (c *Functions) GetProgramInfoLog(p Program) string {
 	n := c.GetProgrami(p, INFO_LOG_LENGTH)
 	buf := make([]byte, n)
@@ -415,13 +435,47 @@ func (c *Functions) PixelStorei(pname Enum, param int32) {
 func (f *Functions) MemoryBarrier(barriers Enum) {
 	panic("not implemented")
 }
+func (f *Functions) ClientWaitSync(s Sync, flags Enum, timeout uint64) Enum {
+	var r uintptr
+	if unsafe.Sizeof(uintptr(0)) == 4 {
+		// The 64-bit timeout takes two words on 32-bit platforms.
+		r, _, _ = syscall.Syscall6(_glClientWaitSync.Addr(), 4, s.V, uintptr(flags), uintptr(timeout), uintptr(timeout>>32), 0, 0)
+	} else {
+		r, _, _ = syscall.Syscall(_glClientWaitSync.Addr(), 3, s.V, uintptr(flags), uintptr(timeout))
+	}
+	return Enum(r)
+}
+func (f *Functions) CopyBufferSubData(readTarget, writeTarget Enum, readOffset, writeOffset, size int) {
+	syscall.Syscall6(_glCopyBufferSubData.Addr(), 5, uintptr(readTarget), uintptr(writeTarget), uintptr(readOffset), uintptr(writeOffset), uintptr(size), 0)
+}
+func (f *Functions) DeleteSync(s Sync) {
+	syscall.Syscall(_glDeleteSync.Addr(), 1, s.V, 0, 0)
+}
+func (f *Functions) FenceSync(condition Enum, flags Enum) Sync {
+	s, _, _ := syscall.Syscall(_glFenceSync.Addr(), 2, uintptr(condition), uintptr(flags), 0)
+	return Sync{s}
+}
 func (f *Functions) MapBufferRange(target Enum, offset, length int, access Enum) []byte {
-	panic("not implemented")
+	p, _, _ := syscall.Syscall6(_glMapBufferRange.Addr(), 4, uintptr(target), uintptr(offset), uintptr(length), uintptr(access), 0, 0)
+	if p == 0 {
+		return nil
+	}
+	return (*[1 << 30]byte)(unsafe.Pointer(p))[:length:length]
 }
 func (f *Functions) ReadPixels(x, y, width, height int, format, ty Enum, data []byte) {
-	d0 := &data[0]
-	syscall.Syscall9(_glReadPixels.Addr(), 7, uintptr(x), uintptr(y), uintptr(width), uintptr(height), uintptr(format), uintptr(ty), uintptr(unsafe.Pointer(d0)), 0, 0)
-	issue34474KeepAlive(d0)
+	var p unsafe.Pointer
+	if len(data) > 0 {
+		p = unsafe.Pointer(&data[0])
+	}
+	syscall.Syscall9(_glReadPixels.Addr(), 7, uintptr(x), uintptr(y), uintptr(width), uintptr(height), uintptr(format), uintptr(ty), uintptr(p), 0, 0)
+	issue34474KeepAlive(p)
+}
+func (c *Functions) ProgramBinary(p Program, format Enum, binary []byte) {
+	syscall.Syscall6(_glProgramBinary.Addr(), 4, uintptr(p.V), uintptr(format), uintptr(unsafe.Pointer(&binary[0])), uintptr(len(binary)), 0, 0)
+	issue34474KeepAlive(binary)
+}
+func (c *Functions) ProgramParameteri(p Program, pname Enum, value int) {
+	syscall.Syscall(_glProgramParameteri.Addr(), 3, uintptr(p.V), uintptr(pname), uintptr(value))
 }
 func (c *Functions) RenderbufferStorage(target, internalformat Enum, width, height int) {
 	syscall.Syscall6(_glRenderbufferStorage.Addr(), 4, uintptr(target), uintptr(internalformat), uintptr(width), uintptr(height), 0, 0)
@@ -471,7 +525,8 @@ func (c *Functions) UseProgram(p Program) {
 	syscall.Syscall(_glUseProgram.Addr(), 1, uintptr(p.V), 0, 0)
 }
 func (f *Functions) UnmapBuffer(target Enum) bool {
-	panic("not implemented")
+	r, _, _ := syscall.Syscall(_glUnmapBuffer.Addr(), 1, uintptr(target), 0, 0)
+	return r == TRUE
 }
 func (c *Functions) VertexAttribPointer(dst Attrib, size int, ty Enum, normalized bool, stride, offset int) {
 	var norm uintptr
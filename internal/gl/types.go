@@ -11,6 +11,7 @@ type (
 	Shader       Object
 	Texture      Object
 	Query        Object
+	Sync         struct{ V uintptr }
 	Uniform      struct{ V int }
 	VertexArray  Object
 )
@@ -13,6 +13,7 @@ type (
 	Shader       Object
 	Texture      Object
 	Query        Object
+	Sync         Object
 	Uniform      Object
 	VertexArray  Object
 )
@@ -8,7 +8,10 @@ import (
 	"strings"
 )
 
-func CreateProgram(ctx *Functions, vsSrc, fsSrc string, attribs []string) (Program, error) {
+// CreateProgram creates a program from vertex and fragment shader sources.
+// If retrievable is set, the program binary is made available to
+// GetProgramBinary.
+func CreateProgram(ctx *Functions, vsSrc, fsSrc string, attribs []string, retrievable bool) (Program, error) {
 	vs, err := createShader(ctx, VERTEX_SHADER, vsSrc)
 	if err != nil {
 		return Program{}, err
@@ -28,16 +31,12 @@ func CreateProgram(ctx *Functions, vsSrc, fsSrc string, attribs []string) (Progr
 	for i, a := range attribs {
 		ctx.BindAttribLocation(prog, Attrib(i), a)
 	}
-	ctx.LinkProgram(prog)
-	if ctx.GetProgrami(prog, LINK_STATUS) == 0 {
-		log := ctx.GetProgramInfoLog(prog)
-		ctx.DeleteProgram(prog)
-		return Program{}, fmt.Errorf("program link failed: %s", strings.TrimSpace(log))
-	}
-	return prog, nil
+	return linkProgram(ctx, prog, retrievable)
 }
 
-func CreateComputeProgram(ctx *Functions, src string) (Program, error) {
+// CreateComputeProgram creates a program from a compute shader source. See
+// CreateProgram for retrievable.
+func CreateComputeProgram(ctx *Functions, src string, retrievable bool) (Program, error) {
 	cs, err := createShader(ctx, COMPUTE_SHADER, src)
 	if err != nil {
 		return Program{}, err
@@ -48,6 +47,15 @@ func CreateComputeProgram(ctx *Functions, src string) (Program, error) {
 		return Program{}, errors.New("glCreateProgram failed")
 	}
 	ctx.AttachShader(prog, cs)
+	return linkProgram(ctx, prog, retrievable)
+}
+
+func linkProgram(ctx *Functions, prog Program, retrievable bool) (Program, error) {
+	if retrievable {
+		// Some drivers only keep binaries of programs that ask for it
+		// before linking.
+		ctx.ProgramParameteri(prog, PROGRAM_BINARY_RETRIEVABLE_HINT, TRUE)
+	}
 	ctx.LinkProgram(prog)
 	if ctx.GetProgrami(prog, LINK_STATUS) == 0 {
 		log := ctx.GetProgramInfoLog(prog)
@@ -57,6 +65,21 @@ func CreateComputeProgram(ctx *Functions, src string) (Program, error) {
 	return prog, nil
 }
 
+// CreateProgramBinary creates a program from a binary returned by
+// GetProgramBinary.
+func CreateProgramBinary(ctx *Functions, format Enum, binary []byte) (Program, error) {
+	prog := ctx.CreateProgram()
+	if !prog.Valid() {
+		return Program{}, errors.New("glCreateProgram failed")
+	}
+	ctx.ProgramBinary(prog, format, binary)
+	if ctx.GetProgrami(prog, LINK_STATUS) == 0 {
+		ctx.DeleteProgram(prog)
+		return Program{}, errors.New("program binary rejected")
+	}
+	return prog, nil
+}
+
 func createShader(ctx *Functions, typ Enum, src string) (Shader, error) {
 	sh := ctx.CreateShader(typ)
 	if !sh.Valid() {
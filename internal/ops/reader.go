@@ -11,12 +11,27 @@ import (
 )
 
 // Reader parses an ops list.
+//
+// The state IDs of save and load operations are allocated per op.Ops,
+// so Reader offsets the IDs of every op.Ops called from the ops list
+// to keep them distinct from the IDs of the list.
 type Reader struct {
 	pc        PC
 	stack     []macro
 	ops       *op.Ops
 	deferOps  op.Ops
 	deferDone bool
+
+	// root is the ops list being read.
+	root *op.Ops
+	// stateBase is the state ID offset of ops.
+	stateBase int
+	// stateBases maps called ops lists to their state ID offsets.
+	stateBases map[*op.Ops]int
+	// nextStateBase is the offset of the next called ops list.
+	nextStateBase int
+	// stateData holds a save or load operation with its ID offset.
+	stateData [opconst.TypeLoadLen]byte
 }
 
 // EncodedOp represents an encoded op returned by
@@ -48,9 +63,10 @@ type PC struct {
 }
 
 type macro struct {
-	ops   *op.Ops
-	retPC PC
-	endPC PC
+	ops       *op.Ops
+	stateBase int
+	retPC     PC
+	endPC     PC
 }
 
 type opMacroDef struct {
@@ -69,6 +85,15 @@ func (r *Reader) ResetAt(ops *op.Ops, pc PC) {
 	r.deferDone = false
 	r.pc = pc
 	r.ops = ops
+	r.root = ops
+	r.stateBase = 0
+	r.nextStateBase = 0
+	if ops != nil {
+		r.nextStateBase = ops.StateIDs()
+	}
+	for o := range r.stateBases {
+		delete(r.stateBases, o)
+	}
 }
 
 // NewPC returns a PC representing the current instruction counter of
@@ -99,6 +124,7 @@ func (r *Reader) Decode() (EncodedOp, bool) {
 			b := r.stack[len(r.stack)-1]
 			if r.pc == b.endPC {
 				r.ops = b.ops
+				r.stateBase = b.stateBase
 				r.pc = b.retPC
 				r.stack = r.stack[:len(r.stack)-1]
 				continue
@@ -114,6 +140,7 @@ func (r *Reader) Decode() (EncodedOp, bool) {
 			r.deferDone = true
 			// Execute deferred macros.
 			r.ops = &r.deferOps
+			r.stateBase = 0
 			r.pc = PC{}
 			continue
 		}
@@ -159,11 +186,13 @@ func (r *Reader) Decode() (EncodedOp, bool) {
 			retPC.data += n
 			retPC.refs += nrefs
 			r.stack = append(r.stack, macro{
-				ops:   r.ops,
-				retPC: retPC,
-				endPC: opDef.endpc,
+				ops:       r.ops,
+				stateBase: r.stateBase,
+				retPC:     retPC,
+				endPC:     opDef.endpc,
 			})
 			r.ops = op.ops
+			r.stateBase = r.stateBaseFor(op.ops)
 			r.pc = op.pc
 			r.pc.data += opconst.TypeMacro.Size()
 			r.pc.refs += opconst.TypeMacro.NumRefs()
@@ -173,6 +202,10 @@ func (r *Reader) Decode() (EncodedOp, bool) {
 			op.decode(data)
 			r.pc = op.endpc
 			continue
+		case opconst.TypeSave, opconst.TypeLoad:
+			if r.stateBase != 0 {
+				data = r.offsetState(data)
+			}
 		}
 		r.pc.data += n
 		r.pc.refs += nrefs
@@ -180,6 +213,41 @@ func (r *Reader) Decode() (EncodedOp, bool) {
 	}
 }
 
+// stateBaseFor returns the state ID offset of the ops list o, allocating
+// one if o is called for the first time.
+func (r *Reader) stateBaseFor(o *op.Ops) int {
+	if o == r.root {
+		return 0
+	}
+	if base, ok := r.stateBases[o]; ok {
+		return base
+	}
+	if r.stateBases == nil {
+		r.stateBases = make(map[*op.Ops]int)
+	}
+	base := r.nextStateBase
+	r.stateBases[o] = base
+	r.nextStateBase += o.StateIDs()
+	return base
+}
+
+// offsetState returns a copy of a save or load operation with its state
+// ID offset by the state ID offset of the current ops list.
+func (r *Reader) offsetState(data []byte) []byte {
+	idx := 1
+	if opconst.OpType(data[0]) == opconst.TypeLoad {
+		idx = 2
+	}
+	cp := r.stateData[:len(data)]
+	copy(cp, data)
+	bo := binary.LittleEndian
+	// The initial state is shared by every ops list.
+	if id := bo.Uint32(cp[idx:]); id != opconst.InitialStateID {
+		bo.PutUint32(cp[idx:], id+uint32(r.stateBase))
+	}
+	return cp
+}
+
 func (op *opMacroDef) decode(data []byte) {
 	if opconst.OpType(data[0]) != opconst.TypeMacro {
 		panic("invalid op")
@@ -42,12 +42,40 @@ const (
 
 const CommandSize = int(unsafe.Sizeof(Command{}))
 
+// FillGradient is set in the index of FillImage commands that fill with a
+// linear gradient, see LinearGradient.
+const FillGradient = 1 << 31
+
 const sceneElemSize = 36
 
 func (c Command) Op() Op {
 	return Op(c[0])
 }
 
+// Words returns the number of words of c used by its op, including the
+// op itself. The packed scene encoding stores only those words.
+func (c Command) Words() int {
+	switch Op(c[0]) {
+	case OpNop:
+		return 1
+	case OpLine, OpBeginClip, OpEndClip:
+		return 5
+	case OpQuad, OpTransform:
+		return 7
+	case OpCubic:
+		return 9
+	case OpFillColor, OpLineWidth, OpSetFillMode:
+		return 2
+	case OpFillImage:
+		if c[1]&FillGradient != 0 {
+			return 8
+		}
+		return 3
+	default:
+		panic("unreachable")
+	}
+}
+
 func (c Command) String() string {
 	switch Op(c[0]) {
 	case OpNop:
@@ -88,6 +116,9 @@ func (c Command) String() string {
 		}
 		return fmt.Sprintf("endclip (%v)", bounds)
 	case OpFillImage:
+		if c[1]&FillGradient != 0 {
+			return "lineargradient"
+		}
 		return "fillimage"
 	case OpSetFillMode:
 		return "setfillmode"
@@ -175,7 +206,7 @@ func EndClip(bbox f32.Rectangle) Command {
 func FillColor(col color.RGBA) Command {
 	return Command{
 		0: uint32(OpFillColor),
-		1: uint32(col.R)<<24 | uint32(col.G)<<16 | uint32(col.B)<<8 | uint32(col.A),
+		1: packColor(col),
 	}
 }
 
@@ -186,6 +217,34 @@ func FillImage(index int) Command {
 	}
 }
 
+// LinearGradient returns a FillImage command for the command at index in
+// the scene. The gradient mixes col1 and col2 by the value of
+//
+//	line[0]*x + line[1]*y + line[2]
+//
+// at output pixel (x, y), clamped to [0, 1].
+func LinearGradient(index int, line [3]float32, col1, col2 color.RGBA) Command {
+	c := Command{
+		0: uint32(OpFillImage),
+		1: uint32(index) | FillGradient,
+		6: packColor(col1),
+		7: packColor(col2),
+	}
+	SetGradientLine(&c, line)
+	return c
+}
+
+// SetGradientLine replaces the line of a LinearGradient command.
+func SetGradientLine(c *Command, line [3]float32) {
+	c[3] = math.Float32bits(line[0])
+	c[4] = math.Float32bits(line[1])
+	c[5] = math.Float32bits(line[2])
+}
+
+func packColor(col color.RGBA) uint32 {
+	return uint32(col.R)<<24 | uint32(col.G)<<16 | uint32(col.B)<<8 | uint32(col.A)
+}
+
 func SetFillMode(mode FillMode) Command {
 	return Command{
 		0: uint32(OpSetFillMode),
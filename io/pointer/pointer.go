@@ -40,6 +40,15 @@ type Event struct {
 	// Modifiers is the set of active modifiers when
 	// the mouse button was pressed.
 	Modifiers key.Modifiers
+	// History holds the earlier samples of Move and Drag events
+	// coalesced into this event, oldest first.
+	History []Sample
+}
+
+// Sample is the time and position of a coalesced pointer event.
+type Sample struct {
+	Time     time.Duration
+	Position f32.Point
 }
 
 // AreaOp updates the hit area to the intersection of the current
@@ -198,10 +207,34 @@ func (op AreaOp) Add(o *op.Ops) {
 }
 
 func (op CursorNameOp) Add(o *op.Ops) {
-	data := o.Write1(opconst.TypeCursorLen, op.Name)
+	data := o.Write1(opconst.TypeCursorLen, op.Name.ref())
 	data[0] = byte(opconst.TypeCursor)
 }
 
+// ref returns n as an interface value. The predefined names are
+// converted from constants, which doesn't allocate.
+func (n CursorName) ref() interface{} {
+	switch n {
+	case CursorDefault:
+		return CursorDefault
+	case CursorText:
+		return CursorText
+	case CursorPointer:
+		return CursorPointer
+	case CursorCrossHair:
+		return CursorCrossHair
+	case CursorColResize:
+		return CursorColResize
+	case CursorRowResize:
+		return CursorRowResize
+	case CursorGrab:
+		return CursorGrab
+	case CursorNone:
+		return CursorNone
+	}
+	return n
+}
+
 // Add panics if the scroll range does not contain zero.
 func (op InputOp) Add(o *op.Ops) {
 	if op.Tag == nil {
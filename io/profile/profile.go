@@ -5,6 +5,8 @@
 package profile
 
 import (
+	"time"
+
 	"gioui.org/internal/opconst"
 	"gioui.org/io/event"
 	"gioui.org/op"
@@ -21,6 +23,68 @@ type Op struct {
 type Event struct {
 	// Timings. Very likely to change.
 	Timings string
+	// Frame is the profile of the frame. Very likely to change.
+	Frame Frame
+}
+
+// Frame is the profile of a rendered frame.
+type Frame struct {
+	// Total is the time spent by the window on the frame.
+	Total time.Duration
+	// Submit is the time from the start of the frame until it was
+	// ready for presentation, including the time spent by the
+	// program producing its operations.
+	Submit time.Duration
+	// Present is the time spent presenting the frame, which may
+	// include waiting for the display.
+	Present time.Duration
+	// Interval is the estimated refresh interval of the display, or
+	// zero if unknown.
+	Interval time.Duration
+	// Delay is the time the window delayed the start of the frame
+	// to present it closer to the display deadline.
+	Delay time.Duration
+	// Collect is the CPU time spent collecting the operations
+	// of the frame.
+	Collect time.Duration
+	// Encode is the CPU time spent encoding the collected
+	// operations for rendering. It is zero for renderers that draw
+	// the collected operations directly.
+	Encode time.Duration
+	// Stages are the GPU durations of the rendering stages, in
+	// rendering order. GPU timings are measured asynchronously so
+	// Stages may be from an earlier frame, and is empty if the GPU
+	// has no timer support.
+	Stages []Stage
+	// UploadBytes is the number of bytes uploaded to the GPU.
+	UploadBytes int
+	// Elements and PathSegments count the scene elements and path
+	// segments rendered by a compute renderer.
+	Elements, PathSegments int
+	// AtlasUsed is the area in pixels used in texture atlases, out of
+	// a total area of AtlasSize.
+	AtlasUsed, AtlasSize int
+	// MemorySize is the size in bytes of the memory for the
+	// intermediate results of a compute renderer.
+	MemorySize int
+	// MemoryRetries counts the times the frame was rendered again for
+	// lack of memory.
+	MemoryRetries int
+}
+
+// Stage is the GPU duration of a rendering stage.
+type Stage struct {
+	Name     string
+	Duration time.Duration
+}
+
+// GPU returns the sum of the stage durations.
+func (f Frame) GPU() time.Duration {
+	var d time.Duration
+	for _, s := range f.Stages {
+		d += s.Duration
+	}
+	return d
 }
 
 func (p Op) Add(o *op.Ops) {
@@ -7,7 +7,6 @@ import (
 	"gioui.org/internal/ops"
 	"gioui.org/io/event"
 	"gioui.org/io/key"
-	"gioui.org/op"
 )
 
 type TextInputState uint8
@@ -15,9 +14,14 @@ type TextInputState uint8
 type keyQueue struct {
 	focus    event.Tag
 	handlers map[event.Tag]*keyHandler
-	reader   ops.Reader
 	state    TextInputState
 	hint     key.InputHint
+
+	// The focus and text input state requested by the ops
+	// of the current frame.
+	newFocus     event.Tag
+	focusChanged bool
+	newState     TextInputState
 }
 
 type keyHandler struct {
@@ -54,16 +58,20 @@ func (q *keyQueue) InputHint() (key.InputHint, bool) {
 	return q.hint, old != q.hint
 }
 
-func (q *keyQueue) Frame(root *op.Ops, events *handlerEvents) {
+// beginFrame prepares the queue for the ops of a new frame.
+func (q *keyQueue) beginFrame() {
 	if q.handlers == nil {
 		q.handlers = make(map[event.Tag]*keyHandler)
 	}
 	for _, h := range q.handlers {
 		h.visible, h.new = false, false
 	}
-	q.reader.Reset(root)
+	q.newFocus, q.focusChanged, q.newState = nil, false, TextInputKeep
+}
 
-	focus, changed, state := q.resolveFocus(events)
+// endFrame resolves the focus from the ops collected since beginFrame.
+func (q *keyQueue) endFrame(events *handlerEvents) {
+	focus, changed, state := q.newFocus, q.focusChanged, q.newState
 	for k, h := range q.handlers {
 		if !h.visible {
 			delete(q.handlers, k)
@@ -102,32 +110,30 @@ func (q *keyQueue) Push(e event.Event, events *handlerEvents) {
 	}
 }
 
-func (q *keyQueue) resolveFocus(events *handlerEvents) (focus event.Tag, changed bool, state TextInputState) {
-	for encOp, ok := q.reader.Decode(); ok; encOp, ok = q.reader.Decode() {
-		switch opconst.OpType(encOp.Data[0]) {
-		case opconst.TypeKeyFocus:
-			op := decodeFocusOp(encOp.Data, encOp.Refs)
-			changed = true
-			focus = op.Tag
-		case opconst.TypeKeySoftKeyboard:
-			op := decodeSoftKeyboardOp(encOp.Data, encOp.Refs)
-			if op.Show {
-				state = TextInputOpen
-			} else {
-				state = TextInputClose
-			}
-		case opconst.TypeKeyInput:
-			op := decodeKeyInputOp(encOp.Data, encOp.Refs)
-			h, ok := q.handlers[op.Tag]
-			if !ok {
-				h = &keyHandler{new: true}
-				q.handlers[op.Tag] = h
-			}
-			h.visible = true
-			h.hint = op.Hint
+// collectOp updates the handlers and focus from a key related op.
+func (q *keyQueue) collectOp(encOp ops.EncodedOp) {
+	switch opconst.OpType(encOp.Data[0]) {
+	case opconst.TypeKeyFocus:
+		op := decodeFocusOp(encOp.Data, encOp.Refs)
+		q.focusChanged = true
+		q.newFocus = op.Tag
+	case opconst.TypeKeySoftKeyboard:
+		op := decodeSoftKeyboardOp(encOp.Data, encOp.Refs)
+		if op.Show {
+			q.newState = TextInputOpen
+		} else {
+			q.newState = TextInputClose
+		}
+	case opconst.TypeKeyInput:
+		op := decodeKeyInputOp(encOp.Data, encOp.Refs)
+		h, ok := q.handlers[op.Tag]
+		if !ok {
+			h = &keyHandler{new: true}
+			q.handlers[op.Tag] = h
 		}
+		h.visible = true
+		h.hint = op.Hint
 	}
-	return
 }
 
 func decodeKeyInputOp(d []byte, refs []interface{}) key.InputOp {
@@ -11,18 +11,19 @@ import (
 	"gioui.org/internal/ops"
 	"gioui.org/io/event"
 	"gioui.org/io/pointer"
-	"gioui.org/op"
 )
 
 type pointerQueue struct {
 	hitTree  []hitNode
 	areas    []areaNode
+	grid     hitGrid
 	cursors  []cursorNode
 	cursor   pointer.CursorName
 	handlers map[event.Tag]*pointerHandler
 	pointers []pointerInfo
-	reader   ops.Reader
 
+	// state is the current collect state.
+	state collectState
 	// states holds the storage for save/restore ops.
 	states  []collectState
 	scratch []event.Tag
@@ -53,6 +54,15 @@ type pointerInfo struct {
 
 	// entered tracks the tags that contain the pointer.
 	entered []event.Tag
+
+	// coalesce is set when the most recent event was a move
+	// delivered to a handler, and following moves can be coalesced.
+	coalesce bool
+	// pending is the most recent coalesced move, delivered by
+	// flush. history holds the samples of the moves it replaced.
+	pending    pointer.Event
+	hasPending bool
+	history    []pointer.Sample
 }
 
 type pointerHandler struct {
@@ -70,14 +80,41 @@ type areaOp struct {
 }
 
 type areaNode struct {
-	trans f32.Affine2D
-	next  int
-	area  areaOp
+	// invTrans transforms from window coordinates to the
+	// coordinates of the area.
+	invTrans f32.Affine2D
+	next     int
+	area     areaOp
+	// bounds is a conservative bounding box in window coordinates
+	// of the area intersected with its parents.
+	bounds f32.Rectangle
+}
+
+// hitGrid is a uniform grid over the bounds of the hit tree, for
+// quickly finding the nodes that may contain a point. Nodes not
+// listed in the cell containing a point are never hit by it.
+type hitGrid struct {
+	// valid is false when the grid needs to be rebuilt from the
+	// hit tree.
+	valid      bool
+	bounds     f32.Rectangle
+	cols, rows int
+	cellSize   f32.Point
+	// The nodes of cell i are nodes[cells[i]:cells[i+1]], in
+	// increasing hit tree order.
+	cells []int
+	nodes []int
+	// unbounded lists the nodes without an area, which are hit
+	// everywhere.
+	unbounded []int
 }
 
+// gridMaxDim is the maximum number of grid cells along each axis.
+const gridMaxDim = 64
+
 type areaKind uint8
 
-// collectState represents the state for collectHandlers
+// collectState represents the state for collectOp
 type collectState struct {
 	t    f32.Affine2D
 	area int
@@ -97,92 +134,274 @@ func (q *pointerQueue) save(id int, state collectState) {
 	q.states[id] = state
 }
 
-func (q *pointerQueue) collectHandlers(r *ops.Reader, events *handlerEvents) {
-	state := collectState{
-		area: -1,
-		node: -1,
+// collectOp updates the hit tree and handlers from a pointer related
+// op.
+func (q *pointerQueue) collectOp(encOp ops.EncodedOp, events *handlerEvents) {
+	state := &q.state
+	switch opconst.OpType(encOp.Data[0]) {
+	case opconst.TypeSave:
+		id := ops.DecodeSave(encOp.Data)
+		q.save(id, *state)
+	case opconst.TypeLoad:
+		id, mask := ops.DecodeLoad(encOp.Data)
+		s := q.states[id]
+		if mask&opconst.TransformState != 0 {
+			state.t = s.t
+		}
+		if mask&^opconst.TransformState != 0 {
+			*state = s
+		}
+	case opconst.TypePass:
+		state.pass = encOp.Data[1] != 0
+	case opconst.TypeArea:
+		var op areaOp
+		op.Decode(encOp.Data)
+		bounds := transformBounds(state.t, op.rect)
+		if state.area != -1 {
+			bounds = bounds.Intersect(q.areas[state.area].bounds)
+		}
+		q.areas = append(q.areas, areaNode{
+			invTrans: state.t.Invert(),
+			next:     state.area,
+			area:     op,
+			bounds:   bounds,
+		})
+		state.area = len(q.areas) - 1
+		q.hitTree = append(q.hitTree, hitNode{
+			next: state.node,
+			area: state.area,
+			pass: state.pass,
+		})
+		state.node = len(q.hitTree) - 1
+	case opconst.TypeTransform:
+		dop := ops.DecodeTransform(encOp.Data)
+		state.t = state.t.Mul(dop)
+	case opconst.TypePointerInput:
+		op := pointer.InputOp{
+			Tag:   encOp.Refs[0].(event.Tag),
+			Grab:  encOp.Data[1] != 0,
+			Types: pointer.Type(encOp.Data[2]),
+		}
+		q.hitTree = append(q.hitTree, hitNode{
+			next: state.node,
+			area: state.area,
+			pass: state.pass,
+			tag:  op.Tag,
+		})
+		state.node = len(q.hitTree) - 1
+		h, ok := q.handlers[op.Tag]
+		if !ok {
+			h = new(pointerHandler)
+			q.handlers[op.Tag] = h
+			// Cancel handlers on (each) first appearance, but don't
+			// trigger redraw.
+			events.AddNoRedraw(op.Tag, pointer.Event{Type: pointer.Cancel})
+		}
+		h.active = true
+		h.area = state.area
+		h.wantsGrab = h.wantsGrab || op.Grab
+		h.types = h.types | op.Types
+		bo := binary.LittleEndian.Uint32
+		h.scrollRange = image.Rectangle{
+			Min: image.Point{
+				X: int(int32(bo(encOp.Data[3:]))),
+				Y: int(int32(bo(encOp.Data[7:]))),
+			},
+			Max: image.Point{
+				X: int(int32(bo(encOp.Data[11:]))),
+				Y: int(int32(bo(encOp.Data[15:]))),
+			},
+		}
+	case opconst.TypeCursor:
+		q.cursors = append(q.cursors, cursorNode{
+			name: encOp.Refs[0].(pointer.CursorName),
+			area: len(q.areas) - 1,
+		})
 	}
-	q.save(opconst.InitialStateID, state)
-	for encOp, ok := r.Decode(); ok; encOp, ok = r.Decode() {
-		switch opconst.OpType(encOp.Data[0]) {
-		case opconst.TypeSave:
-			id := ops.DecodeSave(encOp.Data)
-			q.save(id, state)
-		case opconst.TypeLoad:
-			id, mask := ops.DecodeLoad(encOp.Data)
-			s := q.states[id]
-			if mask&opconst.TransformState != 0 {
-				state.t = s.t
-			}
-			if mask&^opconst.TransformState != 0 {
-				state = s
-			}
-		case opconst.TypePass:
-			state.pass = encOp.Data[1] != 0
-		case opconst.TypeArea:
-			var op areaOp
-			op.Decode(encOp.Data)
-			q.areas = append(q.areas, areaNode{trans: state.t, next: state.area, area: op})
-			state.area = len(q.areas) - 1
-			q.hitTree = append(q.hitTree, hitNode{
-				next: state.node,
-				area: state.area,
-				pass: state.pass,
-			})
-			state.node = len(q.hitTree) - 1
-		case opconst.TypeTransform:
-			dop := ops.DecodeTransform(encOp.Data)
-			state.t = state.t.Mul(dop)
-		case opconst.TypePointerInput:
-			op := pointer.InputOp{
-				Tag:   encOp.Refs[0].(event.Tag),
-				Grab:  encOp.Data[1] != 0,
-				Types: pointer.Type(encOp.Data[2]),
-			}
-			q.hitTree = append(q.hitTree, hitNode{
-				next: state.node,
-				area: state.area,
-				pass: state.pass,
-				tag:  op.Tag,
-			})
-			state.node = len(q.hitTree) - 1
-			h, ok := q.handlers[op.Tag]
-			if !ok {
-				h = new(pointerHandler)
-				q.handlers[op.Tag] = h
-				// Cancel handlers on (each) first appearance, but don't
-				// trigger redraw.
-				events.AddNoRedraw(op.Tag, pointer.Event{Type: pointer.Cancel})
-			}
-			h.active = true
-			h.area = state.area
-			h.wantsGrab = h.wantsGrab || op.Grab
-			h.types = h.types | op.Types
-			bo := binary.LittleEndian.Uint32
-			h.scrollRange = image.Rectangle{
-				Min: image.Point{
-					X: int(int32(bo(encOp.Data[3:]))),
-					Y: int(int32(bo(encOp.Data[7:]))),
-				},
-				Max: image.Point{
-					X: int(int32(bo(encOp.Data[11:]))),
-					Y: int(int32(bo(encOp.Data[15:]))),
-				},
+}
+
+// transformBounds returns the bounding box of r transformed by t,
+// padded to cover rounding errors in hit tests.
+func transformBounds(t f32.Affine2D, r f32.Rectangle) f32.Rectangle {
+	const pad = 1
+	corners := [4]f32.Point{
+		t.Transform(r.Min),
+		t.Transform(f32.Pt(r.Max.X, r.Min.Y)),
+		t.Transform(r.Max),
+		t.Transform(f32.Pt(r.Min.X, r.Max.Y)),
+	}
+	b := f32.Rectangle{Min: corners[0], Max: corners[0]}
+	for _, c := range corners[1:] {
+		b.Min.X = min(b.Min.X, c.X)
+		b.Min.Y = min(b.Min.Y, c.Y)
+		b.Max.X = max(b.Max.X, c.X)
+		b.Max.Y = max(b.Max.Y, c.Y)
+	}
+	b.Min = b.Min.Sub(f32.Pt(pad, pad))
+	b.Max = b.Max.Add(f32.Pt(pad, pad))
+	return b
+}
+
+func min(a, b float32) float32 {
+	if a < b {
+		return a
+	}
+	return b
+}
+
+func max(a, b float32) float32 {
+	if a > b {
+		return a
+	}
+	return b
+}
+
+// build indexes the nodes of a hit tree by their area bounds.
+func (g *hitGrid) build(tree []hitNode, areas []areaNode) {
+	g.valid = true
+	g.unbounded = g.unbounded[:0]
+	g.bounds = f32.Rectangle{}
+	n := 0
+	var sizes f32.Point
+	for i, node := range tree {
+		if node.area == -1 {
+			g.unbounded = append(g.unbounded, i)
+			continue
+		}
+		b := areas[node.area].bounds
+		if b.Empty() {
+			continue
+		}
+		if n == 0 {
+			g.bounds = b
+		} else {
+			g.bounds = g.bounds.Union(b)
+		}
+		sizes = sizes.Add(b.Size())
+		n++
+	}
+	// Size the cells like the average node, so a node covers only a
+	// few cells.
+	size := g.bounds.Size()
+	dims := func(total, sum float32) int {
+		if sum <= 0 {
+			return 1
+		}
+		d := int(total * float32(n) / sum)
+		if d < 1 {
+			d = 1
+		}
+		if d > gridMaxDim {
+			d = gridMaxDim
+		}
+		return d
+	}
+	g.cols, g.rows = dims(size.X, sizes.X), dims(size.Y, sizes.Y)
+	g.cellSize = f32.Pt(size.X/float32(g.cols), size.Y/float32(g.rows))
+	ncells := g.cols * g.rows
+	if cap(g.cells) < ncells+1 {
+		g.cells = make([]int, ncells+1)
+	}
+	g.cells = g.cells[:ncells+1]
+	for i := range g.cells {
+		g.cells[i] = 0
+	}
+	// Count the nodes of each cell, then compute the cell offsets
+	// and fill in the nodes.
+	g.forEachCell(tree, areas, func(node, cell int) {
+		g.cells[cell+1]++
+	})
+	for i := 1; i < len(g.cells); i++ {
+		g.cells[i] += g.cells[i-1]
+	}
+	total := g.cells[ncells]
+	if cap(g.nodes) < total {
+		g.nodes = make([]int, total)
+	}
+	g.nodes = g.nodes[:total]
+	g.forEachCell(tree, areas, func(node, cell int) {
+		g.nodes[g.cells[cell]] = node
+		g.cells[cell]++
+	})
+	// Filling in advanced each offset to the start of the next cell.
+	copy(g.cells[1:], g.cells[:ncells])
+	g.cells[0] = 0
+}
+
+// forEachCell calls f for every bounded node and every cell it overlaps.
+func (g *hitGrid) forEachCell(tree []hitNode, areas []areaNode, f func(node, cell int)) {
+	for i, node := range tree {
+		if node.area == -1 {
+			continue
+		}
+		b := areas[node.area].bounds
+		if b.Empty() {
+			continue
+		}
+		x0, y0 := g.cell(b.Min)
+		x1, y1 := g.cell(b.Max)
+		for y := y0; y <= y1; y++ {
+			for x := x0; x <= x1; x++ {
+				f(i, y*g.cols+x)
 			}
-		case opconst.TypeCursor:
-			q.cursors = append(q.cursors, cursorNode{
-				name: encOp.Refs[0].(pointer.CursorName),
-				area: len(q.areas) - 1,
-			})
 		}
 	}
 }
 
+// cell returns the coordinates of the cell containing p, clamped to
+// the grid.
+func (g *hitGrid) cell(p f32.Point) (int, int) {
+	clamp := func(v, size float32, n int) int {
+		if size <= 0 || v < 0 {
+			return 0
+		}
+		c := int(v / size)
+		if c >= n {
+			c = n - 1
+		}
+		return c
+	}
+	p = p.Sub(g.bounds.Min)
+	return clamp(p.X, g.cellSize.X, g.cols), clamp(p.Y, g.cellSize.Y, g.rows)
+}
+
+// candidates returns the bounded nodes that may contain pos.
+func (g *hitGrid) candidates(pos f32.Point) []int {
+	b := g.bounds
+	if !(b.Min.X <= pos.X && pos.X <= b.Max.X && b.Min.Y <= pos.Y && pos.Y <= b.Max.Y) {
+		return nil
+	}
+	x, y := g.cell(pos)
+	c := y*g.cols + x
+	return g.nodes[g.cells[c]:g.cells[c+1]]
+}
+
 func (q *pointerQueue) opHit(handlers *[]event.Tag, pos f32.Point) {
+	if !q.grid.valid {
+		q.grid.build(q.hitTree, q.areas)
+	}
 	// Track whether we're passing through hits.
 	pass := true
+	// Visit only the nodes that may be hit; the others would be
+	// skipped by the hit test below.
+	cands, unbounded := q.grid.candidates(pos), q.grid.unbounded
+	i, j := len(cands)-1, len(unbounded)-1
 	idx := len(q.hitTree) - 1
-	for idx >= 0 {
+	for {
+		for i >= 0 && cands[i] > idx {
+			i--
+		}
+		for j >= 0 && unbounded[j] > idx {
+			j--
+		}
+		switch {
+		case i >= 0 && (j < 0 || cands[i] > unbounded[j]):
+			idx = cands[i]
+		case j >= 0:
+			idx = unbounded[j]
+		default:
+			return
+		}
 		n := &q.hitTree[idx]
 		if !q.hit(n.area, pos) {
 			idx--
@@ -206,13 +425,13 @@ func (q *pointerQueue) invTransform(areaIdx int, p f32.Point) f32.Point {
 	if areaIdx == -1 {
 		return p
 	}
-	return q.areas[areaIdx].trans.Invert().Transform(p)
+	return q.areas[areaIdx].invTrans.Transform(p)
 }
 
 func (q *pointerQueue) hit(areaIdx int, p f32.Point) bool {
 	for areaIdx != -1 {
 		a := &q.areas[areaIdx]
-		p := a.trans.Invert().Transform(p)
+		p := a.invTrans.Transform(p)
 		if !a.area.Hit(p) {
 			return false
 		}
@@ -227,7 +446,8 @@ func (q *pointerQueue) reset() {
 	}
 }
 
-func (q *pointerQueue) Frame(root *op.Ops, events *handlerEvents) {
+// beginFrame prepares the queue for the ops of a new frame.
+func (q *pointerQueue) beginFrame() {
 	q.reset()
 	for _, h := range q.handlers {
 		// Reset handler.
@@ -238,8 +458,17 @@ func (q *pointerQueue) Frame(root *op.Ops, events *handlerEvents) {
 	q.hitTree = q.hitTree[:0]
 	q.areas = q.areas[:0]
 	q.cursors = q.cursors[:0]
-	q.reader.Reset(root)
-	q.collectHandlers(&q.reader, events)
+	q.state = collectState{
+		area: -1,
+		node: -1,
+	}
+	q.save(opconst.InitialStateID, q.state)
+}
+
+// endFrame processes the handlers collected since beginFrame.
+func (q *pointerQueue) endFrame(events *handlerEvents) {
+	// The grid is built by the first hit test.
+	q.grid.valid = false
 	for k, h := range q.handlers {
 		if !h.active {
 			q.dropHandlers(events, k)
@@ -294,8 +523,58 @@ func (q *pointerQueue) dropHandlers(events *handlerEvents, tags ...event.Tag) {
 	}
 }
 
+// Push an event. Consecutive moves of a pointer are coalesced into a
+// single event with the earlier samples in its History, to avoid a hit
+// test and an event per move for high rate input devices. Coalesced
+// moves are delivered by flush.
 func (q *pointerQueue) Push(e pointer.Event, events *handlerEvents) {
 	q.reset()
+	if e.Type == pointer.Move {
+		for i := range q.pointers {
+			p := &q.pointers[i]
+			if p.id != e.PointerID || !p.coalesce {
+				continue
+			}
+			if p.hasPending {
+				p.history = append(p.history, p.pending.History...)
+				p.history = append(p.history, pointer.Sample{Time: p.pending.Time, Position: p.pending.Position})
+			}
+			p.pending, p.hasPending = e, true
+			// Schedule a frame for delivering the event.
+			events.hadEvents = true
+			return
+		}
+	}
+	q.flush(events)
+	q.push(e, events)
+}
+
+// flush delivers the coalesced moves.
+func (q *pointerQueue) flush(events *handlerEvents) {
+	for {
+		pidx := -1
+		for i := range q.pointers {
+			if q.pointers[i].hasPending {
+				pidx = i
+				break
+			}
+		}
+		if pidx == -1 {
+			return
+		}
+		p := &q.pointers[pidx]
+		e := p.pending
+		if len(p.history) > 0 {
+			h := make([]pointer.Sample, 0, len(p.history)+len(e.History))
+			e.History = append(append(h, p.history...), e.History...)
+		}
+		p.pending, p.hasPending = pointer.Event{}, false
+		p.history = p.history[:0]
+		q.push(e, events)
+	}
+}
+
+func (q *pointerQueue) push(e pointer.Event, events *handlerEvents) {
 	if e.Type == pointer.Cancel {
 		q.pointers = q.pointers[:0]
 		for k := range q.handlers {
@@ -334,20 +613,28 @@ func (q *pointerQueue) Push(e pointer.Event, events *handlerEvents) {
 	if e.Type == pointer.Press {
 		p.pressed = true
 	}
+	delivered := false
 	switch e.Type {
 	case pointer.Release:
 	case pointer.Scroll:
 		q.deliverScrollEvent(p, events, e)
 	default:
-		q.deliverEvent(p, events, e)
+		delivered = q.deliverEvent(p, events, e)
 	}
+	// Coalesce moves while they reach a handler. Moves
+	// that don't are not coalesced, to avoid scheduling frames
+	// for them.
+	p.coalesce = delivered && (e.Type == pointer.Move || e.Type == pointer.Drag)
 	if !p.pressed && len(p.entered) == 0 {
 		// No longer need to track pointer.
 		q.pointers = append(q.pointers[:pidx], q.pointers[pidx+1:]...)
 	}
 }
 
-func (q *pointerQueue) deliverEvent(p *pointerInfo, events *handlerEvents, e pointer.Event) {
+// deliverEvent delivers e to the handlers of p and reports whether
+// any handler received it.
+func (q *pointerQueue) deliverEvent(p *pointerInfo, events *handlerEvents, e pointer.Event) bool {
+	delivered := false
 	foremost := true
 	if p.pressed && len(p.handlers) == 1 {
 		e.Priority = pointer.Grabbed
@@ -364,8 +651,17 @@ func (q *pointerQueue) deliverEvent(p *pointerInfo, events *handlerEvents, e poi
 			e.Priority = pointer.Foremost
 		}
 		e.Position = q.invTransform(h.area, e.Position)
+		if len(e.History) > 0 {
+			hist := make([]pointer.Sample, len(e.History))
+			for i, s := range e.History {
+				hist[i] = pointer.Sample{Time: s.Time, Position: q.invTransform(h.area, s.Position)}
+			}
+			e.History = hist
+		}
 		events.Add(k, e)
+		delivered = true
 	}
+	return delivered
 }
 
 func (q *pointerQueue) deliverScrollEvent(p *pointerInfo, events *handlerEvents, e pointer.Event) {
@@ -5,6 +5,7 @@ package router
 import (
 	"fmt"
 	"image"
+	"math/rand"
 	"reflect"
 	"testing"
 
@@ -130,28 +131,74 @@ func TestPointerMove(t *testing.T) {
 
 	var r Router
 	r.Frame(&ops)
-	r.Queue(
+	var events1, events2 []event.Event
+	for _, e := range []pointer.Event{
 		// Hit both handlers.
-		pointer.Event{
+		{
 			Type:     pointer.Move,
 			Position: f32.Pt(50, 50),
 		},
 		// Hit handler 1.
-		pointer.Event{
+		{
 			Type:     pointer.Move,
 			Position: f32.Pt(49, 50),
 		},
 		// Hit no handlers.
-		pointer.Event{
+		{
 			Type:     pointer.Move,
 			Position: f32.Pt(100, 50),
 		},
-		pointer.Event{
+		{
 			Type: pointer.Cancel,
 		},
+	} {
+		r.Queue(e)
+		// Read the events to prevent coalescing of the moves.
+		events1 = append(events1, r.Events(handler1)...)
+		events2 = append(events2, r.Events(handler2)...)
+	}
+	assertEventSequence(t, events1, pointer.Cancel, pointer.Enter, pointer.Move, pointer.Move, pointer.Leave, pointer.Cancel)
+	assertEventSequence(t, events2, pointer.Cancel, pointer.Enter, pointer.Move, pointer.Leave, pointer.Cancel)
+}
+
+func TestPointerCoalesce(t *testing.T) {
+	handler := new(int)
+	var ops op.Ops
+	addPointerHandler(&ops, handler, image.Rect(0, 0, 100, 100))
+
+	var r Router
+	r.Frame(&ops)
+	r.Queue(
+		pointer.Event{Type: pointer.Move, Position: f32.Pt(10, 10), Time: 1},
+		pointer.Event{Type: pointer.Move, Position: f32.Pt(20, 10), Time: 2},
+		pointer.Event{Type: pointer.Move, Position: f32.Pt(30, 10), Time: 3},
+		pointer.Event{Type: pointer.Move, Position: f32.Pt(40, 10), Time: 4},
+		// Press ends the coalesced moves.
+		pointer.Event{Type: pointer.Press, Position: f32.Pt(40, 10), Time: 5},
+		pointer.Event{Type: pointer.Move, Position: f32.Pt(50, 10), Time: 6},
+		pointer.Event{Type: pointer.Move, Position: f32.Pt(60, 10), Time: 7},
+		pointer.Event{Type: pointer.Move, Position: f32.Pt(70, 10), Time: 8},
 	)
-	assertEventSequence(t, r.Events(handler1), pointer.Cancel, pointer.Enter, pointer.Move, pointer.Move, pointer.Leave, pointer.Cancel)
-	assertEventSequence(t, r.Events(handler2), pointer.Cancel, pointer.Enter, pointer.Move, pointer.Leave, pointer.Cancel)
+	events := r.Events(handler)
+	assertEventSequence(t, events, pointer.Cancel, pointer.Enter, pointer.Move, pointer.Move, pointer.Press, pointer.Drag, pointer.Drag)
+	got := events[3].(pointer.Event)
+	if want := f32.Pt(40, 10); got.Position != want {
+		t.Errorf("got position %v, want %v", got.Position, want)
+	}
+	wantHist := []pointer.Sample{
+		{Time: 2, Position: f32.Pt(20, 10)},
+		{Time: 3, Position: f32.Pt(30, 10)},
+	}
+	if !reflect.DeepEqual(got.History, wantHist) {
+		t.Errorf("got history %v, want %v", got.History, wantHist)
+	}
+	drag := events[6].(pointer.Event)
+	if want := f32.Pt(70, 10); drag.Position != want {
+		t.Errorf("got drag position %v, want %v", drag.Position, want)
+	}
+	if want := []pointer.Sample{{Time: 7, Position: f32.Pt(60, 10)}}; !reflect.DeepEqual(drag.History, want) {
+		t.Errorf("got drag history %v, want %v", drag.History, want)
+	}
 }
 
 func TestPointerTypes(t *testing.T) {
@@ -367,21 +414,16 @@ func TestMultipleAreas(t *testing.T) {
 	var r Router
 	r.Frame(&ops)
 	// Hit first area, then second area, then both.
-	r.Queue(
-		pointer.Event{
-			Type:     pointer.Move,
-			Position: f32.Pt(25, 25),
-		},
-		pointer.Event{
-			Type:     pointer.Move,
-			Position: f32.Pt(150, 150),
-		},
-		pointer.Event{
+	var events []event.Event
+	for _, pos := range []f32.Point{f32.Pt(25, 25), f32.Pt(150, 150), f32.Pt(50, 50)} {
+		r.Queue(pointer.Event{
 			Type:     pointer.Move,
-			Position: f32.Pt(50, 50),
-		},
-	)
-	assertEventSequence(t, r.Events(handler), pointer.Cancel, pointer.Enter, pointer.Move, pointer.Move, pointer.Move)
+			Position: pos,
+		})
+		// Read the events to prevent coalescing of the moves.
+		events = append(events, r.Events(handler)...)
+	}
+	assertEventSequence(t, events, pointer.Cancel, pointer.Enter, pointer.Move, pointer.Move, pointer.Move)
 }
 
 func TestPointerEnterLeaveNested(t *testing.T) {
@@ -531,6 +573,73 @@ func TestMultitouch(t *testing.T) {
 	assertEventSequence(t, r.Events(h2), pointer.Cancel, pointer.Enter, pointer.Press, pointer.Release)
 }
 
+func TestPointerHitGrid(t *testing.T) {
+	// Compare hits with a linear walk of the hit tree over a mix of
+	// nested, transformed and pass-through areas.
+	rnd := rand.New(rand.NewSource(42))
+	var ops op.Ops
+	for i := 0; i < 500; i++ {
+		st := op.Save(&ops)
+		if rnd.Intn(4) == 0 {
+			pointer.PassOp{Pass: true}.Add(&ops)
+		}
+		o := f32.Pt(float32(rnd.Intn(400)), float32(rnd.Intn(400)))
+		tr := f32.Affine2D{}.Offset(o)
+		if rnd.Intn(4) == 0 {
+			tr = tr.Rotate(o, rnd.Float32()*3)
+		}
+		op.Affine(tr).Add(&ops)
+		for j := rnd.Intn(3); j >= 0; j-- {
+			r := image.Rect(0, 0, 1+rnd.Intn(100), 1+rnd.Intn(100))
+			if rnd.Intn(2) == 0 {
+				pointer.Ellipse(r).Add(&ops)
+			} else {
+				pointer.Rect(r).Add(&ops)
+			}
+			pointer.InputOp{Tag: new(int), Types: pointer.Move}.Add(&ops)
+		}
+		if rnd.Intn(2) == 0 {
+			st.Load()
+		}
+	}
+	var r Router
+	r.Frame(&ops)
+	q := &r.pqueue
+	for i := 0; i < 2000; i++ {
+		pos := f32.Pt(rnd.Float32()*600-50, rnd.Float32()*600-50)
+		var got, want []event.Tag
+		q.opHit(&got, pos)
+		linearHit(q, &want, pos)
+		if !reflect.DeepEqual(got, want) {
+			t.Fatalf("hits at %v: got %v, want %v", pos, got, want)
+		}
+	}
+}
+
+// linearHit is the reference implementation of pointerQueue.opHit.
+func linearHit(q *pointerQueue, handlers *[]event.Tag, pos f32.Point) {
+	pass := true
+	idx := len(q.hitTree) - 1
+	for idx >= 0 {
+		n := &q.hitTree[idx]
+		if !q.hit(n.area, pos) {
+			idx--
+			continue
+		}
+		pass = pass && n.pass
+		if pass {
+			idx--
+		} else {
+			idx = n.next
+		}
+		if n.tag != nil {
+			if _, exists := q.handlers[n.tag]; exists {
+				*handlers = append(*handlers, n.tag)
+			}
+		}
+	}
+}
+
 func TestCursorNameOp(t *testing.T) {
 	ops := new(op.Ops)
 	var r Router
@@ -751,6 +860,51 @@ func BenchmarkRouterAdd(b *testing.B) {
 	}
 }
 
+func BenchmarkRouterHitGrid(b *testing.B) {
+	// A grid of many small handlers, such as the cells of a canvas.
+	const n = 100
+	var ops op.Ops
+	for y := 0; y < n; y++ {
+		for x := 0; x < n; x++ {
+			st := op.Save(&ops)
+			op.Offset(f32.Pt(float32(x*10), float32(y*10))).Add(&ops)
+			pointer.Rect(image.Rect(0, 0, 10, 10)).Add(&ops)
+			pointer.InputOp{Tag: new(int), Types: pointer.Move}.Add(&ops)
+			st.Load()
+		}
+	}
+	var r Router
+	r.Frame(&ops)
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		r.Queue(
+			pointer.Event{
+				Type:     pointer.Move,
+				Position: f32.Pt(float32(i%(n*10)), 500),
+			},
+		)
+	}
+}
+
+func BenchmarkRouterFrame(b *testing.B) {
+	var ops op.Ops
+	for i := 0; i < 1000; i++ {
+		st := op.Save(&ops)
+		op.Offset(f32.Pt(float32(i), 0)).Add(&ops)
+		pointer.Rect(image.Rect(0, 0, 10, 10)).Add(&ops)
+		pointer.InputOp{Tag: new(int), Types: pointer.Move}.Add(&ops)
+		key.InputOp{Tag: new(int)}.Add(&ops)
+		st.Load()
+	}
+	var r Router
+	b.ReportAllocs()
+	b.ResetTimer()
+	for i := 0; i < b.N; i++ {
+		r.Frame(&ops)
+	}
+}
+
 var benchAreaOp areaOp
 
 func BenchmarkAreaOp_Decode(b *testing.B) {
@@ -51,6 +51,7 @@ type handlerEvents struct {
 
 // Events returns the available events for the handler key.
 func (q *Router) Events(k event.Tag) []event.Event {
+	q.pqueue.flush(&q.handlers)
 	events := q.handlers.Events(k)
 	if _, isprof := q.profHandlers[k]; isprof {
 		delete(q.profHandlers, k)
@@ -63,16 +64,20 @@ func (q *Router) Events(k event.Tag) []event.Event {
 // operation list. The text input state, wakeup time and whether
 // there are active profile handlers is also saved.
 func (q *Router) Frame(ops *op.Ops) {
+	// Update the pointer state from the coalesced events, delivered or
+	// not.
+	q.pqueue.flush(&q.handlers)
 	q.handlers.Clear()
 	q.wakeup = false
 	for k := range q.profHandlers {
 		delete(q.profHandlers, k)
 	}
 	q.reader.Reset(ops)
+	q.pqueue.beginFrame()
+	q.kqueue.beginFrame()
 	q.collect()
-
-	q.pqueue.Frame(ops, &q.handlers)
-	q.kqueue.Frame(ops, &q.handlers)
+	q.pqueue.endFrame(&q.handlers)
+	q.kqueue.endFrame(&q.handlers)
 	if q.handlers.HadEvents() {
 		q.wakeup = true
 		q.wakeupTime = time.Time{}
@@ -124,9 +129,16 @@ func (q *Router) Cursor() pointer.CursorName {
 	return q.pqueue.cursor
 }
 
+// collect decodes the ops of a frame in a single pass, and hands
+// the pointer and key related ops to their queues.
 func (q *Router) collect() {
 	for encOp, ok := q.reader.Decode(); ok; encOp, ok = q.reader.Decode() {
 		switch opconst.OpType(encOp.Data[0]) {
+		case opconst.TypeSave, opconst.TypeLoad, opconst.TypePass, opconst.TypeArea,
+			opconst.TypeTransform, opconst.TypePointerInput, opconst.TypeCursor:
+			q.pqueue.collectOp(encOp, &q.handlers)
+		case opconst.TypeKeyFocus, opconst.TypeKeySoftKeyboard, opconst.TypeKeyInput:
+			q.kqueue.collectOp(encOp)
 		case opconst.TypeInvalidate:
 			op := decodeInvalidateOp(encOp.Data)
 			if !q.wakeup || op.At.Before(q.wakeupTime) {
@@ -6,9 +6,17 @@ package layout
 
 import (
 	"image"
+	"image/color"
 	"testing"
 
+	"gioui.org/f32"
+	"gioui.org/io/key"
+	"gioui.org/io/pointer"
+	"gioui.org/io/router"
 	"gioui.org/op"
+	"gioui.org/op/clip"
+	"gioui.org/op/paint"
+	"gioui.org/unit"
 )
 
 func TestStackAllocs(t *testing.T) {
@@ -46,3 +54,45 @@ func TestFlexAllocs(t *testing.T) {
 		t.Errorf("expected no allocs, got %f", allocs)
 	}
 }
+
+func TestFrameAllocs(t *testing.T) {
+	var (
+		ops  op.Ops
+		r    router.Router
+		list List
+		tags [100]int
+	)
+	button := func(gtx Context, tag *int) Dimensions {
+		defer op.Save(gtx.Ops).Load()
+		sz := image.Pt(50, 20)
+		clip.UniformRRect(f32.Rectangle{Max: FPt(sz)}, 4).Add(gtx.Ops)
+		paint.ColorOp{Color: color.NRGBA{A: 0xff}}.Add(gtx.Ops)
+		paint.PaintOp{}.Add(gtx.Ops)
+		pointer.Rect(image.Rectangle{Max: sz}).Add(gtx.Ops)
+		pointer.InputOp{Tag: tag, Types: pointer.Press}.Add(gtx.Ops)
+		pointer.CursorNameOp{Name: pointer.CursorPointer}.Add(gtx.Ops)
+		key.InputOp{Tag: tag}.Add(gtx.Ops)
+		return Dimensions{Size: sz}
+	}
+	element := func(gtx Context, i int) Dimensions {
+		return Inset{Top: unit.Px(2)}.Layout(gtx, func(gtx Context) Dimensions {
+			return button(gtx, &tags[i])
+		})
+	}
+	frame := func() {
+		ops.Reset()
+		gtx := Context{
+			Ops:         &ops,
+			Constraints: Exact(image.Pt(100, 1000)),
+			Queue:       &r,
+		}
+		list.Layout(gtx, len(tags), element)
+		r.Frame(&ops)
+	}
+	// Warm up the buffers.
+	frame()
+	allocs := testing.AllocsPerRun(1, frame)
+	if allocs != 0 {
+		t.Errorf("expected no allocs, got %f", allocs)
+	}
+}
@@ -28,6 +28,8 @@ type List struct {
 	ScrollToEnd bool
 	// Alignment is the cross axis alignment of list elements.
 	Alignment Alignment
+	// Cache, if set, caches the layout of list elements. See ListCache.
+	Cache *ListCache
 
 	cs          Constraints
 	scroll      gesture.Scroll
@@ -51,6 +53,38 @@ type List struct {
 // a list element.
 type ListElement func(gtx Context, index int) Dimensions
 
+// ListCache caches the layout of List elements between frames. A cached
+// element is not laid out again, but its operations and dimensions from
+// the previous frame are replayed. Use Invalidate to mark elements whose
+// content has changed, and Reset when elements are added, removed or
+// reordered.
+//
+// A cached element is not called, and must not rely on being called for
+// processing its events.
+//
+// The cache also remembers the size of every element laid out with it, to
+// scroll past elements without laying them out and to estimate the
+// list length.
+type ListCache struct {
+	cs      Constraints
+	frame   int
+	entries map[int]*listCacheEntry
+	free    []*listCacheEntry
+	// sizes are the known main axis sizes of elements.
+	sizes map[int]int
+	// total is the sum of the n sizes.
+	total, n int
+}
+
+type listCacheEntry struct {
+	ops   op.Ops
+	dims  Dimensions
+	call  op.CallOp
+	valid bool
+	// frame is the last frame the entry was used.
+	frame int
+}
+
 type iterationDir uint8
 
 // Position is a List scroll offset represented as an offset from the top edge
@@ -102,23 +136,58 @@ func (l *List) init(gtx Context, len int) {
 	}
 }
 
+// skip scrolls past the invisible elements of known size.
+func (l *List) skip() {
+	for l.Position.First < l.len {
+		sz, ok := l.Cache.sizes[l.Position.First]
+		if !ok || l.Position.Offset < sz {
+			break
+		}
+		l.Position.First++
+		l.Position.Offset -= sz
+	}
+	for l.Position.Offset < 0 && l.Position.First > 0 {
+		sz, ok := l.Cache.sizes[l.Position.First-1]
+		if !ok {
+			break
+		}
+		l.Position.First--
+		l.Position.Offset += sz
+	}
+}
+
 // Layout the List.
 func (l *List) Layout(gtx Context, len int, w ListElement) Dimensions {
 	l.init(gtx, len)
 	crossMin, crossMax := l.Axis.crossConstraint(gtx.Constraints)
 	gtx.Constraints = l.Axis.constraints(0, inf, crossMin, crossMax)
+	if c := l.Cache; c != nil {
+		c.begin(gtx.Constraints)
+		l.skip()
+	}
 	macro := op.Record(gtx.Ops)
 	laidOutTotalLength := 0
 	numLaidOut := 0
 
 	for l.next(); l.more(); l.next() {
-		child := op.Record(gtx.Ops)
-		dims := w(gtx, l.index())
-		call := child.Stop()
+		var dims Dimensions
+		var call op.CallOp
+		if c := l.Cache; c != nil {
+			dims, call = c.layout(gtx, l.Axis, l.index(), w)
+		} else {
+			child := op.Record(gtx.Ops)
+			dims = w(gtx, l.index())
+			call = child.Stop()
+		}
 		l.end(dims, call)
 		laidOutTotalLength += l.Axis.Convert(dims.Size).X
 		numLaidOut++
 	}
+	if c := l.Cache; c != nil {
+		c.end()
+		// Estimate from every element measured so far.
+		laidOutTotalLength, numLaidOut = c.total, c.n
+	}
 
 	if numLaidOut > 0 {
 		l.Position.Length = laidOutTotalLength * len / numLaidOut
@@ -128,6 +197,85 @@ func (l *List) Layout(gtx Context, len int, w ListElement) Dimensions {
 	return l.layout(gtx.Ops, macro)
 }
 
+// Invalidate marks the element at index changed, forcing it to be laid
+// out again.
+func (c *ListCache) Invalidate(index int) {
+	if e, ok := c.entries[index]; ok {
+		e.valid = false
+	}
+}
+
+// Reset clears the cache.
+func (c *ListCache) Reset() {
+	for i, e := range c.entries {
+		delete(c.entries, i)
+		c.free = append(c.free, e)
+	}
+	for i := range c.sizes {
+		delete(c.sizes, i)
+	}
+	c.total, c.n = 0, 0
+}
+
+// begin starts a frame where elements are laid out with constraints cs.
+func (c *ListCache) begin(cs Constraints) {
+	if c.entries == nil {
+		c.entries = make(map[int]*listCacheEntry)
+		c.sizes = make(map[int]int)
+	}
+	if cs != c.cs {
+		c.cs = cs
+		c.Reset()
+	}
+	c.frame++
+}
+
+// end recycles the entries not used in the frame.
+func (c *ListCache) end() {
+	for i, e := range c.entries {
+		if e.frame != c.frame {
+			delete(c.entries, i)
+			c.free = append(c.free, e)
+		}
+	}
+}
+
+// layout the element at index, or replay its previous layout if it is
+// unchanged.
+func (c *ListCache) layout(gtx Context, axis Axis, index int, w ListElement) (Dimensions, op.CallOp) {
+	e, ok := c.entries[index]
+	if !ok {
+		if n := len(c.free); n > 0 {
+			e = c.free[n-1]
+			c.free = c.free[:n-1]
+			e.valid = false
+		} else {
+			e = new(listCacheEntry)
+		}
+		c.entries[index] = e
+	}
+	e.frame = c.frame
+	if e.valid {
+		return e.dims, e.call
+	}
+	e.ops.Reset()
+	gtx.Ops = &e.ops
+	macro := op.Record(gtx.Ops)
+	e.dims = w(gtx, index)
+	e.call = macro.Stop()
+	e.valid = true
+	sz := axis.Convert(e.dims.Size).X
+	old, ok := c.sizes[index]
+	if ok {
+		c.total -= old
+	} else {
+		c.n++
+	}
+	c.sizes[index] = sz
+	c.total += sz
+	return e.dims, e.call
+}
+
 func (l *List) scrollToEnd() bool {
 	return l.ScrollToEnd && !l.Position.BeforeEnd
 }
@@ -138,7 +286,13 @@ func (l *List) Dragging() bool {
 }
 
 func (l *List) update(gtx Context) {
-	d := l.scroll.Scroll(gtx.Metric, gtx, gtx.Now, gesture.Axis(l.Axis))
+	// Use the Queue directly, because converting gtx to an event.Queue
+	// allocates.
+	q := gtx.Queue
+	if q == nil {
+		q = gtx
+	}
+	d := l.scroll.Scroll(gtx.Metric, q, gtx.Now, gesture.Axis(l.Axis))
 	l.scrollDelta = d
 	l.Position.Offset += d
 }
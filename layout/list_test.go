@@ -128,3 +128,107 @@ func TestListPosition(t *testing.T) {
 		})
 	}
 }
+
+func TestListCache(t *testing.T) {
+	gtx := Context{
+		Ops: new(op.Ops),
+		Constraints: Constraints{
+			Max: image.Pt(20, 10),
+		},
+		Queue: new(router.Router),
+	}
+	var laidOut []int
+	el := func(gtx Context, idx int) Dimensions {
+		laidOut = append(laidOut, idx)
+		return Dimensions{Size: image.Pt(10, 10)}
+	}
+	list := List{Cache: new(ListCache)}
+	layout := func() []int {
+		laidOut = laidOut[:0]
+		gtx.Ops.Reset()
+		list.Layout(gtx, 200, el)
+		return laidOut
+	}
+	if got := layout(); len(got) != 2 {
+		t.Errorf("laid out %v, want 2 elements", got)
+	}
+	if got := layout(); len(got) != 0 {
+		t.Errorf("laid out cached elements %v", got)
+	}
+	list.Cache.Invalidate(1)
+	if got := layout(); len(got) != 1 || got[0] != 1 {
+		t.Errorf("laid out %v, want [1]", got)
+	}
+	// Measure every element.
+	for i := 0; i < 200; i += 2 {
+		list.Position.First = i
+		layout()
+	}
+	if got, want := list.Position.Length, 2000; got != want {
+		t.Errorf("got length %d, want %d", got, want)
+	}
+	// Jump without laying out the skipped elements.
+	list.Position.First = 0
+	list.Position.Offset = 1000
+	for _, idx := range layout() {
+		if idx != 100 && idx != 101 {
+			t.Errorf("laid out invisible element %d", idx)
+		}
+	}
+	if got, want := list.Position.First, 100; got != want {
+		t.Errorf("got first %d, want %d", got, want)
+	}
+}
+
+func TestListCacheSave(t *testing.T) {
+	r := new(router.Router)
+	gtx := Context{
+		Ops: new(op.Ops),
+		Constraints: Constraints{
+			Max: image.Pt(30, 10),
+		},
+		Queue: r,
+	}
+	var tags [3]int
+	// Elements that save and restore the state, recorded into the cache
+	// entries.
+	el := func(gtx Context, idx int) Dimensions {
+		defer op.Save(gtx.Ops).Load()
+		defer op.Save(gtx.Ops).Load()
+		pointer.Rect(image.Rect(0, 0, 10, 10)).Add(gtx.Ops)
+		pointer.InputOp{Tag: &tags[idx], Types: pointer.Press}.Add(gtx.Ops)
+		return Dimensions{Size: image.Pt(10, 10)}
+	}
+	list := List{Cache: new(ListCache)}
+	for frame := 0; frame < 2; frame++ {
+		gtx.Ops.Reset()
+		list.Layout(gtx, len(tags), el)
+		r.Frame(gtx.Ops)
+		for i := range tags {
+			r.Queue(
+				pointer.Event{
+					Source:   pointer.Mouse,
+					Buttons:  pointer.ButtonPrimary,
+					Type:     pointer.Press,
+					Position: f32.Pt(float32(i*10+5), 5),
+				},
+				pointer.Event{
+					Source:   pointer.Mouse,
+					Type:     pointer.Release,
+					Position: f32.Pt(float32(i*10+5), 5),
+				},
+			)
+		}
+		for i := range tags {
+			presses := 0
+			for _, e := range r.Events(&tags[i]) {
+				if e, ok := e.(pointer.Event); ok && e.Type == pointer.Press {
+					presses++
+				}
+			}
+			if presses != 1 {
+				t.Errorf("frame %d: element %d got %d presses, want 1", frame, i, presses)
+			}
+		}
+	}
+}
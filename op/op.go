@@ -238,6 +238,11 @@ func (o *Ops) Version() int {
 	return o.version
 }
 
+// StateIDs is for internal use only.
+func (o *Ops) StateIDs() int {
+	return o.nextStateID
+}
+
 // Write is for internal use only.
 func (o *Ops) Write(n int) []byte {
 	o.data = append(o.data, make([]byte, n)...)
@@ -29,6 +29,34 @@ type ImageOp struct {
 	handle interface{}
 }
 
+// MutableImage is an RGBA image whose contents may change between
+// frames. Unlike images passed to NewImageOp, a MutableImage keeps its
+// GPU texture, and only the regions marked with Invalidate are
+// uploaded again.
+type MutableImage struct {
+	src   *image.RGBA
+	state *mutableState
+}
+
+// mutableState is the handle of a MutableImage. It records the regions
+// changed by recent versions of the image, so that every renderer can
+// bring its copy up to date regardless of the frames it missed.
+type mutableState struct {
+	bounds image.Rectangle
+	// version is the current version of the image.
+	version int
+	// observed is set when a renderer has seen version. Later changes
+	// start a new version.
+	observed bool
+	// changes are the regions changed by the most recent versions,
+	// indexed by version modulo mutableHistory.
+	changes [mutableHistory]image.Rectangle
+}
+
+// mutableHistory is the number of versions whose changes are recorded.
+// Renderers further behind update the whole image.
+const mutableHistory = 16
+
 // ColorOp sets the brush to a constant color.
 type ColorOp struct {
 	Color color.NRGBA
@@ -85,6 +113,68 @@ func NewImageOp(src image.Image) ImageOp {
 	}
 }
 
+// NewMutableImage creates a MutableImage of the given size.
+func NewMutableImage(size image.Point) *MutableImage {
+	src := image.NewRGBA(image.Rectangle{Max: size})
+	return &MutableImage{
+		src:   src,
+		state: &mutableState{bounds: src.Bounds()},
+	}
+}
+
+// RGBA returns the backing image. See gioui.org/io/system.FrameEvent for
+// a description of when the image is safe to modify.
+func (m *MutableImage) RGBA() *image.RGBA {
+	return m.src
+}
+
+// Invalidate marks the region r of the image as changed. The change is
+// displayed by the next frame that draws the image, regardless of the
+// ImageOps it uses. Like modifications to the image, Invalidate must
+// follow the rules described for gioui.org/io/system.FrameEvent.
+func (m *MutableImage) Invalidate(r image.Rectangle) {
+	r = r.Intersect(m.src.Bounds())
+	if r.Empty() {
+		return
+	}
+	s := m.state
+	if s.observed {
+		s.version++
+		s.observed = false
+		s.changes[s.version%mutableHistory] = image.Rectangle{}
+	}
+	c := &s.changes[s.version%mutableHistory]
+	*c = c.Union(r)
+}
+
+// Op returns an ImageOp for the image.
+func (m *MutableImage) Op() ImageOp {
+	return ImageOp{
+		src:    m.src,
+		handle: m.state,
+	}
+}
+
+// Version returns the current version of the image. Renderers call it
+// when they copy the image, and pass it to Changes later.
+func (s *mutableState) Version() int {
+	s.observed = true
+	return s.version
+}
+
+// Changes returns the region of the image changed after version since.
+func (s *mutableState) Changes(since int) image.Rectangle {
+	n := s.version - since
+	if n > mutableHistory {
+		return s.bounds
+	}
+	var r image.Rectangle
+	for v := since + 1; v <= s.version; v++ {
+		r = r.Union(s.changes[v%mutableHistory])
+	}
+	return r
+}
+
 func (i ImageOp) Size() image.Point {
 	if i.src == nil {
 		return image.Point{}
@@ -3,52 +3,88 @@
 package text
 
 import (
+	"unsafe"
+
 	"golang.org/x/image/math/fixed"
 
+	"gioui.org/internal/ops"
 	"gioui.org/op"
 )
 
 type layoutCache struct {
 	m          map[layoutKey]*layoutElem
 	head, tail *layoutElem
+	// budget is the maximum estimated size in bytes of the
+	// cached layouts.
+	budget int
+	stats  LRUStats
 }
 
 type pathCache struct {
 	m          map[pathKey]*path
 	head, tail *path
+	// budget is the maximum estimated size in bytes of the
+	// cached paths.
+	budget int
+	stats  LRUStats
+
+	// scratch space for measuring paths.
+	ops    op.Ops
+	reader ops.Reader
 }
 
 type layoutElem struct {
 	next, prev *layoutElem
 	key        layoutKey
 	layout     []Line
+	size       int
 }
 
 type path struct {
 	next, prev *path
 	key        pathKey
 	val        op.CallOp
+	size       int
 }
 
 type layoutKey struct {
+	face     *faceCache
 	ppem     fixed.Int26_6
 	maxWidth int
 	str      string
 }
 
 type pathKey struct {
+	face *faceCache
 	ppem fixed.Int26_6
 	str  string
 }
 
-const maxSize = 1000
+// LRUStats describes the use of a cache.
+type LRUStats struct {
+	// Hits and Misses count the lookups of the cache.
+	Hits, Misses int
+	// Evictions counts the entries evicted to stay within the
+	// budget of the cache.
+	Evictions int
+	// Entries is the number of cached entries.
+	Entries int
+	// Size is the estimated size in bytes of the cached entries.
+	Size int
+}
+
+// entryOverhead is the estimated size of a cache entry, excluding
+// its key string and value.
+const entryOverhead = 128
 
 func (l *layoutCache) Get(k layoutKey) ([]Line, bool) {
 	if lt, ok := l.m[k]; ok {
+		l.stats.Hits++
 		l.remove(lt)
 		l.insert(lt)
 		return lt.layout, true
 	}
+	l.stats.Misses++
 	return nil, false
 }
 
@@ -60,13 +96,20 @@ func (l *layoutCache) Put(k layoutKey, lt []Line) {
 		l.head.prev = l.tail
 		l.tail.next = l.head
 	}
-	val := &layoutElem{key: k, layout: lt}
+	val := &layoutElem{key: k, layout: lt, size: layoutSize(k, lt)}
 	l.m[k] = val
 	l.insert(val)
-	if len(l.m) > maxSize {
+	l.stats.Entries++
+	l.stats.Size += val.size
+	// Evict the oldest layouts, but keep the newest even if it exceeds
+	// the budget on its own.
+	for l.stats.Size > l.budget && l.tail.next != val {
 		oldest := l.tail.next
 		l.remove(oldest)
 		delete(l.m, oldest.key)
+		l.stats.Entries--
+		l.stats.Size -= oldest.size
+		l.stats.Evictions++
 	}
 }
 
@@ -82,12 +125,23 @@ func (l *layoutCache) insert(lt *layoutElem) {
 	lt.next.prev = lt
 }
 
+// layoutSize estimates the memory used by a cached layout.
+func layoutSize(k layoutKey, lt []Line) int {
+	n := entryOverhead + len(k.str)
+	for _, l := range lt {
+		n += int(unsafe.Sizeof(l)) + len(l.Layout.Text) + len(l.Layout.Advances)*int(unsafe.Sizeof(fixed.Int26_6(0)))
+	}
+	return n
+}
+
 func (c *pathCache) Get(k pathKey) (op.CallOp, bool) {
 	if v, ok := c.m[k]; ok {
+		c.stats.Hits++
 		c.remove(v)
 		c.insert(v)
 		return v.val, true
 	}
+	c.stats.Misses++
 	return op.CallOp{}, false
 }
 
@@ -99,14 +153,34 @@ func (c *pathCache) Put(k pathKey, v op.CallOp) {
 		c.head.prev = c.tail
 		c.tail.next = c.head
 	}
-	val := &path{key: k, val: v}
+	val := &path{key: k, val: v, size: entryOverhead + len(k.str) + c.opsSize(v)}
 	c.m[k] = val
 	c.insert(val)
-	if len(c.m) > maxSize {
+	c.stats.Entries++
+	c.stats.Size += val.size
+	// Evict the oldest paths, but keep the newest even if it exceeds
+	// the budget on its own.
+	for c.stats.Size > c.budget && c.tail.next != val {
 		oldest := c.tail.next
 		c.remove(oldest)
 		delete(c.m, oldest.key)
+		c.stats.Entries--
+		c.stats.Size -= oldest.size
+		c.stats.Evictions++
+	}
+}
+
+// opsSize estimates the memory used by the operations recorded
+// in v.
+func (c *pathCache) opsSize(v op.CallOp) int {
+	c.ops.Reset()
+	v.Add(&c.ops)
+	c.reader.Reset(&c.ops)
+	n := 0
+	for encOp, ok := c.reader.Decode(); ok; encOp, ok = c.reader.Decode() {
+		n += len(encOp.Data) + len(encOp.Refs)*int(unsafe.Sizeof(interface{}(nil)))
 	}
+	return n
 }
 
 func (c *pathCache) remove(v *path) {
@@ -3,47 +3,69 @@
 package text
 
 import (
-	"strconv"
+	"fmt"
 	"testing"
 
 	"gioui.org/op"
 )
 
+// lruEntries is the number of test entries that fit the test
+// budgets.
+const lruEntries = 1000
+
 func TestLayoutLRU(t *testing.T) {
 	c := new(layoutCache)
+	key := func(i int) layoutKey {
+		return layoutKey{str: fmt.Sprintf("%06d", i)}
+	}
+	c.budget = lruEntries * layoutSize(key(0), nil)
 	put := func(i int) {
-		c.Put(layoutKey{str: strconv.Itoa(i)}, nil)
+		c.Put(key(i), nil)
 	}
 	get := func(i int) bool {
-		_, ok := c.Get(layoutKey{str: strconv.Itoa(i)})
+		_, ok := c.Get(key(i))
 		return ok
 	}
-	testLRU(t, put, get)
+	testLRU(t, put, get, func() LRUStats { return c.stats })
 }
 
 func TestPathLRU(t *testing.T) {
 	c := new(pathCache)
+	key := func(i int) pathKey {
+		return pathKey{str: fmt.Sprintf("%06d", i)}
+	}
+	c.budget = lruEntries * (entryOverhead + len(key(0).str))
 	put := func(i int) {
-		c.Put(pathKey{str: strconv.Itoa(i)}, op.CallOp{})
+		c.Put(key(i), op.CallOp{})
 	}
 	get := func(i int) bool {
-		_, ok := c.Get(pathKey{str: strconv.Itoa(i)})
+		_, ok := c.Get(key(i))
 		return ok
 	}
-	testLRU(t, put, get)
+	testLRU(t, put, get, func() LRUStats { return c.stats })
 }
 
-func testLRU(t *testing.T, put func(i int), get func(i int) bool) {
-	for i := 0; i < maxSize; i++ {
+func TestPathSize(t *testing.T) {
+	c := new(pathCache)
+	ops := new(op.Ops)
+	m := op.Record(ops)
+	op.InvalidateOp{}.Add(ops)
+	if got := c.opsSize(m.Stop()); got == 0 {
+		t.Errorf("recorded operations have zero size")
+	}
+}
+
+func testLRU(t *testing.T, put func(i int), get func(i int) bool, stats func() LRUStats) {
+	for i := 0; i < lruEntries; i++ {
 		put(i)
 	}
-	for i := 0; i < maxSize; i++ {
+	for i := 0; i < lruEntries; i++ {
 		if !get(i) {
 			t.Fatalf("key %d was evicted", i)
 		}
 	}
-	put(maxSize)
-	for i := 1; i < maxSize+1; i++ {
+	put(lruEntries)
+	for i := 1; i < lruEntries+1; i++ {
 		if !get(i) {
 			t.Fatalf("key %d was evicted", i)
 		}
@@ -51,4 +73,15 @@ func testLRU(t *testing.T, put func(i int), get func(i int) bool) {
 	if i := 0; get(i) {
 		t.Fatalf("key %d was not evicted", i)
 	}
+	want := LRUStats{
+		Hits:      2 * lruEntries,
+		Misses:    1,
+		Evictions: 1,
+		Entries:   lruEntries,
+	}
+	got := stats()
+	got.Size = 0
+	if got != want {
+		t.Errorf("got stats %+v, want %+v", got, want)
+	}
 }
@@ -34,18 +34,38 @@ type FontFace struct {
 // first registered face.
 //
 // The LayoutString and ShapeString results are cached and re-used if
-// possible.
+// possible, within the limits of a CacheBudget.
 type Cache struct {
-	def   Typeface
-	faces map[Font]*faceCache
+	def         Typeface
+	faces       map[Font]*faceCache
+	layoutCache layoutCache
+	pathCache   pathCache
+}
+
+// CacheBudget limits the estimated memory used by a Cache.
+type CacheBudget struct {
+	// Layout is the budget in bytes of the cached layouts.
+	Layout int
+	// Path is the budget in bytes of the cached shapes.
+	Path int
+}
+
+// CacheStats describes the use of a Cache.
+type CacheStats struct {
+	Layout LRUStats
+	Path   LRUStats
 }
 
 type faceCache struct {
-	face        Face
-	layoutCache layoutCache
-	pathCache   pathCache
+	face Face
 }
 
+// Default budgets of a Cache.
+const (
+	defaultLayoutBudget = 1 << 20
+	defaultPathBudget   = 4 << 20
+)
+
 func (c *Cache) lookup(font Font) *faceCache {
 	f := c.faceForStyle(font)
 	if f == nil {
@@ -76,10 +96,26 @@ func (c *Cache) faceForStyle(font Font) *faceCache {
 	return tf
 }
 
+// NewCache is like NewCacheBudget with a default budget.
 func NewCache(collection []FontFace) *Cache {
+	return NewCacheBudget(collection, CacheBudget{})
+}
+
+// NewCacheBudget returns a Cache for a collection of faces. The oldest
+// layouts and shapes are evicted when the cache exceeds its budget. A
+// zero budget field selects its default.
+func NewCacheBudget(collection []FontFace, budget CacheBudget) *Cache {
+	if budget.Layout == 0 {
+		budget.Layout = defaultLayoutBudget
+	}
+	if budget.Path == 0 {
+		budget.Path = defaultPathBudget
+	}
 	c := &Cache{
 		faces: make(map[Font]*faceCache),
 	}
+	c.layoutCache.budget = budget.Layout
+	c.pathCache.budget = budget.Path
 	for i, ff := range collection {
 		if i == 0 {
 			c.def = ff.Font.Typeface
@@ -89,6 +125,14 @@ func NewCache(collection []FontFace) *Cache {
 	return c
 }
 
+// Stats returns the statistics of the layout and shape caches.
+func (s *Cache) Stats() CacheStats {
+	return CacheStats{
+		Layout: s.layoutCache.stats,
+		Path:   s.pathCache.stats,
+	}
+}
+
 // Layout implements the Shaper interface.
 func (s *Cache) Layout(font Font, size fixed.Int26_6, maxWidth int, txt io.Reader) ([]Line, error) {
 	cache := s.lookup(font)
@@ -98,45 +142,47 @@ func (s *Cache) Layout(font Font, size fixed.Int26_6, maxWidth int, txt io.Reade
 // LayoutString is a caching implementation of the Shaper interface.
 func (s *Cache) LayoutString(font Font, size fixed.Int26_6, maxWidth int, str string) []Line {
 	cache := s.lookup(font)
-	return cache.layout(size, maxWidth, str)
+	return s.layout(cache, size, maxWidth, str)
 }
 
 // Shape is a caching implementation of the Shaper interface. Shape assumes that the layout
 // argument is unchanged from a call to Layout or LayoutString.
 func (s *Cache) Shape(font Font, size fixed.Int26_6, layout Layout) op.CallOp {
 	cache := s.lookup(font)
-	return cache.shape(size, layout)
+	return s.shape(cache, size, layout)
 }
 
-func (f *faceCache) layout(ppem fixed.Int26_6, maxWidth int, str string) []Line {
+func (s *Cache) layout(f *faceCache, ppem fixed.Int26_6, maxWidth int, str string) []Line {
 	if f == nil {
 		return nil
 	}
 	lk := layoutKey{
+		face:     f,
 		ppem:     ppem,
 		maxWidth: maxWidth,
 		str:      str,
 	}
-	if l, ok := f.layoutCache.Get(lk); ok {
+	if l, ok := s.layoutCache.Get(lk); ok {
 		return l
 	}
 	l, _ := f.face.Layout(ppem, maxWidth, strings.NewReader(str))
-	f.layoutCache.Put(lk, l)
+	s.layoutCache.Put(lk, l)
 	return l
 }
 
-func (f *faceCache) shape(ppem fixed.Int26_6, layout Layout) op.CallOp {
+func (s *Cache) shape(f *faceCache, ppem fixed.Int26_6, layout Layout) op.CallOp {
 	if f == nil {
 		return op.CallOp{}
 	}
 	pk := pathKey{
+		face: f,
 		ppem: ppem,
 		str:  layout.Text,
 	}
-	if clip, ok := f.pathCache.Get(pk); ok {
+	if clip, ok := s.pathCache.Get(pk); ok {
 		return clip
 	}
 	clip := f.face.Shape(ppem, layout)
-	f.pathCache.Put(pk, clip)
+	s.pathCache.Put(pk, clip)
 	return clip
 }
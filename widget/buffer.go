@@ -20,6 +20,20 @@ type editBuffer struct {
 	// changed tracks whether the buffer content
 	// has changed since the last call to Changed.
 	changed bool
+
+	// dirty tracks the text changed since the last call to
+	// takeDirty.
+	dirty dirtyRange
+}
+
+// dirtyRange is a range of changed text.
+type dirtyRange struct {
+	valid bool
+	// start and end are the byte offsets of the changed text.
+	start, end int
+	// delta is the change in text length. The unchanged text after
+	// end started at end-delta before the changes.
+	delta int
 }
 
 const minSpace = 5
@@ -32,6 +46,7 @@ func (e *editBuffer) Changed() bool {
 
 func (e *editBuffer) deleteRunes(caret, runes int) int {
 	e.moveGap(caret, 0)
+	start, end := e.gapstart, e.gapend
 	for ; runes < 0 && e.gapstart > 0; runes++ {
 		_, s := utf8.DecodeLastRune(e.text[:e.gapstart])
 		e.gapstart -= s
@@ -43,6 +58,9 @@ func (e *editBuffer) deleteRunes(caret, runes int) int {
 		e.gapend += s
 		e.changed = e.changed || s > 0
 	}
+	if n := start - e.gapstart + e.gapend - end; n > 0 {
+		e.markDirty(e.gapstart, n, 0)
+	}
 	return caret
 }
 
@@ -81,6 +99,49 @@ func (e *editBuffer) moveGap(caret, space int) {
 	}
 }
 
+// markDirty records that n bytes at offset pos replaced old bytes.
+func (e *editBuffer) markDirty(pos, old, n int) {
+	d := e.dirty
+	end := pos + n
+	if d.valid {
+		// Merge with the previous range, moved to the new offsets.
+		dend := d.end
+		switch {
+		case dend >= pos+old:
+			dend += n - old
+		case dend > pos:
+			dend = end
+		}
+		if d.start < pos {
+			pos = d.start
+		}
+		if dend > end {
+			end = dend
+		}
+	}
+	e.dirty = dirtyRange{valid: true, start: pos, end: end, delta: d.delta + n - old}
+}
+
+// takeDirty returns and clears the range of text changed since the
+// last call.
+func (e *editBuffer) takeDirty() dirtyRange {
+	d := e.dirty
+	e.dirty = dirtyRange{}
+	return d
+}
+
+// appendText appends the text between the start and end offsets
+// to b.
+func (e *editBuffer) appendText(b []byte, start, end int) []byte {
+	if start < e.gapstart {
+		b = append(b, e.text[start:min(end, e.gapstart)]...)
+	}
+	if end > e.gapstart {
+		b = append(b, e.text[max(start, e.gapstart)+e.gapLen():end+e.gapLen()]...)
+	}
+	return b
+}
+
 func (e *editBuffer) len() int {
 	return len(e.text) - e.gapLen()
 }
@@ -165,6 +226,9 @@ func (e *editBuffer) prepend(caret int, s string) {
 	copy(e.text[caret:], s)
 	e.gapstart += len(s)
 	e.changed = e.changed || len(s) > 0
+	if len(s) > 0 {
+		e.markDirty(caret, 0, len(s))
+	}
 }
 
 func (e *editBuffer) runeBefore(idx int) (rune, int) {
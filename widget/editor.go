@@ -65,6 +65,22 @@ type Editor struct {
 	dims         layout.Dimensions
 	requestFocus bool
 
+	// lineLens holds the text length in bytes of each line. lineStarts
+	// and baselines hold the text offset and baseline of each line.
+	lineLens   []int
+	lineStarts []int
+	baselines  []int
+	// paras holds the paragraphs of the text, laid out with the
+	// parameters in parasKey.
+	paras    []paragraph
+	parasKey paragraphKey
+	// Scratch space for layoutText.
+	paraText   []byte
+	paraReader bytes.Reader
+	newParas   []paragraph
+	newLines   []text.Line
+	newLens    []int
+
 	caret struct {
 		on     bool
 		scroll bool
@@ -117,6 +133,24 @@ type combinedPos struct {
 	xoff fixed.Int26_6
 }
 
+// paragraph is a run of text terminated by a hard newline, or the
+// text after the last newline.
+type paragraph struct {
+	// len is the length in bytes of the text, including the newline.
+	len int
+	// lines is the number of lines in the paragraph layout.
+	lines int
+}
+
+// paragraphKey holds the parameters of a paragraph layout.
+type paragraphKey struct {
+	shaper   text.Shaper
+	font     text.Font
+	textSize fixed.Int26_6
+	maxWidth int
+	mask     rune
+}
+
 type selectionAction int
 
 const (
@@ -525,6 +559,12 @@ func (e *Editor) layout(gtx layout.Context) layout.Dimensions {
 		Width:     e.viewSize.X,
 		Offset:    off,
 	}
+	// Skip the lines above the visible area.
+	if first := e.firstVisibleLine(clip.Min.Y - off.Y); first > 0 {
+		it.pos.Y = first
+		it.y = fixed.I(e.baselines[first-1])
+		it.prevDesc = e.lines[first-1].Descent
+	}
 	e.shapes = e.shapes[:0]
 	for {
 		layout, off, selected, yOffs, size, ok := it.Next()
@@ -579,6 +619,18 @@ func (e *Editor) layout(gtx layout.Context) layout.Dimensions {
 	return layout.Dimensions{Size: e.viewSize, Baseline: e.dims.Baseline}
 }
 
+// firstVisibleLine returns the index of a line at or before the first
+// line visible below y.
+func (e *Editor) firstVisibleLine(y int) int {
+	i := sort.Search(len(e.baselines), func(i int) bool {
+		return e.baselines[i] >= y
+	})
+	// The line above may extend below its baseline into view. Keep
+	// another line as margin for glyphs extending beyond their line.
+	const margin = 2
+	return max(i-margin, 0)
+}
+
 // PaintSelection paints the contrasting background for selected text.
 func (e *Editor) PaintSelection(gtx layout.Context) {
 	cl := textPadding(e.lines)
@@ -663,6 +715,8 @@ func (e *Editor) Text() string {
 // SetText replaces the contents of the editor, clearing any selection first.
 func (e *Editor) SetText(s string) {
 	e.rr = editBuffer{}
+	// Lay out the new text from scratch.
+	e.paras = e.paras[:0]
 	e.caret.start = combinedPos{}
 	e.caret.end = combinedPos{}
 	e.prepend(s)
@@ -707,37 +761,51 @@ func (e *Editor) scrollAbs(x, y int) {
 }
 
 func (e *Editor) moveCoord(pos image.Point) {
-	var (
-		prevDesc fixed.Int26_6
-		carLine  int
-		y        int
-	)
-	for _, l := range e.lines {
-		y += (prevDesc + l.Ascent).Ceil()
-		prevDesc = l.Descent
-		if y+prevDesc.Ceil() >= pos.Y+e.scrollOff.Y {
-			break
-		}
-		carLine++
-	}
+	y := pos.Y + e.scrollOff.Y
+	carLine := sort.Search(len(e.lines), func(i int) bool {
+		return e.baselines[i]+e.lines[i].Descent.Ceil() >= y
+	})
 	x := fixed.I(pos.X + e.scrollOff.X)
 	e.caret.start = e.movePosToLine(e.caret.start, x, carLine)
 	e.caret.start.xoff = 0
 }
 
+// layoutText lays out the text. Only the paragraphs changed since the
+// previous layout are shaped, unless the layout parameters changed.
 func (e *Editor) layoutText(s text.Shaper) ([]text.Line, layout.Dimensions) {
-	e.rr.Reset()
-	var r io.Reader = &e.rr
-	if e.Mask != 0 {
-		e.maskReader.Reset(&e.rr, e.Mask)
-		r = &e.maskReader
-	}
-	var lines []text.Line
+	dirty := e.rr.takeDirty()
+	lines := e.lines
 	if s != nil {
-		lines, _ = s.Layout(e.font, e.textSize, e.maxWidth, r)
+		key := paragraphKey{
+			shaper:   s,
+			font:     e.font,
+			textSize: e.textSize,
+			maxWidth: e.maxWidth,
+			mask:     e.Mask,
+		}
+		if key != e.parasKey || len(e.paras) == 0 {
+			e.parasKey = key
+			e.paras = e.paras[:0]
+			lines = lines[:0]
+			e.lineLens = e.lineLens[:0]
+			n := e.rr.len()
+			dirty = dirtyRange{valid: true, end: n, delta: n}
+		}
+		if dirty.valid {
+			lines = e.layoutParagraphs(s, lines, dirty)
+		}
 	} else {
+		e.rr.Reset()
+		var r io.Reader = &e.rr
+		if e.Mask != 0 {
+			e.maskReader.Reset(&e.rr, e.Mask)
+			r = &e.maskReader
+		}
 		lines, _ = nullLayout(r)
+		e.lineLens = append(e.lineLens[:0], e.rr.len())
+		e.paras = e.paras[:0]
 	}
+	e.indexLines(lines)
 	dims := linesDimens(lines)
 	for i := 0; i < len(lines)-1; i++ {
 		// To avoid layout flickering while editing, assume a soft newline takes
@@ -753,6 +821,110 @@ func (e *Editor) layoutText(s text.Shaper) ([]text.Line, layout.Dimensions) {
 	return lines, dims
 }
 
+// layoutParagraphs replaces the layout of the paragraphs touched by
+// the dirty text.
+func (e *Editor) layoutParagraphs(s text.Shaper, lines []text.Line, dirty dirtyRange) []text.Line {
+	// Find the paragraphs [i; j) containing the dirty text, in the
+	// offsets of the previous layout.
+	i, start, line := 0, 0, 0
+	for i < len(e.paras)-1 && start+e.paras[i].len <= dirty.start {
+		start += e.paras[i].len
+		line += e.paras[i].lines
+		i++
+	}
+	j, end, nlines := i, start, 0
+	for j < len(e.paras) && end <= dirty.end-dirty.delta {
+		end += e.paras[j].len
+		nlines += e.paras[j].lines
+		j++
+	}
+	atEnd := j == len(e.paras)
+	e.newParas = e.newParas[:0]
+	e.newLines = e.newLines[:0]
+	e.newLens = e.newLens[:0]
+	e.paraText = e.rr.appendText(e.paraText[:0], start, end+dirty.delta)
+	txt := e.paraText
+	for {
+		n := bytes.IndexByte(txt, '\n') + 1
+		if n == 0 {
+			break
+		}
+		e.layoutParagraph(s, txt[:n])
+		txt = txt[n:]
+	}
+	if atEnd {
+		// The last paragraph has no newline and may be empty.
+		e.layoutParagraph(s, txt)
+	}
+	// Replace the old paragraphs with the new.
+	if len(e.newParas) == j-i {
+		copy(e.paras[i:], e.newParas)
+	} else {
+		e.newParas = append(e.newParas, e.paras[j:]...)
+		e.paras = append(e.paras[:i], e.newParas...)
+	}
+	if len(e.newLines) == nlines {
+		copy(lines[line:], e.newLines)
+		copy(e.lineLens[line:], e.newLens)
+	} else {
+		e.newLines = append(e.newLines, lines[line+nlines:]...)
+		lines = append(lines[:line], e.newLines...)
+		e.newLens = append(e.newLens, e.lineLens[line+nlines:]...)
+		e.lineLens = append(e.lineLens[:line], e.newLens...)
+	}
+	return lines
+}
+
+// layoutParagraph lays out a paragraph and appends the result to
+// the new paragraphs.
+func (e *Editor) layoutParagraph(s text.Shaper, txt []byte) {
+	plen := len(txt)
+	e.paraReader.Reset(txt)
+	var r io.Reader = &e.paraReader
+	if e.Mask != 0 {
+		e.maskReader.Reset(&e.paraReader, e.Mask)
+		r = &e.maskReader
+	}
+	lines, _ := s.Layout(e.font, e.textSize, e.maxWidth, r)
+	// The text after a trailing newline belongs to the next paragraph.
+	if n := len(lines); n > 1 && len(txt) > 0 && txt[len(txt)-1] == '\n' && len(lines[n-1].Layout.Advances) == 0 {
+		lines = lines[:n-1]
+	}
+	for i, l := range lines {
+		n := 0
+		if i == len(lines)-1 {
+			// Assign any remaining text to the last line.
+			n = len(txt)
+		} else {
+			for range l.Layout.Advances {
+				_, s := utf8.DecodeRune(txt[n:])
+				n += s
+			}
+		}
+		txt = txt[n:]
+		e.newLens = append(e.newLens, n)
+	}
+	e.newLines = append(e.newLines, lines...)
+	e.newParas = append(e.newParas, paragraph{len: plen, lines: len(lines)})
+}
+
+// indexLines computes the text offset and baseline of every line.
+func (e *Editor) indexLines(lines []text.Line) {
+	e.lineStarts = e.lineStarts[:0]
+	e.baselines = e.baselines[:0]
+	var (
+		prevDesc fixed.Int26_6
+		ofs, y   int
+	)
+	for i, l := range lines {
+		y += (prevDesc + l.Ascent).Ceil()
+		prevDesc = l.Descent
+		e.lineStarts = append(e.lineStarts, ofs)
+		e.baselines = append(e.baselines, y)
+		ofs += e.lineLens[i]
+	}
+}
+
 // CaretPos returns the line & column numbers of the caret.
 func (e *Editor) CaretPos() (line, col int) {
 	e.makeValid()
@@ -775,53 +947,37 @@ func (e *Editor) offsetToScreenPos2(o1, o2 int) (combinedPos, combinedPos) {
 
 // offsetToScreenPos takes an offset into the editor text (e.g.
 // e.caret.end.ofs) and returns a combinedPos that corresponds to its current
-// screen position, as well as an iterator that lets you get the combinedPos
-// of a later offset. The offsets given to offsetToScreenPos and to the
-// returned iterator must be sorted, lowest first, and they must be valid (0
-// <= offset <= e.Len()).
-//
-// This function is written this way to take advantage of previous work done
-// for offsets after the first. Otherwise you have to start from the top each
-// time.
+// screen position, as well as a function for finding the combinedPos of other
+// offsets. The offsets must be valid (0 <= offset <= e.Len()).
 func (e *Editor) offsetToScreenPos(offset int) (combinedPos, func(int) combinedPos) {
-	var col, line, idx int
-	var x fixed.Int26_6
+	return e.offsetPos(offset), e.offsetPos
+}
 
+// offsetPos returns the combinedPos of an offset. The line is found by
+// a binary search of the line offsets.
+func (e *Editor) offsetPos(offset int) combinedPos {
+	// Find the last line starting at or before offset.
+	line := sort.SearchInts(e.lineStarts, offset+1) - 1
+	if line < 0 {
+		line = 0
+	}
 	l := e.lines[line]
-	y := l.Ascent.Ceil()
-	prevDesc := l.Descent
-
-	iter := func(offset int) combinedPos {
-	LOOP:
-		for {
-			for ; col < len(l.Layout.Advances); col++ {
-				if idx >= offset {
-					break LOOP
-				}
-
-				x += l.Layout.Advances[col]
-				_, s := e.rr.runeAt(idx)
-				idx += s
-			}
-			if lastLine := line == len(e.lines)-1; lastLine || idx > offset {
-				break LOOP
-			}
-
-			line++
-			x = 0
-			col = 0
-			l = e.lines[line]
-			y += (prevDesc + l.Ascent).Ceil()
-			prevDesc = l.Descent
-		}
-		return combinedPos{
-			lineCol: screenPos{Y: line, X: col},
-			x:       x + align(e.Alignment, e.lines[line].Width, e.viewSize.X),
-			y:       y,
-			ofs:     offset,
-		}
+	idx := e.lineStarts[line]
+	var (
+		col int
+		x   fixed.Int26_6
+	)
+	for ; col < len(l.Layout.Advances) && idx < offset; col++ {
+		x += l.Layout.Advances[col]
+		_, s := e.rr.runeAt(idx)
+		idx += s
+	}
+	return combinedPos{
+		lineCol: screenPos{Y: line, X: col},
+		x:       x + align(e.Alignment, l.Width, e.viewSize.X),
+		y:       e.baselines[line],
+		ofs:     offset,
 	}
-	return iter(offset), iter
 }
 
 func (e *Editor) invalidate() {
@@ -911,30 +1067,10 @@ func (e *Editor) movePosToLine(pos combinedPos, x fixed.Int26_6, line int) combi
 		line = len(e.lines) - 1
 	}
 
-	prevDesc := e.lines[line].Descent
-	for pos.lineCol.Y < line {
-		pos = e.movePosToEnd(pos)
-		l := e.lines[pos.lineCol.Y]
-		_, s := e.rr.runeAt(pos.ofs)
-		pos.ofs += s
-		pos.y += (prevDesc + l.Ascent).Ceil()
-		pos.lineCol.X = 0
-		prevDesc = l.Descent
-		pos.lineCol.Y++
-	}
-	for pos.lineCol.Y > line {
-		pos = e.movePosToStart(pos)
-		l := e.lines[pos.lineCol.Y]
-		_, s := e.rr.runeBefore(pos.ofs)
-		pos.ofs -= s
-		pos.y -= (prevDesc + l.Ascent).Ceil()
-		prevDesc = l.Descent
-		pos.lineCol.Y--
-		l = e.lines[pos.lineCol.Y]
-		pos.lineCol.X = len(l.Layout.Advances) - 1
-	}
-
-	pos = e.movePosToStart(pos)
+	// Move to the start of the line.
+	pos.ofs = e.lineStarts[line]
+	pos.y = e.baselines[line]
+	pos.lineCol = screenPos{Y: line}
 	l := e.lines[line]
 	pos.x = align(e.Alignment, l.Width, e.viewSize.X)
 	// Only move past the end of the last line
@@ -1210,16 +1346,9 @@ func (e *Editor) SetCaret(start, end int) {
 }
 
 func (e *Editor) makeValidCaret(positions ...*combinedPos) {
-	// Jump through some hoops to order the offsets given to offsetToScreenPos,
-	// but still be able to update them correctly with the results thereof.
 	positions = append(positions, &e.caret.start, &e.caret.end)
-	sort.Slice(positions, func(i, j int) bool {
-		return positions[i].ofs < positions[j].ofs
-	})
-	var iter func(offset int) combinedPos
-	*positions[0], iter = e.offsetToScreenPos(positions[0].ofs)
-	for _, cp := range positions[1:] {
-		*cp = iter(cp.ofs)
+	for _, cp := range positions {
+		*cp = e.offsetPos(cp.ofs)
 	}
 }
 
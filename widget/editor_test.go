@@ -13,6 +13,7 @@ import (
 	"testing"
 	"testing/quick"
 	"unicode"
+	"unicode/utf8"
 
 	"gioui.org/f32"
 	"gioui.org/font/gofont"
@@ -199,6 +200,37 @@ func TestEditorCaretConsistency(t *testing.T) {
 	}
 }
 
+func TestEditorIncrementalLayout(t *testing.T) {
+	gtx := layout.Context{
+		Ops:         new(op.Ops),
+		Constraints: layout.Exact(image.Pt(100, 100)),
+	}
+	cache := text.NewCache(gofont.Collection())
+	fontSize := unit.Px(10)
+	font := text.Font{}
+	e := new(Editor)
+	e.Layout(gtx, cache, font, fontSize)
+	rnd := rand.New(rand.NewSource(1))
+	inserts := []string{"a", "bc ", "æøå", "\n", "long words wrap\n", "\n\n"}
+	for i := 0; i < 200; i++ {
+		ofs := rnd.Intn(e.Len() + 1)
+		for txt := e.Text(); ofs < len(txt) && !utf8.RuneStart(txt[ofs]); ofs++ {
+		}
+		e.SetCaret(ofs, ofs)
+		if rnd.Intn(3) == 0 {
+			e.Delete(rnd.Intn(7) - 3)
+		} else {
+			e.Insert(inserts[rnd.Intn(len(inserts))])
+		}
+		e.Layout(gtx, cache, font, fontSize)
+		// The layout must match a layout of the entire text.
+		want, _ := cache.Layout(font, fixed.I(gtx.Px(fontSize)), gtx.Constraints.Max.X, strings.NewReader(e.Text()))
+		if !reflect.DeepEqual(e.lines, want) {
+			t.Fatalf("layout of %q doesn't match the layout of the entire text", e.Text())
+		}
+	}
+}
+
 func TestEditorMoveWord(t *testing.T) {
 	type Test struct {
 		Text  string